@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * aes_ce_glue.c - AES in CBC and CTR modes using ARMv8 Crypto Extensions
+ *
+ * The Crypto Extensions are optional, so check ID_AA64ISAR0_EL1 and fall
+ * back to the generic code when the AES instructions are missing. The key
+ * schedule is the one produced by aes_expand_key().
+ */
+
+#include <linux/string.h>
+#include <linux/types.h>
+#include <uboot_aes.h>
+#include <asm/system.h>
+
+extern void aes_ce_invert_key(u8 *dk, const u8 *ek, u32 rounds);
+extern void aes_ce_cbc_encrypt(u8 *dst, const u8 *src, const u8 *rk,
+			       u32 rounds, u32 blocks, const u8 *iv);
+extern void aes_ce_cbc_decrypt(u8 *dst, const u8 *src, const u8 *rk,
+			       u32 rounds, u32 blocks, const u8 *iv);
+extern void aes_ce_ctr_crypt(u8 *dst, const u8 *src, const u8 *rk,
+			     u32 rounds, u32 blocks, u8 *ctr);
+
+static bool cpu_has_aes(void)
+{
+	uint64_t reg;
+
+	__asm__ volatile("mrs %0, ID_AA64ISAR0_EL1\n" : "=r" (reg));
+	return reg & ID_AA64ISAR0_EL1_AES;
+}
+
+static u32 aes_ce_rounds(u32 key_len)
+{
+	if (key_len == AES256_KEY_LENGTH)
+		return AES256_ROUNDS;
+	if (key_len == AES192_KEY_LENGTH)
+		return AES192_ROUNDS;
+
+	return AES128_ROUNDS;
+}
+
+void aes_cbc_encrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			    u32 num_aes_blocks)
+{
+	if (!num_aes_blocks)
+		return;
+
+	if (cpu_has_aes())
+		aes_ce_cbc_encrypt(dst, src, key_exp, aes_ce_rounds(key_len),
+				   num_aes_blocks, iv);
+	else
+		aes_cbc_encrypt_blocks_generic(key_len, key_exp, iv, src, dst,
+					       num_aes_blocks);
+}
+
+void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			    u32 num_aes_blocks)
+{
+	u8 dk[AES256_EXPAND_KEY_LENGTH];
+	u32 rounds = aes_ce_rounds(key_len);
+
+	if (!num_aes_blocks)
+		return;
+
+	if (cpu_has_aes()) {
+		/* aesd needs the equivalent inverse cipher key schedule */
+		aes_ce_invert_key(dk, key_exp, rounds);
+		aes_ce_cbc_decrypt(dst, src, dk, rounds, num_aes_blocks, iv);
+	} else {
+		aes_cbc_decrypt_blocks_generic(key_len, key_exp, iv, src, dst,
+					       num_aes_blocks);
+	}
+}
+
+void aes_ctr_crypt(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		   u32 num_bytes)
+{
+	u8 tail[AES_BLOCK_LENGTH];
+	u32 rounds = aes_ce_rounds(key_len);
+	u32 blocks = num_bytes / AES_BLOCK_LENGTH;
+	u32 len = num_bytes % AES_BLOCK_LENGTH;
+
+	if (!cpu_has_aes()) {
+		aes_ctr_crypt_generic(key_len, key_exp, iv, src, dst,
+				      num_bytes);
+		return;
+	}
+
+	if (blocks)
+		aes_ce_ctr_crypt(dst, src, key_exp, rounds, blocks, iv);
+	if (len) {
+		src += blocks * AES_BLOCK_LENGTH;
+		dst += blocks * AES_BLOCK_LENGTH;
+		memset(tail, '\0', sizeof(tail));
+		memcpy(tail, src, len);
+		aes_ce_ctr_crypt(tail, tail, key_exp, rounds, 1, iv);
+		memcpy(dst, tail, len);
+	}
+}
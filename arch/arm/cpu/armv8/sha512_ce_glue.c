@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * sha512_ce_glue.c - SHA-384/SHA-512 secure hash using ARMv8.2 Crypto
+ * Extensions
+ *
+ * The SHA-512 instructions are optional even on cores that implement the
+ * SHA-1/SHA-256 ones, so check ID_AA64ISAR0_EL1 and fall back to the
+ * generic code when they are missing.
+ */
+
+#include <common.h>
+#include <asm/system.h>
+#include <u-boot/sha512.h>
+
+extern void sha512_armv8_ce_process(uint64_t state[8], uint8_t const *src,
+				    uint32_t blocks);
+
+static bool cpu_has_sha512(void)
+{
+	uint64_t reg;
+
+	__asm__ volatile("mrs %0, ID_AA64ISAR0_EL1\n" : "=r" (reg));
+	return (reg & ID_AA64ISAR0_EL1_SHA2) >= ID_AA64ISAR0_EL1_SHA2_512;
+}
+
+void sha512_process(sha512_context *ctx, const unsigned char *data,
+		    unsigned int blocks)
+{
+	if (!blocks)
+		return;
+
+	if (cpu_has_sha512())
+		sha512_armv8_ce_process(ctx->state, data, blocks);
+	else
+		sha512_process_generic(ctx, data, blocks);
+}
@@ -85,6 +85,9 @@
 #define HCR_EL2_AMO_EL2		(1 <<  5) /* Route SErrors to EL2             */
 
 #define ID_AA64ISAR0_EL1_RNDR	(0xFUL << 60) /* RNDR random registers */
+#define ID_AA64ISAR0_EL1_AES	(0xFUL << 4)  /* AES instructions */
+#define ID_AA64ISAR0_EL1_SHA2	(0xFUL << 12) /* SHA2 instructions */
+#define ID_AA64ISAR0_EL1_SHA2_512	(0x2UL << 12) /* ... including SHA512 */
 /*
  * ID_AA64ISAR1_EL1 bits definitions
  */
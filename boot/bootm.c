@@ -251,13 +251,24 @@ static void boot_start_lmb(struct bootm_headers *images)
 	lmb_init_and_reserve_range(&images->lmb, (phys_addr_t)mem_start,
 				   mem_size, NULL);
 }
+
+/*
+ * The lmb is kept from one bootm subcommand to the next, so any regions it
+ * allocated are only freed when the next bootm starts
+ */
+static void boot_stop_lmb(struct bootm_headers *images)
+{
+	lmb_uninit(&images->lmb);
+}
 #else
 #define lmb_reserve(lmb, base, size)
 static inline void boot_start_lmb(struct bootm_headers *images) { }
+static inline void boot_stop_lmb(struct bootm_headers *images) { }
 #endif
 
 static int bootm_start(void)
 {
+	boot_stop_lmb(&images);
 	memset((void *)&images, 0, sizeof(images));
 	images.verify = env_get_yesno("verify");
 
@@ -991,7 +1002,7 @@ unmap_image:
 	return ret;
 }
 
-int bootm_run_states(struct bootm_info *bmi, int states)
+static int bootm_run_all(struct bootm_info *bmi, int states)
 {
 	struct bootm_headers *images = bmi->images;
 	boot_os_fn *boot_fn;
@@ -1110,8 +1121,11 @@ int bootm_run_states(struct bootm_info *bmi, int states)
 	}
 
 	/* Now run the OS! We hope this doesn't return */
-	if (!ret && (states & BOOTM_STATE_OS_GO))
+	if (!ret && (states & BOOTM_STATE_OS_GO)) {
+		if (CONFIG_IS_ENABLED(MALLOC_PROFILE_BOOTM))
+			malloc_prof_show();
 		ret = boot_selected_os(BOOTM_STATE_OS_GO, bmi, boot_fn);
+	}
 
 	/* Deal with any fallout */
 err:
@@ -1128,6 +1142,18 @@ err:
 	return ret;
 }
 
+int bootm_run_states(struct bootm_info *bmi, int states)
+{
+	int old_cat, ret;
+
+	/* charge what is allocated while loading the images to booting */
+	old_cat = malloc_prof_set_cat(LOGC_BOOT);
+	ret = bootm_run_all(bmi, states);
+	malloc_prof_set_cat(old_cat);
+
+	return ret;
+}
+
 int boot_run(struct bootm_info *bmi, const char *cmd, int extra_states)
 {
 	int states;
@@ -16,7 +16,47 @@ DECLARE_GLOBAL_DATA_PTR;
 #include <uboot_aes.h>
 #include <u-boot/aes.h>
 
+/*
+ * Names are matched by prefix, so the CTR variants must come before the
+ * plain (CBC) names
+ */
 struct cipher_algo cipher_algos[] = {
+	{
+		.name = "aes128-ctr",
+		.key_len = AES128_KEY_LENGTH,
+		.iv_len  = AES_BLOCK_LENGTH,
+		.unique_iv = true,
+#if IMAGE_ENABLE_ENCRYPT
+		.calculate_type = EVP_aes_128_ctr,
+#endif
+		.encrypt = image_aes_encrypt,
+		.decrypt = image_aes_ctr_decrypt,
+		.add_cipher_data = image_aes_add_cipher_data
+	},
+	{
+		.name = "aes192-ctr",
+		.key_len = AES192_KEY_LENGTH,
+		.iv_len  = AES_BLOCK_LENGTH,
+		.unique_iv = true,
+#if IMAGE_ENABLE_ENCRYPT
+		.calculate_type = EVP_aes_192_ctr,
+#endif
+		.encrypt = image_aes_encrypt,
+		.decrypt = image_aes_ctr_decrypt,
+		.add_cipher_data = image_aes_add_cipher_data
+	},
+	{
+		.name = "aes256-ctr",
+		.key_len = AES256_KEY_LENGTH,
+		.iv_len  = AES_BLOCK_LENGTH,
+		.unique_iv = true,
+#if IMAGE_ENABLE_ENCRYPT
+		.calculate_type = EVP_aes_256_ctr,
+#endif
+		.encrypt = image_aes_encrypt,
+		.decrypt = image_aes_ctr_decrypt,
+		.add_cipher_data = image_aes_add_cipher_data
+	},
 	{
 		.name = "aes128",
 		.key_len = AES128_KEY_LENGTH,
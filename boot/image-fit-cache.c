@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Cache of FIT verification results
+ *
+ * The same FIT is often verified several times during a boot: by SPL, then by
+ * bootm for each image it loads, and again when bootflow scans it. This keeps
+ * the results of recent checks in a bloblist record, so that they survive the
+ * move from SPL to U-Boot proper and each check is only done once.
+ *
+ * Only configuration signatures are cached. Each is recorded against a digest
+ * of the key node and the signed regions, which is cheap to compute since it
+ * only covers the FIT structure, so the RSA operation is skipped but any change
+ * to the key or the FIT is still noticed. Image hashes are not cached: a result
+ * could only be keyed on the data address and expected hash, which would let
+ * data changed in memory since the first check pass without being hashed.
+ *
+ * The record is kept small, since the bloblist set up before relocation is
+ * often only 1KB. Results with a value longer than FIT_CACHE_VALUE_LEN are
+ * not cached.
+ */
+
+#define LOG_CATEGORY LOGC_BOOT
+
+#include <common.h>
+#include <bloblist.h>
+#include <image.h>
+#include <log.h>
+#include <mapmem.h>
+
+/**
+ * struct fit_cache_entry - a successful verification
+ *
+ * @addr:	Address of the FIT
+ * @value_len:	Number of bytes used in @value
+ * @name:	Hash algorithm, nul-terminated
+ * @value:	Digest of the key node and signed regions
+ */
+struct fit_cache_entry {
+	u64 addr;
+	u8 value_len;
+	char name[FIT_CACHE_NAME_LEN];
+	u8 value[FIT_CACHE_VALUE_LEN];
+};
+
+/**
+ * struct fit_cache - contents of the BLOBLISTT_U_BOOT_FIT_CACHE record
+ *
+ * Entries are replaced in round-robin order once the table is full
+ *
+ * @count:	Number of valid entries
+ * @next:	Entry to replace next
+ * @entry:	Entries
+ */
+struct fit_cache {
+	u32 count;
+	u32 next;
+	struct fit_cache_entry entry[FIT_CACHE_ENTRIES];
+};
+
+static struct fit_cache *fit_cache_get(void)
+{
+	struct fit_cache *cache;
+
+	cache = bloblist_ensure(BLOBLISTT_U_BOOT_FIT_CACHE, sizeof(*cache));
+	if (!cache)
+		log_debug("Cannot set up cache\n");
+	else if (cache->count > FIT_CACHE_ENTRIES ||
+		 cache->next >= FIT_CACHE_ENTRIES)
+		memset(cache, '\0', sizeof(*cache));
+
+	return cache;
+}
+
+static struct fit_cache_entry *fit_cache_find(struct fit_cache *cache,
+					      const void *fit, const char *name,
+					      const u8 *value, int value_len)
+{
+	ulong base = map_to_sysmem(fit);
+	uint i;
+
+	for (i = 0; i < cache->count; i++) {
+		struct fit_cache_entry *ent = &cache->entry[i];
+
+		if (ent->addr == base && ent->value_len == value_len &&
+		    !strncmp(ent->name, name, sizeof(ent->name)) &&
+		    !memcmp(ent->value, value, value_len))
+			return ent;
+	}
+
+	return NULL;
+}
+
+/* Entries which would not fit are not cached, rather than truncated */
+static bool fit_cache_usable(const char *name, int value_len)
+{
+	return strlen(name) < FIT_CACHE_NAME_LEN &&
+		value_len > 0 && value_len <= FIT_CACHE_VALUE_LEN;
+}
+
+bool fit_cache_check(const void *fit, const char *name, const u8 *value,
+		     int value_len)
+{
+	struct fit_cache *cache;
+
+	if (!fit_cache_usable(name, value_len))
+		return false;
+	cache = bloblist_find(BLOBLISTT_U_BOOT_FIT_CACHE, sizeof(*cache));
+	if (!cache || cache->count > FIT_CACHE_ENTRIES)
+		return false;
+
+	return fit_cache_find(cache, fit, name, value, value_len);
+}
+
+void fit_cache_add(const void *fit, const char *name, const u8 *value,
+		   int value_len)
+{
+	struct fit_cache_entry *ent;
+	struct fit_cache *cache;
+
+	if (!fit_cache_usable(name, value_len))
+		return;
+	cache = fit_cache_get();
+	if (!cache || fit_cache_find(cache, fit, name, value, value_len))
+		return;
+
+	ent = &cache->entry[cache->next];
+	cache->next = (cache->next + 1) % FIT_CACHE_ENTRIES;
+	if (cache->count < FIT_CACHE_ENTRIES)
+		cache->count++;
+
+	memset(ent, '\0', sizeof(*ent));
+	ent->addr = map_to_sysmem(fit);
+	ent->value_len = value_len;
+	strcpy(ent->name, name);
+	memcpy(ent->value, value, value_len);
+}
+
+void fit_cache_clear(void)
+{
+	struct fit_cache *cache;
+
+	cache = bloblist_find(BLOBLISTT_U_BOOT_FIT_CACHE, sizeof(*cache));
+	if (cache)
+		memset(cache, '\0', sizeof(*cache));
+}
@@ -225,6 +225,72 @@ int fit_image_verify_required_sigs(const void *fit, int image_noffset,
 	return 0;
 }
 
+/* Largest public-key node whose results can be cached, in properties */
+#define FIT_KEY_MAX_PROPS	16
+
+/**
+ * fit_config_cache_digest() - Work out the cache value for a configuration
+ *
+ * This hashes the name and value of each property in the key node, then hashes
+ * that digest along with the signed regions of the FIT. A cached result is
+ * therefore only used with the same key contents, whatever the key is called.
+ *
+ * @info: Signature information, giving the checksum algorithm
+ * @key_blob: Blob containing the keys
+ * @keynode: Offset of the key node in @key_blob, or -1 if any key may be used,
+ *	in which case the result is not cached
+ * @region: Signed regions of the FIT
+ * @count: Number of regions in @region
+ * @digest: Returns the digest, which must hold FIT_CACHE_VALUE_LEN bytes
+ * Return: 0 if OK, -ENOENT if there is no key node, -E2BIG if the digest or
+ *	key node is too large to cache, other -ve value on error
+ */
+static int fit_config_cache_digest(struct image_sign_info *info,
+				   const void *key_blob, int keynode,
+				   struct image_region *region, int count,
+				   uint8_t *digest)
+{
+	struct image_region key_region[FIT_KEY_MAX_PROPS * 2];
+	uint8_t key_digest[FIT_CACHE_VALUE_LEN];
+	int len = info->checksum->checksum_len;
+	int prop, key_count = 0;
+
+	if (keynode < 0)
+		return -ENOENT;
+	if (len > FIT_CACHE_VALUE_LEN)
+		return -E2BIG;
+
+	fdt_for_each_property_offset(prop, key_blob, keynode) {
+		const char *name;
+		const void *val;
+		int val_len;
+
+		if (key_count == ARRAY_SIZE(key_region))
+			return -E2BIG;
+		val = fdt_getprop_by_offset(key_blob, prop, &name, &val_len);
+		if (!val)
+			return -EINVAL;
+		key_region[key_count].data = name;
+		key_region[key_count++].size = strlen(name) + 1;
+		key_region[key_count].data = val;
+		key_region[key_count++].size = val_len;
+	}
+	if (info->checksum->calculate(info->checksum->name, key_region,
+				      key_count, key_digest))
+		return -EIO;
+
+	struct image_region all[count + 1];
+
+	all[0].data = key_digest;
+	all[0].size = len;
+	memcpy(all + 1, region, count * sizeof(*region));
+	if (info->checksum->calculate(info->checksum->name, all, count + 1,
+				      digest))
+		return -EIO;
+
+	return 0;
+}
+
 /**
  * fit_config_check_sig() - Check the signature of a config
  *
@@ -267,12 +333,14 @@ static int fit_config_check_sig(const void *fit, int noffset, int conf_noffset,
 	};
 
 	const char *prop, *end, *name;
+	uint8_t digest[FIT_CACHE_VALUE_LEN];
 	struct image_sign_info info;
 	const uint32_t *strings;
 	const char *config_name;
 	uint8_t *fit_value;
 	int fit_value_len;
 	bool found_config;
+	bool digest_ok;
 	int max_regions;
 	int i, prop_len;
 	char path[200];
@@ -376,11 +444,29 @@ static int fit_config_check_sig(const void *fit, int noffset, int conf_noffset,
 	struct image_region region[count];
 
 	fit_region_make_list(fit, fdt_regions, count, region);
+
+	/*
+	 * Hashing the regions is cheap since they only cover the FIT
+	 * structure, so use the digest to find an earlier verification
+	 * with the same key
+	 */
+	digest_ok = CONFIG_IS_ENABLED(FIT_VERIFY_CACHE) &&
+		!fit_config_cache_digest(&info, key_blob, required_keynode,
+					 region, count, digest);
+	if (digest_ok && fit_cache_check(fit, info.checksum->name, digest,
+					 info.checksum->checksum_len)) {
+		puts("-cached");
+		return 0;
+	}
+
 	if (info.crypto->verify(&info, region, count, fit_value,
 				fit_value_len)) {
 		*err_msgp = "Verification failed";
 		return -1;
 	}
+	if (digest_ok)
+		fit_cache_add(fit, info.checksum->name, digest,
+			      info.checksum->checksum_len);
 
 	return 0;
 }
@@ -0,0 +1,412 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Single-pass verification and loading of FIT images
+ *
+ * Normally fit_image_load() hashes the image data, then decompresses or copies
+ * it to the load address, reading the data two times. Here the data is read
+ * in chunks small enough to stay in the cache, with each chunk hashed and then
+ * passed straight to the decompressor (or copied), so it is read only once.
+ */
+
+#define LOG_CATEGORY LOGC_BOOT
+
+#include <common.h>
+#include <gzip.h>
+#include <hash.h>
+#include <image.h>
+#include <log.h>
+#include <malloc.h>
+#include <linux/sizes.h>
+#include <linux/zstd.h>
+#include <asm/global_data.h>
+#include <u-boot/lz4.h>
+#include <u-boot/zlib.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Amount of data to hash and then decode at once, chosen to fit in L2 */
+#define FIT_STREAM_CHUNK	SZ_64K
+
+/* Maximum number of hash nodes handled in one pass */
+#define FIT_STREAM_MAX_HASHES	4
+
+/**
+ * struct fit_stream_hash - progress of one hash node
+ *
+ * @noffset:	Offset of the hash node in the FIT
+ * @algo:	Hash algorithm, or NULL if this node is not checked
+ * @ctx:	Context for progressive hashing
+ * @value:	Expected hash value
+ * @skip_msg:	Message to show if the node is not checked
+ */
+struct fit_stream_hash {
+	int noffset;
+	struct hash_algo *algo;
+	void *ctx;
+	const u8 *value;
+	const char *skip_msg;
+};
+
+/**
+ * struct fit_stream - state for loading one image
+ *
+ * @hash:	Hash nodes
+ * @num_hashes:	Number of entries in @hash
+ * @comp:	Compression type (IH_COMP_...)
+ * @dst:	Destination buffer
+ * @dst_size:	Size of @dst in bytes
+ * @out:	Number of bytes written to @dst
+ */
+struct fit_stream {
+	struct fit_stream_hash hash[FIT_STREAM_MAX_HASHES];
+	int num_hashes;
+	int comp;
+	void *dst;
+	ulong dst_size;
+	ulong out;
+	union {
+		struct ulz4_stream lz4;
+		struct zstd_stream zstd;
+		z_stream zlib;
+	};
+};
+
+/**
+ * fit_stream_key_policy() - Check which kinds of key are required
+ *
+ * @key_blob:	Devicetree holding the public keys
+ * @imagep:	Returns true if any key is required for images
+ * Return: true if any key is required
+ */
+static bool fit_stream_key_policy(const void *key_blob, bool *imagep)
+{
+	const char *required;
+	int sig_node, noffset;
+	bool any = false;
+
+	*imagep = false;
+	if (!FIT_IMAGE_ENABLE_VERIFY || !key_blob)
+		return false;
+	sig_node = fdt_subnode_offset(key_blob, 0, FIT_SIG_NODENAME);
+	if (sig_node < 0)
+		return false;
+	fdt_for_each_subnode(noffset, key_blob, sig_node) {
+		required = fdt_getprop(key_blob, noffset, FIT_KEY_REQUIRED,
+				       NULL);
+		if (!required)
+			continue;
+		any = true;
+		if (!strcmp(required, "image"))
+			*imagep = true;
+	}
+
+	return any;
+}
+
+static void fit_stream_drop_hashes(struct fit_stream *strm)
+{
+	u8 value[HASH_MAX_DIGEST_SIZE];
+	int i;
+
+	for (i = 0; i < strm->num_hashes; i++) {
+		struct fit_stream_hash *hash = &strm->hash[i];
+
+		if (hash->ctx)
+			hash->algo->hash_finish(hash->algo, hash->ctx, value,
+						sizeof(value));
+		hash->ctx = NULL;
+	}
+}
+
+/**
+ * fit_stream_setup_hashes() - Set up hashing for each hash node
+ *
+ * Return: 0 if OK, -ENOSYS if the image needs checks which cannot be done
+ * progressively, so that the caller should fall back to the normal path
+ */
+static int fit_stream_setup_hashes(struct fit_stream *strm, const void *fit,
+				   int image_noffset)
+{
+	int noffset, value_len, len;
+	struct fit_stream_hash *hash;
+	const int *ignore;
+	const char *name, *algo;
+	u8 *value;
+
+	fdt_for_each_subnode(noffset, fit, image_noffset) {
+		name = fit_get_name(fit, noffset, NULL);
+		if (!strncmp(name, FIT_SIG_NODENAME, strlen(FIT_SIG_NODENAME)))
+			goto nosys;
+		if (strncmp(name, FIT_HASH_NODENAME, strlen(FIT_HASH_NODENAME)))
+			continue;
+		if (strm->num_hashes == FIT_STREAM_MAX_HASHES)
+			goto nosys;
+
+		/* Leave any errors for the normal path to report */
+		if (fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    fit_image_hash_get_value(fit, noffset, &value, &value_len))
+			goto nosys;
+
+		hash = &strm->hash[strm->num_hashes++];
+		hash->noffset = noffset;
+		hash->value = value;
+		ignore = fdt_getprop(fit, noffset, FIT_IGNORE_PROP, &len);
+		if (ignore && len == sizeof(*ignore) && *ignore) {
+			hash->skip_msg = "-skipped";
+			continue;
+		}
+		if (hash_progressive_lookup_algo(algo, &hash->algo) ||
+		    hash->algo->digest_size != value_len ||
+		    value_len > HASH_MAX_DIGEST_SIZE ||
+		    hash->algo->hash_init(hash->algo, &hash->ctx)) {
+			hash->ctx = NULL;
+			goto nosys;
+		}
+	}
+	if (noffset == -FDT_ERR_TRUNCATED || noffset == -FDT_ERR_BADSTRUCTURE)
+		goto nosys;
+
+	return 0;
+
+nosys:
+	fit_stream_drop_hashes(strm);
+	return -ENOSYS;
+}
+
+static int fit_stream_check_hashes(struct fit_stream *strm, const void *fit,
+				   int image_noffset)
+{
+	u8 value[HASH_MAX_DIGEST_SIZE];
+	int i, ret = 0;
+
+	for (i = 0; i < strm->num_hashes; i++) {
+		struct fit_stream_hash *hash = &strm->hash[i];
+		const char *algo = NULL;
+
+		fit_image_hash_get_algo(fit, hash->noffset, &algo);
+		printf("%s", algo);
+		if (!hash->algo) {
+			printf("%s + ", hash->skip_msg);
+			continue;
+		}
+		if (!hash->ctx ||
+		    hash->algo->hash_finish(hash->algo, hash->ctx, value,
+					    sizeof(value)) ||
+		    memcmp(value, hash->value, hash->algo->digest_size)) {
+			hash->ctx = NULL;
+			printf(" error!\nBad hash value for '%s' hash node in '%s' image node\n",
+			       fit_get_name(fit, hash->noffset, NULL),
+			       fit_get_name(fit, image_noffset, NULL));
+			ret = -EACCES;
+			break;
+		}
+		hash->ctx = NULL;
+		puts("+ ");
+	}
+	fit_stream_drop_hashes(strm);
+
+	return ret;
+}
+
+static int fit_stream_start(struct fit_stream *strm, const void *src,
+			    ulong len, ulong *skipp)
+{
+	int ret;
+
+	*skipp = 0;
+	switch (strm->comp) {
+	case IH_COMP_NONE:
+		if (len > strm->dst_size)
+			return -ENOSPC;
+		return 0;
+	case IH_COMP_GZIP:
+		if (!CONFIG_IS_ENABLED(GZIP))
+			break;
+		ret = gzip_parse_header(src, len);
+		if (ret < 0)
+			return -EINVAL;
+		*skipp = ret;
+		memset(&strm->zlib, '\0', sizeof(strm->zlib));
+		strm->zlib.zalloc = gzalloc;
+		strm->zlib.zfree = gzfree;
+		strm->zlib.next_out = strm->dst;
+		strm->zlib.avail_out = strm->dst_size;
+		if (inflateInit2(&strm->zlib, -MAX_WBITS) != Z_OK)
+			return -ENOMEM;
+		return 0;
+	case IH_COMP_LZ4:
+		if (!CONFIG_IS_ENABLED(LZ4))
+			break;
+		ulz4_stream_init(&strm->lz4, strm->dst, strm->dst_size);
+		return 0;
+	case IH_COMP_ZSTD:
+		if (!CONFIG_IS_ENABLED(ZSTD))
+			break;
+		return zstd_stream_init(&strm->zstd, 0, true);
+	}
+
+	return -ENOSYS;
+}
+
+/**
+ * fit_stream_decode() - Pass the next part of the input to the decoder
+ *
+ * @strm:	Stream state
+ * @in:		Next input not yet consumed by the decoder
+ * @len:	Number of bytes available at @in, all of them hashed already
+ * @usedp:	Returns number of bytes consumed
+ * Return: 1 if the image is complete, 0 if more input is needed, -ve on error
+ */
+static int fit_stream_decode(struct fit_stream *strm, const void *in,
+			     ulong len, ulong *usedp)
+{
+	zstd_out_buffer zout;
+	zstd_in_buffer zin;
+	size_t used;
+	int ret;
+
+	*usedp = len;
+	switch (strm->comp) {
+	case IH_COMP_NONE:
+		if (strm->dst + strm->out != in)
+			memmove(strm->dst + strm->out, in, len);
+		strm->out += len;
+		return 0;
+	case IH_COMP_GZIP:
+		if (!CONFIG_IS_ENABLED(GZIP))
+			break;
+		strm->zlib.next_in = (void *)in;
+		strm->zlib.avail_in = len;
+		ret = inflate(&strm->zlib, Z_NO_FLUSH);
+		*usedp = len - strm->zlib.avail_in;
+		strm->out = strm->zlib.total_out;
+		if (ret == Z_STREAM_END)
+			return 1;
+		if (ret == Z_OK || (ret == Z_BUF_ERROR && !len))
+			return 0;
+		return ret == Z_BUF_ERROR ? -ENOSPC : -EINVAL;
+	case IH_COMP_LZ4:
+		if (!CONFIG_IS_ENABLED(LZ4))
+			break;
+		ret = ulz4_stream_feed(&strm->lz4, in, len, &used);
+		*usedp = used;
+		strm->out = strm->lz4.out;
+		return ret;
+	case IH_COMP_ZSTD:
+		if (!CONFIG_IS_ENABLED(ZSTD))
+			break;
+		zin.src = in;
+		zin.size = len;
+		zin.pos = 0;
+		zout.dst = strm->dst;
+		zout.size = strm->dst_size;
+		zout.pos = strm->out;
+		ret = zstd_stream_feed(&strm->zstd, &zin, &zout);
+		*usedp = zin.pos;
+		strm->out = zout.pos;
+		return ret;
+	}
+
+	return -ENOSYS;
+}
+
+static void fit_stream_end(struct fit_stream *strm)
+{
+	if (CONFIG_IS_ENABLED(GZIP) && strm->comp == IH_COMP_GZIP)
+		inflateEnd(&strm->zlib);
+	else if (CONFIG_IS_ENABLED(ZSTD) && strm->comp == IH_COMP_ZSTD)
+		zstd_stream_finish(&strm->zstd);
+}
+
+int fit_image_load_stream(const void *fit, int noffset, int comp,
+			  const void *src, ulong len, void *dst,
+			  ulong dst_size, ulong *out_lenp)
+{
+	struct fit_stream *strm;
+	const void *in, *hashed, *end;
+	bool keys, image_keys;
+	ulong skip, used;
+	int i, ret, done;
+
+	/*
+	 * Signatures over the image need all the data at once. If keys are
+	 * required then the FIT is a trusted one, so verify the data before
+	 * passing it to a decompressor. A plain copy is harmless either way.
+	 */
+	keys = fit_stream_key_policy(gd_fdt_blob(), &image_keys);
+	if (image_keys || (keys && comp != IH_COMP_NONE))
+		return -ENOSYS;
+
+	/* The output must not overwrite input which is not yet read */
+	if (comp == IH_COMP_NONE) {
+		if (dst > src && dst < src + len)
+			return -ENOSYS;
+	} else if (dst < src + len && src < dst + dst_size) {
+		return -ENOSYS;
+	}
+
+	strm = calloc(1, sizeof(*strm));
+	if (!strm)
+		return -ENOSYS;
+	strm->comp = comp;
+	strm->dst = dst;
+	strm->dst_size = dst_size;
+	ret = fit_stream_setup_hashes(strm, fit, noffset);
+	if (ret)
+		goto err;
+	/* Leave unsupported or bad headers for the normal path to report */
+	if (fit_stream_start(strm, src, len, &skip)) {
+		fit_stream_drop_hashes(strm);
+		ret = -ENOSYS;
+		goto err;
+	}
+
+	in = src + skip;
+	hashed = src;
+	end = src + len;
+	done = 0;
+	while (hashed < end) {
+		ulong chunk = min_t(ulong, end - hashed, FIT_STREAM_CHUNK);
+
+		for (i = 0; i < strm->num_hashes; i++) {
+			struct fit_stream_hash *hash = &strm->hash[i];
+
+			if (hash->ctx &&
+			    hash->algo->hash_update(hash->algo, hash->ctx,
+						    hashed, chunk,
+						    hashed + chunk == end))
+				hash->ctx = NULL;
+		}
+		hashed += chunk;
+
+		/*
+		 * Once the decoder finishes or fails, keep hashing to the end
+		 * so that a bad hash can still be told apart from bad data
+		 */
+		if (!done && hashed > in) {
+			done = fit_stream_decode(strm, in, hashed - in, &used);
+			in += used;
+		}
+	}
+	fit_stream_end(strm);
+
+	/* A bad hash is the more useful error to report */
+	ret = fit_stream_check_hashes(strm, fit, noffset);
+	if (!ret && done < 0)
+		ret = done;
+	else if (!ret && !done && comp != IH_COMP_NONE)
+		ret = -EINVAL;	/* truncated input */
+	if (ret) {
+		if (ret != -EACCES)
+			printf("Error loading image (err=%d)\n", ret);
+		goto err;
+	}
+	*out_lenp = strm->out;
+	free(strm);
+
+	return 0;
+
+err:
+	free(strm);
+	return ret;
+}
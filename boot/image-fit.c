@@ -1972,22 +1972,79 @@ int fit_get_data_conf_prop(const void *fit, const char *prop_name,
 	return fit_get_data_tail(fit, noffset, data, size);
 }
 
+static struct fit_load_stats fit_load_stats;
+
+const struct fit_load_stats *fit_get_load_stats(void)
+{
+	return &fit_load_stats;
+}
+
+static ulong fit_load_timer(void)
+{
+#ifdef USE_HOSTCC
+	return 0;
+#else
+	return timer_get_us();
+#endif
+}
+
+static int fit_image_check_data(const void *fit, int noffset)
+{
+	puts("   Verifying Hash Integrity ... ");
+	fit_load_stats.passes++;
+	if (!fit_image_verify(fit, noffset)) {
+		puts("Bad Data Hash\n");
+		return -EACCES;
+	}
+	puts("OK\n");
+
+	return 0;
+}
+
 static int fit_image_select(const void *fit, int rd_noffset, int verify)
 {
 	fit_image_print(fit, rd_noffset, "   ");
 
-	if (verify) {
-		puts("   Verifying Hash Integrity ... ");
-		if (!fit_image_verify(fit, rd_noffset)) {
-			puts("Bad Data Hash\n");
-			return -EACCES;
-		}
-		puts("OK\n");
-	}
+	if (verify)
+		return fit_image_check_data(fit, rd_noffset);
 
 	return 0;
 }
 
+/**
+ * fit_load_verify() - Check the hash of an image while loading it
+ *
+ * If this returns -ENOSYS, the hash has been checked but the image has not
+ * been loaded, so the caller must copy or decompress it as usual.
+ *
+ * Return: 0 if OK, -EACCES if the hash is bad, -ENOSYS if the image was not
+ *	loaded, other -ve value if decompression failed
+ */
+static int fit_load_verify(const void *fit, int noffset, int comp,
+			   const void *src, ulong len, void *dst,
+			   ulong dst_size, ulong *lenp)
+{
+	int ret;
+
+	puts("   Verifying Hash Integrity ... ");
+	ret = fit_image_load_stream(fit, noffset, comp, src, len, dst,
+				    dst_size, lenp);
+	if (ret == -EACCES) {
+		puts("Bad Data Hash\n");
+		return ret;
+	}
+	fit_load_stats.passes++;
+	if (ret == -ENOSYS && !fit_image_verify(fit, noffset)) {
+		puts("Bad Data Hash\n");
+		return -EACCES;
+	}
+	if (ret && ret != -ENOSYS)
+		return ret;
+	puts("OK\n");
+
+	return ret;
+}
+
 int fit_get_node_from_config(struct bootm_headers *images,
 			     const char *prop_name, ulong addr)
 {
@@ -2069,6 +2126,8 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 	ulong load, load_end, data, len;
 	uint8_t os, comp;
 	const char *prop_name;
+	bool verify_later;
+	ulong start;
 	int ret;
 
 	fit = map_sysmem(addr, 0);
@@ -2142,7 +2201,19 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 
 	printf("   Trying '%s' %s subimage\n", fit_uname, prop_name);
 
-	ret = fit_image_select(fit, noffset, images->verify);
+	/*
+	 * If possible, check the hash while copying or decompressing the data
+	 * below, so it is only read once. Encrypted and post-processed images
+	 * must be verified before they are changed.
+	 */
+	verify_later = images->verify && !tools_build() &&
+		CONFIG_IS_ENABLED(FIT_SINGLE_PASS) &&
+		!IS_ENABLED(CONFIG_FIT_IMAGE_POST_PROCESS) &&
+		fdt_subnode_offset(fit, noffset, FIT_CIPHER_NODENAME) < 0;
+
+	memset(&fit_load_stats, '\0', sizeof(fit_load_stats));
+	start = fit_load_timer();
+	ret = fit_image_select(fit, noffset, images->verify && !verify_later);
 	if (ret) {
 		bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
 		return ret;
@@ -2274,6 +2345,21 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 		} else {
 			loadbuf = map_sysmem(load, max_decomp_len);
 		}
+		if (verify_later) {
+			ret = fit_load_verify(fit, noffset, comp, buf, len,
+					      loadbuf, max_decomp_len, &len);
+			if (ret == -EACCES) {
+				bootstage_error(bootstage_id +
+						BOOTSTAGE_SUB_HASH);
+				return ret;
+			} else if (!ret) {
+				goto loaded;
+			} else if (ret != -ENOSYS) {
+				printf("Error decompressing %s\n", prop_name);
+				return -ENOEXEC;
+			}
+		}
+		fit_load_stats.passes++;
 		if (image_decomp(comp, load, data, image_type,
 				loadbuf, buf, len, max_decomp_len, &load_end)) {
 			printf("Error decompressing %s\n", prop_name);
@@ -2283,8 +2369,31 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 		len = load_end - load;
 	} else if (load != data) {
 		loadbuf = map_sysmem(load, len);
+		if (verify_later) {
+			ret = fit_load_verify(fit, noffset, IH_COMP_NONE, buf,
+					      len, loadbuf, len, &len);
+			if (ret == -EACCES) {
+				bootstage_error(bootstage_id +
+						BOOTSTAGE_SUB_HASH);
+				return ret;
+			} else if (!ret) {
+				goto loaded;
+			} else if (ret != -ENOSYS) {
+				return -ENOEXEC;
+			}
+		}
+		fit_load_stats.passes++;
 		memcpy(loadbuf, buf, len);
+	} else if (verify_later) {
+		/* Nothing to move, so just check the hash */
+		ret = fit_image_check_data(fit, noffset);
+		if (ret) {
+			bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
+			return ret;
+		}
 	}
+loaded:
+	fit_load_stats.time_us = fit_load_timer() - start;
 
 	if (image_type == IH_TYPE_RAMDISK && comp != IH_COMP_NONE)
 		puts("WARNING: 'compression' nodes for ramdisks are deprecated,"
@@ -10,6 +10,14 @@
 static int do_bootstage_report(struct cmd_tbl *cmdtp, int flag, int argc,
 			       char *const argv[])
 {
+	if (argc > 1) {
+		if (!IS_ENABLED(CONFIG_BOOTSTAGE_INITCALLS) ||
+		    strcmp(argv[1], "--initcalls"))
+			return CMD_RET_USAGE;
+		bootstage_report_initcalls();
+
+		return 0;
+	}
 	bootstage_report();
 
 	return 0;
@@ -90,7 +98,7 @@ static int do_boostage(struct cmd_tbl *cmdtp, int flag, int argc,
 U_BOOT_CMD(bootstage, 4, 1, do_boostage,
 	"Boot stage command",
 	" - check boot progress and timing\n"
-	"report                      - Print a report\n"
+	"report [--initcalls]        - Print a report, or the initcall timings\n"
 	"stash [<start> [<size>]]    - Stash data into memory\n"
 	"unstash [<start> [<size>]]  - Unstash data from memory"
 );
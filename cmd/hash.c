@@ -12,7 +12,9 @@
 #include <common.h>
 #include <command.h>
 #include <hash.h>
+#include <malloc.h>
 #include <linux/ctype.h>
+#include <linux/sizes.h>
 
 #if IS_ENABLED(CONFIG_HASH_VERIFY)
 #define HARGS 6
@@ -20,12 +22,78 @@
 #define HARGS 5
 #endif
 
+#if IS_ENABLED(CONFIG_CMD_HASH_BENCH)
+#define HASH_MAXARGS	6
+#else
+#define HASH_MAXARGS	HARGS
+#endif
+
+/* Time spent on each measurement by 'hash bench' */
+#define HASH_BENCH_MIN_US	500000
+
+static int do_hash_bench(int argc, char *const argv[])
+{
+	ulong size = SZ_1M, chunk = 0, align = 0;
+	struct hash_algo *algo = NULL;
+	const char *name = NULL;
+	ulong kbps;
+	void *mem;
+	int ret;
+
+	if (argc > 1 && strcmp(argv[1], "all"))
+		name = argv[1];
+	if (argc > 2)
+		size = hextoul(argv[2], NULL);
+	if (argc > 3)
+		chunk = hextoul(argv[3], NULL);
+	if (argc > 4)
+		align = hextoul(argv[4], NULL);
+	if (!size)
+		return CMD_RET_USAGE;
+
+	if (name && hash_lookup_algo(name, &algo)) {
+		printf("Unknown hash algorithm '%s'\n", name);
+		return CMD_RET_FAILURE;
+	}
+
+	mem = malloc(size + align);
+	if (!mem) {
+		printf("Cannot allocate %#lx bytes\n", size + align);
+		return CMD_RET_FAILURE;
+	}
+	memset(mem, 0xa5, size + align);
+
+	printf("%-12s %10s %8s %5s %10s\n", "algorithm", "size", "chunk",
+	       "align", "MB/s");
+	if (!algo)
+		algo = hash_next_algo(NULL);
+	for (; algo; algo = name ? NULL : hash_next_algo(algo)) {
+		ret = hash_bench(algo, mem + align, size, chunk,
+				 HASH_BENCH_MIN_US, &kbps);
+		printf("%-12s %10lu %8lu %5lu ", algo->name, size, chunk,
+		       align);
+		if (ret == -ENOSYS)
+			printf("%10s\n", "-");
+		else if (ret)
+			printf("%10s\n", "error");
+		else
+			printf("%6lu.%03lu\n", kbps / 1000, kbps % 1000);
+	}
+	free(mem);
+
+	return 0;
+}
+
 static int do_hash(struct cmd_tbl *cmdtp, int flag, int argc,
 		   char *const argv[])
 {
 	char *s;
 	int flags = HASH_FLAG_ENV;
 
+	if (IS_ENABLED(CONFIG_CMD_HASH_BENCH) && argc > 1 &&
+	    !strcmp(argv[1], "bench"))
+		return do_hash_bench(argc - 1, argv + 1);
+
 	if (argc < (HARGS - 1))
 		return CMD_RET_USAGE;
 
@@ -45,7 +113,7 @@ static int do_hash(struct cmd_tbl *cmdtp, int flag, int argc,
 }
 
 U_BOOT_CMD(
-	hash,	HARGS,	1,	do_hash,
+	hash,	HASH_MAXARGS,	1,	do_hash,
 	"compute hash message digest",
 	"algorithm address count [[*]hash_dest]\n"
 		"    - compute message digest [save to env var / *address]"
@@ -54,4 +122,10 @@ U_BOOT_CMD(
 		"    - verify message digest of memory area to immediate value, \n"
 		"      env var or *address"
 #endif
+#if IS_ENABLED(CONFIG_CMD_HASH_BENCH)
+	"\nhash bench [algorithm|all [size [chunk [align]]]]\n"
+		"    - measure throughput over size bytes (default 1MiB) at\n"
+		"      the given alignment, hashing chunk bytes per update\n"
+		"      (default 0: hash the whole buffer in one call)"
+#endif
 );
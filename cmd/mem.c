@@ -22,6 +22,7 @@
 #endif
 #include <hash.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <rand.h>
 #include <watchdog.h>
@@ -1400,12 +1401,37 @@ U_BOOT_CMD(
 #endif
 
 #ifdef CONFIG_CMD_MEMINFO
+static void show_slab(void)
+{
+	struct malloc_slab_stats stats;
+	uint cls;
+
+	printf("\n%5s %8s %8s %10s %10s %6s %6s\n", "Slab", "In use",
+	       "Free", "Allocs", "Frees", "Pages", "Peak");
+	for (cls = 0; !malloc_slab_get_stats(cls, &stats); cls++)
+		printf("%5u %8lu %8lu %10lu %10lu %6u %6u\n", stats.size,
+		       stats.inuse, stats.objs - stats.inuse, stats.allocs,
+		       stats.frees, stats.pages, stats.max_pages);
+}
+
 static int do_mem_info(struct cmd_tbl *cmdtp, int flag, int argc,
 		       char *const argv[])
 {
+	if (argc > 1) {
+		if (!IS_ENABLED(CONFIG_MALLOC_PROFILE) ||
+		    strcmp(argv[1], "alloc"))
+			return CMD_RET_USAGE;
+		malloc_prof_show();
+
+		return 0;
+	}
+
 	puts("DRAM:  ");
 	print_size(gd->ram_size, "\n");
 
+	if (IS_ENABLED(CONFIG_SYS_MALLOC_SLAB))
+		show_slab();
+
 	return 0;
 }
 #endif
@@ -1457,7 +1483,11 @@ U_BOOT_CMD(
 U_BOOT_CMD(
 	meminfo,	3,	1,	do_mem_info,
 	"display memory information",
+#ifdef CONFIG_MALLOC_PROFILE
+	"\nmeminfo alloc - show who holds malloc() memory"
+#else
 	""
+#endif
 );
 #endif
 
@@ -20,7 +20,7 @@
 static int ubifs_initialized;
 static int ubifs_mounted;
 
-int cmd_ubifs_mount(char *vol_name)
+static int ubifs_mount_opts(char *vol_name, char *options)
 {
 	int ret;
 
@@ -31,7 +31,7 @@ int cmd_ubifs_mount(char *vol_name)
 		ubifs_initialized = 1;
 	}
 
-	ret = uboot_ubifs_mount(vol_name);
+	ret = uboot_ubifs_mount(vol_name, options);
 	if (ret)
 		return CMD_RET_FAILURE;
 
@@ -40,17 +40,18 @@ int cmd_ubifs_mount(char *vol_name)
 	return ret;
 }
 
+int cmd_ubifs_mount(char *vol_name)
+{
+	return ubifs_mount_opts(vol_name, NULL);
+}
+
 static int do_ubifs_mount(struct cmd_tbl *cmdtp, int flag, int argc,
 			  char *const argv[])
 {
-	char *vol_name;
-
-	if (argc != 2)
+	if (argc != 2 && argc != 3)
 		return CMD_RET_USAGE;
 
-	vol_name = argv[1];
-
-	return cmd_ubifs_mount(vol_name);
+	return ubifs_mount_opts(argv[1], argc == 3 ? argv[2] : NULL);
 }
 
 int ubifs_is_mounted(void)
@@ -153,10 +154,11 @@ static int do_ubifs_load(struct cmd_tbl *cmdtp, int flag, int argc,
 }
 
 U_BOOT_CMD(
-	ubifsmount, 2, 0, do_ubifs_mount,
+	ubifsmount, 3, 0, do_ubifs_mount,
 	"mount UBIFS volume",
-	"<volume-name>\n"
-	"    - mount 'volume-name' volume"
+	"<volume-name> [options]\n"
+	"    - mount 'volume-name' volume\n"
+	"      options: comma-separated list of bulk_read, no_bulk_read"
 );
 
 U_BOOT_CMD(
@@ -62,6 +62,7 @@ static struct tag_name {
 	{ BLOBLISTT_U_BOOT_SPL_HANDOFF, "SPL hand-off" },
 	{ BLOBLISTT_VBE, "VBE" },
 	{ BLOBLISTT_U_BOOT_VIDEO, "SPL video handoff" },
+	{ BLOBLISTT_U_BOOT_FIT_CACHE, "FIT verification cache" },
 
 	/* BLOBLISTT_VENDOR_AREA */
 };
@@ -49,6 +49,7 @@
 #include <dm/root.h>
 #include <linux/errno.h>
 #include <linux/log2.h>
+#include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -471,9 +472,120 @@ static int reserve_trace(void)
 	return 0;
 }
 
+#ifdef CONFIG_RELOC_IN_PLACE
+/* Stack still used below the current stack pointer before relocation */
+#define RELOC_IN_PLACE_SP_MARGIN	SZ_16K
+
+/*
+ * Check whether [bottom, top) overlaps memory still used before relocation:
+ * the stack, the global data and the early malloc() area. Everything from
+ * below the current stack pointer up to the end of these is treated as used,
+ * since the start of the stack is not known.
+ */
+static bool reloc_in_place_overlaps(ulong bottom, ulong top)
+{
+	ulong sp = (ulong)&bottom;
+	ulong lo, hi;
+
+	lo = min(sp - RELOC_IN_PLACE_SP_MARGIN, (ulong)gd);
+	hi = max(sp, (ulong)gd + sizeof(*gd));
+#if CONFIG_VAL(SYS_MALLOC_F_LEN)
+	lo = min(lo, gd->malloc_base);
+	hi = max(hi, gd->malloc_base + CONFIG_VAL(SYS_MALLOC_F_LEN));
+#endif
+
+	return bottom < hi && lo < top;
+}
+
+/*
+ * Work out the lowest address reserved below U-Boot at @start, for the areas
+ * which reserve_malloc() to reserve_stacks() set up, followed by the stack.
+ * This must match those functions. Return 0 if it does not fit in RAM.
+ */
+static ulong reloc_in_place_bottom(ulong start, bool fdt_in_place)
+{
+	ulong sp = start;
+
+	sp = ALIGN_DOWN(sp - TOTAL_MALLOC_LEN, 16);
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	sp = ALIGN(sp, MMU_SECTION_SIZE) - MMU_SECTION_SIZE;
+	sp -= ALIGN(CONFIG_SYS_NONCACHED_MEMORY, MMU_SECTION_SIZE);
+#endif
+	if (!gd->bd)
+		sp = ALIGN_DOWN(sp - sizeof(struct bd_info), 16);
+	sp = ALIGN_DOWN(sp - sizeof(gd_t), 16);
+	if (!IS_ENABLED(CONFIG_OF_EMBED) && gd->fdt_blob && !fdt_in_place)
+		sp = ALIGN_DOWN(sp - ALIGN(fdt_totalsize(gd->fdt_blob), 32),
+				16);
+#ifdef CONFIG_BOOTSTAGE
+	sp = ALIGN_DOWN(sp - bootstage_get_size(), 16);
+#endif
+#ifdef CONFIG_BLOBLIST
+	sp = ALIGN_DOWN(sp - CONFIG_BLOBLIST_SIZE_RELOC, 0x1000);
+#endif
+	/* reserve_stacks(), allowing for arch_reserve_stacks() */
+	sp = ALIGN_DOWN(sp - 16, 16) - 128;
+
+	if (sp > start || sp - gd->ram_base < CONFIG_STACK_SIZE)
+		return 0;
+
+	return sp - CONFIG_STACK_SIZE;
+}
+#endif
+
+/*
+ * A position-independent U-Boot which is already running in DRAM, not far
+ * below the areas reserved so far, can be reserved where it is. Then
+ * relocate_code() finds it already at gd->relocaddr and does nothing. The
+ * devicetree can stay put as well, if it is past the BSS and below the
+ * reserved areas.
+ *
+ * Everything else is reserved below U-Boot, so this is only done if that does
+ * not overlap memory which is still in use before relocation. Otherwise
+ * setup_reloc() and reloc_fdt() would overwrite it.
+ */
+static bool reserve_uboot_in_place(void)
+{
+#ifdef CONFIG_RELOC_IN_PLACE
+	ulong start = (ulong)__image_copy_start;
+	ulong end = start + gd->mon_len;
+	ulong top = gd->relocaddr;
+	bool fdt_in_place;
+	ulong bottom;
+	ulong fdt;
+
+	if ((start & (4096 - 1)) || start < gd->ram_base || end > top ||
+	    top - end > CONFIG_RELOC_IN_PLACE_MAX_GAP)
+		return false;
+
+	fdt = (ulong)gd->fdt_blob;
+	fdt_in_place = !IS_ENABLED(CONFIG_OF_EMBED) && gd->fdt_blob &&
+		fdt >= end && fdt + fdt_totalsize(gd->fdt_blob) <= top;
+	bottom = reloc_in_place_bottom(start, fdt_in_place);
+	if (!bottom || reloc_in_place_overlaps(bottom, start)) {
+		debug("No room below U-Boot at %08lx, relocating\n", start);
+		return false;
+	}
+
+	gd->relocaddr = start;
+	debug("Reserving %ldk for U-Boot in place at: %08lx\n",
+	      gd->mon_len >> 10, gd->relocaddr);
+
+	if (fdt_in_place) {
+		gd->fdt_size = ALIGN(fdt_totalsize(gd->fdt_blob), 32);
+		gd->new_fdt = (void *)gd->fdt_blob;
+		debug("Leaving FDT in place at: %08lx\n", fdt);
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 static int reserve_uboot(void)
 {
-	if (!(gd->flags & GD_FLG_SKIP_RELOC)) {
+	if (!(gd->flags & GD_FLG_SKIP_RELOC) && !reserve_uboot_in_place()) {
 		/*
 		 * reserve memory for U-Boot code, data & bss
 		 * round down to next 4 kB limit
@@ -571,7 +683,7 @@ static int reserve_fdt(void)
 		 * then we must relocate it. If it is embedded in the data
 		 * section, then it will be relocated with other data.
 		 */
-		if (gd->fdt_blob) {
+		if (gd->fdt_blob && gd->new_fdt != gd->fdt_blob) {
 			gd->fdt_size = ALIGN(fdt_totalsize(gd->fdt_blob), 32);
 
 			gd->start_addr_sp = reserve_stack_aligned(gd->fdt_size);
@@ -615,6 +727,30 @@ static int reserve_stacks(void)
 	return arch_reserve_stacks();
 }
 
+#ifdef CONFIG_RELOC_IN_PLACE
+/*
+ * reserve_uboot_in_place() worked out in advance what reserve_malloc() to
+ * reserve_stacks() take below U-Boot. Make sure that this still holds before
+ * anything is copied there.
+ */
+static int check_reloc_in_place(void)
+{
+	ulong start = (ulong)__image_copy_start;
+	ulong bottom = gd->start_addr_sp - CONFIG_STACK_SIZE;
+
+	if ((gd->flags & GD_FLG_SKIP_RELOC) || gd->relocaddr != start)
+		return 0;
+	if (gd->start_addr_sp < gd->ram_base + CONFIG_STACK_SIZE ||
+	    reloc_in_place_overlaps(bottom, start)) {
+		log_err("Areas reserved below U-Boot at %08lx overlap memory in use\n",
+			start);
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+#endif
+
 static int reserve_bloblist(void)
 {
 #ifdef CONFIG_BLOBLIST
@@ -664,8 +800,12 @@ static int init_post(void)
 
 static int reloc_fdt(void)
 {
+	/* The time from here to board_init_r() is the cost of relocation */
+	if (IS_ENABLED(CONFIG_RELOC_IN_PLACE))
+		bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "relocate");
+
 	if (!IS_ENABLED(CONFIG_OF_EMBED)) {
-		if (gd->new_fdt) {
+		if (gd->new_fdt && gd->new_fdt != gd->fdt_blob) {
 			memcpy(gd->new_fdt, gd->fdt_blob,
 			       fdt_totalsize(gd->fdt_blob));
 			gd->fdt_blob = gd->new_fdt;
@@ -966,6 +1106,9 @@ static const init_fnc_t init_sequence_f[] = {
 	reserve_bloblist,
 	reserve_arch,
 	reserve_stacks,
+#ifdef CONFIG_RELOC_IN_PLACE
+	check_reloc_in_place,
+#endif
 	dram_init_banksize,
 	show_dram_config,
 	INIT_FUNC_WATCHDOG_RESET
@@ -144,6 +144,8 @@ static int initr_reloc_global_data(void)
 	 */
 	fixup_cpu();
 #endif
+	/* The flat-tree lookup cache is in the pre-relocation malloc() pool */
+	gd_set_of_cache(NULL);
 #ifdef CONFIG_SYS_RELOC_GD_ENV_ADDR
 	/*
 	 * Relocate the early env_addr pointer unless we know it is not inside
@@ -233,6 +235,8 @@ static int initr_dm(void)
 	/* Save the pre-reloc driver model and start a new one */
 	gd->dm_root_f = gd->dm_root;
 	gd->dm_root = NULL;
+	/* The driver index points into the pre-relocation image */
+	gd_set_dm_compat_index(NULL);
 #ifdef CONFIG_TIMER
 	gd->timer = NULL;
 #endif
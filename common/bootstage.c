@@ -14,6 +14,7 @@
 #include <common.h>
 #include <bootstage.h>
 #include <hang.h>
+#include <initcall.h>
 #include <log.h>
 #include <malloc.h>
 #include <sort.h>
@@ -26,6 +27,9 @@ DECLARE_GLOBAL_DATA_PTR;
 
 enum {
 	RECORD_COUNT = CONFIG_VAL(BOOTSTAGE_RECORD_COUNT),
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALLS)
+	INITCALL_COUNT = CONFIG_BOOTSTAGE_INITCALL_COUNT,
+#endif
 };
 
 struct bootstage_record {
@@ -36,10 +40,20 @@ struct bootstage_record {
 	enum bootstage_id id;
 };
 
+struct bootstage_initcall {
+	ulong addr;		/* unrelocated address, or INITCALL_EVENT() */
+	u32 time_us;
+	u32 reloc;		/* 0 for board_init_f(), 1 for board_init_r() */
+};
+
 struct bootstage_data {
 	uint rec_count;
 	uint next_id;
 	struct bootstage_record record[RECORD_COUNT];
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALLS)
+	uint initcall_count;	/* may be more than INITCALL_COUNT */
+	struct bootstage_initcall initcall[INITCALL_COUNT];
+#endif
 };
 
 enum {
@@ -218,6 +232,95 @@ uint32_t bootstage_accum(enum bootstage_id id)
 	return duration;
 }
 
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALLS)
+void bootstage_add_initcall(ulong addr, ulong time_us)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_initcall *rec;
+
+	if (!data)
+		return;
+	if (data->initcall_count < INITCALL_COUNT) {
+		rec = &data->initcall[data->initcall_count];
+		rec->addr = addr;
+		rec->time_us = time_us;
+		rec->reloc = !!(gd->flags & GD_FLG_RELOC);
+	}
+	data->initcall_count++;
+}
+
+static bool initcall_rec_is_event(const struct bootstage_initcall *rec)
+{
+	return (rec->addr & INITCALL_IS_EVENT) == INITCALL_IS_EVENT;
+}
+
+static int h_compare_initcall(const void *p1, const void *p2)
+{
+	const struct bootstage_initcall *const *rec1 = p1, *const *rec2 = p2;
+
+	if ((*rec1)->time_us != (*rec2)->time_us)
+		return (*rec1)->time_us < (*rec2)->time_us ? 1 : -1;
+
+	return *rec1 < *rec2 ? -1 : 1;
+}
+
+void bootstage_report_initcalls(void)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_initcall **sorted;
+	ulong total[2] = {0, 0};
+	ulong all;
+	uint count;
+	int i;
+
+	count = min_t(uint, data->initcall_count, INITCALL_COUNT);
+	if (!count) {
+		printf("No initcall timings recorded\n");
+		return;
+	}
+	sorted = calloc(count, sizeof(*sorted));
+	if (!sorted) {
+		printf("(out of memory)\n");
+		return;
+	}
+	for (i = 0; i < count; i++) {
+		sorted[i] = &data->initcall[i];
+		total[sorted[i]->reloc] += sorted[i]->time_us;
+	}
+	all = total[0] + total[1];
+
+	/* Most expensive first */
+	qsort(sorted, count, sizeof(*sorted), h_compare_initcall);
+
+	printf("Initcall timings in microseconds (%d records):\n", count);
+	printf("%11s  %4s  %5s  %s\n", "Time", "%", "Phase", "Initcall");
+	for (i = 0; i < count; i++) {
+		const struct bootstage_initcall *rec = sorted[i];
+		uint type = rec->addr & INITCALL_EVENT_TYPE;
+
+		print_grouped_ull(rec->time_us, BOOTSTAGE_DIGITS);
+		printf("  %3lu%%  %5s  ",
+		       all ? (ulong)rec->time_us * 100 / all : 0,
+		       rec->reloc ? "r" : "f");
+		if (initcall_rec_is_event(rec))
+			printf("event %d/%s\n", type, event_type_name(type));
+		else
+			printf("%08lx\n", rec->addr);
+	}
+	if (data->initcall_count > INITCALL_COUNT)
+		printf("Overflowed initcall table by %d entries\n"
+		       "Please increase CONFIG_BOOTSTAGE_INITCALL_COUNT\n",
+		       data->initcall_count - INITCALL_COUNT);
+
+	puts("\nTotal time:\n");
+	print_grouped_ull(total[0], BOOTSTAGE_DIGITS);
+	puts("  board_init_f\n");
+	print_grouped_ull(total[1], BOOTSTAGE_DIGITS);
+	puts("  board_init_r\n");
+	free(sorted);
+}
+#endif
+
 /**
  * Get a record name as a printable string
  *
@@ -263,6 +366,44 @@ static int h_compare_record(const void *r1, const void *r2)
 }
 
 #ifdef CONFIG_OF_LIBFDT
+/**
+ * Add the initcall timings to a device tree
+ *
+ * This adds an 'initcalls' node holding three arrays with an entry for each
+ * initcall, in the order they were called: 'addr' (64-bit), 'time-us' and
+ * 'reloc' (0 for board_init_f(), 1 for board_init_r())
+ *
+ * @blob: Device tree blob
+ * @bootstage: Offset of the bootstage node
+ * Return: 0 on success, != 0 on failure.
+ */
+static int add_initcalls_devicetree(struct fdt_header *blob, int bootstage)
+{
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALLS)
+	struct bootstage_data *data = gd->bootstage;
+	uint count = min_t(uint, data->initcall_count, INITCALL_COUNT);
+	int node;
+	int i;
+
+	if (!count)
+		return 0;
+	node = fdt_add_subnode(blob, bootstage, "initcalls");
+	if (node < 0)
+		return -EINVAL;
+
+	for (i = 0; i < count; i++) {
+		struct bootstage_initcall *rec = &data->initcall[i];
+
+		if (fdt_appendprop_u64(blob, node, "addr", rec->addr) ||
+		    fdt_appendprop_u32(blob, node, "time-us", rec->time_us) ||
+		    fdt_appendprop_u32(blob, node, "reloc", rec->reloc))
+			return -EINVAL;
+	}
+#endif
+
+	return 0;
+}
+
 /**
  * Add all bootstage timings to a device tree.
  *
@@ -315,7 +456,7 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 			return -EINVAL;
 	}
 
-	return 0;
+	return add_initcalls_devicetree(blob, bootstage);
 }
 
 int bootstage_fdt_add_report(void)
@@ -621,6 +621,12 @@ void mem_malloc_init(ulong start, ulong size)
 #if CONFIG_IS_ENABLED(SYS_MALLOC_CLEAR_ON_INIT)
 	memset((void *)mem_malloc_start, 0x0, size);
 #endif
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	malloc_slab_init();
+#endif
+#if CONFIG_IS_ENABLED(MALLOC_PROFILE)
+	malloc_prof_init();
+#endif
 }
 
 /* field-extraction macros */
@@ -1270,10 +1276,55 @@ static void malloc_extend_top(nb) INTERNAL_SIZE_T nb;
 
 */
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB) || CONFIG_IS_ENABLED(MALLOC_PROFILE)
+/*
+ * Small requests go to the slab front-end in malloc_slab.c, which takes its
+ * pages from here. Callers below which need a real chunk use mALLOc_core().
+ * The slab is skipped in test mode so that malloc_enable_testing() works.
+ *
+ * The public entry points also tell the profiler in malloc_prof.c who
+ * allocated each block.
+ */
+static Void_t *mALLOc_core(size_t bytes);
+
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+static bool malloc_use_slab(size_t bytes)
+{
+	if (bytes > MALLOC_SLAB_MAX)
+		return false;
+	if (CONFIG_IS_ENABLED(UNIT_TEST) && malloc_testing)
+		return false;
+#if CONFIG_IS_ENABLED(SYS_MALLOC_F)
+	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return false;
+#endif
+
+	return mem_malloc_start || mem_malloc_end;
+}
+#endif
+
+Void_t *mALLOc(size_t bytes)
+{
+	Void_t *mem = NULL;
+
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (malloc_use_slab(bytes))
+		mem = malloc_slab_alloc(bytes);
+#endif
+	if (!mem)
+		mem = mALLOc_core(bytes);
+	malloc_prof_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+#else
+#define mALLOc_core	mALLOc
+#endif
+
 #if __STD_C
-Void_t* mALLOc(size_t bytes)
+Void_t* mALLOc_core(size_t bytes)
 #else
-Void_t* mALLOc(bytes) size_t bytes;
+Void_t* mALLOc_core(bytes) size_t bytes;
 #endif
 {
   mchunkptr victim;                  /* inspected/selected chunk */
@@ -1583,6 +1634,13 @@ void fREe(mem) Void_t* mem;
   if (mem == NULL)                              /* free(0) has no effect */
     return;
 
+  malloc_prof_free(mem);
+
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+  if (malloc_slab_free(mem))
+    return;
+#endif
+
   p = mem2chunk(mem);
   hd = p->size;
 
@@ -1696,10 +1754,36 @@ void fREe(mem) Void_t* mem;
 */
 
 
+#if CONFIG_IS_ENABLED(MALLOC_PROFILE)
+static Void_t *rEALLOc_core(Void_t *oldmem, size_t bytes);
+
+Void_t *rEALLOc(Void_t *oldmem, size_t bytes)
+{
+	struct malloc_prof_block blk;
+	Void_t *newmem;
+	int old_cat = -1;
+
+	/* the block stays in the category it was first allocated in */
+	if (!malloc_prof_find(oldmem, &blk))
+		old_cat = malloc_prof_set_cat(blk.cat);
+	newmem = rEALLOc_core(oldmem, bytes);
+	if (newmem) {
+		malloc_prof_free(oldmem);
+		malloc_prof_alloc(newmem, bytes, __builtin_return_address(0));
+	}
+	if (old_cat != -1)
+		malloc_prof_set_cat(old_cat);
+
+	return newmem;
+}
+#else
+#define rEALLOc_core	rEALLOc
+#endif
+
 #if __STD_C
-Void_t* rEALLOc(Void_t* oldmem, size_t bytes)
+Void_t* rEALLOc_core(Void_t* oldmem, size_t bytes)
 #else
-Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
+Void_t* rEALLOc_core(oldmem, bytes) Void_t* oldmem; size_t bytes;
 #endif
 {
   INTERNAL_SIZE_T    nb;      /* padded request size */
@@ -1742,6 +1826,20 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
 	}
 #endif
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+  oldsize = malloc_slab_usable_size(oldmem);
+  if (oldsize) {
+    if (bytes <= oldsize)
+      return oldmem;
+    newmem = mALLOc(bytes);
+    if (!newmem)
+      return NULL;
+    MALLOC_COPY(newmem, oldmem, oldsize);
+    fREe(oldmem);
+    return newmem;
+  }
+#endif
+
   newp    = oldp    = mem2chunk(oldmem);
   newsize = oldsize = chunksize(oldp);
 
@@ -1869,7 +1967,7 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
 
     /* Must allocate */
 
-    newmem = mALLOc (bytes);
+    newmem = mALLOc_core (bytes);
 
     if (newmem == NULL)  /* propagate failure */
       return NULL;
@@ -1939,10 +2037,25 @@ Void_t* rEALLOc(oldmem, bytes) Void_t* oldmem; size_t bytes;
 */
 
 
+#if CONFIG_IS_ENABLED(MALLOC_PROFILE)
+#define mEMALIGn_core	memalign_unrecorded
+
+Void_t *mEMALIGn(size_t alignment, size_t bytes)
+{
+	Void_t *mem = mEMALIGn_core(alignment, bytes);
+
+	malloc_prof_alloc(mem, bytes, __builtin_return_address(0));
+
+	return mem;
+}
+#else
+#define mEMALIGn_core	mEMALIGn
+#endif
+
 #if __STD_C
-Void_t* mEMALIGn(size_t alignment, size_t bytes)
+Void_t* mEMALIGn_core(size_t alignment, size_t bytes)
 #else
-Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
+Void_t* mEMALIGn_core(alignment, bytes) size_t alignment; size_t bytes;
 #endif
 {
   INTERNAL_SIZE_T    nb;      /* padded  request size */
@@ -1974,7 +2087,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
   /* Call malloc with worst case padding to hit alignment. */
 
   nb = request2size(bytes);
-  m  = (char*)(mALLOc(nb + alignment + MINSIZE));
+  m  = (char*)(mALLOc_core(nb + alignment + MINSIZE));
 
   /*
   * The attempt to over-allocate (with a size large enough to guarantee the
@@ -1990,7 +2103,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
      * Use bytes not nb, since mALLOc internally calls request2size too, and
      * each call increases the size to allocate, to account for the header.
      */
-    m  = (char*)(mALLOc(bytes));
+    m  = (char*)(mALLOc_core(bytes));
     /* Aligned -> return it */
     if ((((unsigned long)(m)) % alignment) == 0)
       return m;
@@ -2001,7 +2114,7 @@ Void_t* mEMALIGn(alignment, bytes) size_t alignment; size_t bytes;
     fREe(m);
     /* Add in extra bytes to match misalignment of unexpanded allocation */
     extra = alignment - (((unsigned long)(m)) % alignment);
-    m  = (char*)(mALLOc(bytes + extra));
+    m  = (char*)(mALLOc_core(bytes + extra));
     /*
      * m might not be the same as before. Validate that the previous value of
      * extra still works for the current value of m.
@@ -2126,10 +2239,25 @@ Void_t* pvALLOc(bytes) size_t bytes;
 
 */
 
+#if CONFIG_IS_ENABLED(MALLOC_PROFILE)
+static Void_t *cALLOc_core(size_t n, size_t elem_size);
+
+Void_t *cALLOc(size_t n, size_t elem_size)
+{
+	Void_t *mem = cALLOc_core(n, elem_size);
+
+	malloc_prof_alloc(mem, n * elem_size, __builtin_return_address(0));
+
+	return mem;
+}
+#else
+#define cALLOc_core	cALLOc
+#endif
+
 #if __STD_C
-Void_t* cALLOc(size_t n, size_t elem_size)
+Void_t* cALLOc_core(size_t n, size_t elem_size)
 #else
-Void_t* cALLOc(n, elem_size) size_t n; size_t elem_size;
+Void_t* cALLOc_core(n, elem_size) size_t n; size_t elem_size;
 #endif
 {
   mchunkptr p;
@@ -2158,6 +2286,12 @@ Void_t* cALLOc(n, elem_size) size_t n; size_t elem_size;
 		memset(mem, 0, sz);
 		return mem;
 	}
+#endif
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+	if (malloc_slab_usable_size(mem)) {
+		memset(mem, 0, sz);
+		return mem;
+	}
 #endif
     p = mem2chunk(mem);
 
@@ -2309,6 +2443,12 @@ size_t malloc_usable_size(mem) Void_t* mem;
     return 0;
   else
   {
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+    size_t size = malloc_slab_usable_size(mem);
+
+    if (size)
+      return size;
+#endif
     p = mem2chunk(mem);
     if(!chunk_is_mmapped(p))
     {
@@ -2355,6 +2495,11 @@ static void malloc_update_mallinfo(void)
     }
   }
 
+#if CONFIG_IS_ENABLED(SYS_MALLOC_SLAB)
+  /* count the objects handed out by the slab, not the pages holding them */
+  avail += malloc_slab_unused();
+#endif
+
   current_mallinfo.ordblks = navail;
   current_mallinfo.uordblks = sbrked_mem - avail;
   current_mallinfo.fordblks = avail;
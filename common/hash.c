@@ -12,6 +12,7 @@
 #ifndef USE_HOSTCC
 #include <common.h>
 #include <command.h>
+#include <div64.h>
 #include <env.h>
 #include <log.h>
 #include <malloc.h>
@@ -360,6 +361,15 @@ int hash_progressive_lookup_algo(const char *algo_name,
 	return -EPROTONOSUPPORT;
 }
 
+struct hash_algo *hash_next_algo(struct hash_algo *algo)
+{
+	algo = algo ? algo + 1 : hash_algo;
+	if (algo >= hash_algo + ARRAY_SIZE(hash_algo))
+		return NULL;
+
+	return algo;
+}
+
 #ifndef USE_HOSTCC
 int hash_parse_string(const char *algo_name, const char *str, uint8_t *result)
 {
@@ -403,6 +413,59 @@ int hash_block(const char *algo_name, const void *data, unsigned int len,
 	return 0;
 }
 
+static int hash_bench_chunked(struct hash_algo *algo, const uint8_t *buf,
+			      unsigned int len, unsigned int chunk,
+			      uint8_t *output)
+{
+	unsigned int size;
+	void *ctx;
+
+	if (algo->hash_init(algo, &ctx))
+		return -ENOMEM;
+
+	for (; len; buf += size, len -= size) {
+		size = min(chunk, len);
+		/* the context has already been freed on error */
+		if (algo->hash_update(algo, ctx, buf, size, size == len))
+			return -EIO;
+	}
+
+	return algo->hash_finish(algo, ctx, output, HASH_MAX_DIGEST_SIZE) ?
+		-EIO : 0;
+}
+
+int hash_bench(struct hash_algo *algo, const void *buf, unsigned int len,
+	       unsigned int chunk, ulong min_us, ulong *kbpsp)
+{
+	uint8_t output[HASH_MAX_DIGEST_SIZE];
+	ulong start, elapsed;
+	u64 total = 0;
+	int ret;
+
+	if (!len)
+		return -EINVAL;
+	if (chunk && !algo->hash_init)
+		return -ENOSYS;
+
+	start = timer_get_us();
+	do {
+		if (chunk) {
+			ret = hash_bench_chunked(algo, buf, len, chunk, output);
+			if (ret)
+				return ret;
+		} else {
+			algo->hash_func_ws(buf, len, output, algo->chunk_size);
+		}
+		total += len;
+		elapsed = timer_get_us() - start;
+	} while (elapsed < min_us);
+
+	/* bytes per millisecond is KB/s */
+	*kbpsp = lldiv(total * 1000, max(elapsed, 1UL));
+
+	return 0;
+}
+
 #if !defined(CONFIG_SPL_BUILD) && (defined(CONFIG_CMD_HASH) || \
 	defined(CONFIG_CMD_SHA1SUM) || defined(CONFIG_CMD_CRC32))
 /**
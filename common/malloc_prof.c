@@ -0,0 +1,378 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tracking of malloc() usage
+ *
+ * Each live block in the full malloc() pool is recorded with its size, the
+ * address of the code which allocated it, the time and the log category
+ * selected with malloc_prof_set_cat(), e.g. the uclass of the device being
+ * probed. When the pool runs out this shows who holds the memory, and the
+ * peak usage of each category shows which one needs it.
+ *
+ * Blocks are kept in an open-addressed hash table keyed by address, so
+ * recording an allocation or a free takes constant time. Nothing is recorded
+ * before relocation, since the simple malloc() pool is dropped anyway.
+ */
+
+#include <errno.h>
+#include <log.h>
+#include <malloc.h>
+#include <sort.h>
+#include <time.h>
+#include <asm/global_data.h>
+#include <linux/kernel.h>
+#include <linux/string.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define PROF_ENTRIES		CONFIG_MALLOC_PROFILE_ENTRIES
+
+/* Stop recording when the table is this full, to keep lookups short */
+#define PROF_MAX_LIVE		(PROF_ENTRIES - PROF_ENTRIES / 8)
+
+/* Number of call sites which malloc_prof_show() can tell apart */
+#define PROF_MAX_SITES		256
+
+/* Number of call sites and blocks shown by malloc_prof_show() */
+#define PROF_SHOW_SITES		20
+#define PROF_SHOW_BLOCKS	10
+
+/**
+ * struct prof_rec - a live block
+ *
+ * @ptr: Address of the block, or 0 if this slot is empty
+ * @caller: Address the allocation function returned to
+ * @size: Size requested, in bytes
+ * @time_ms: Value of get_timer(0) when the block was allocated
+ * @cat: Log category selected when the block was allocated
+ */
+struct prof_rec {
+	ulong ptr;
+	ulong caller;
+	ulong size;
+	u32 time_ms;
+	u16 cat;
+};
+
+/**
+ * struct prof_site - live blocks from one call site, for malloc_prof_show()
+ *
+ * @caller: Address the allocation function returned to, or 0 for the sites
+ *	which did not fit in the table
+ * @count: Number of live blocks
+ * @bytes: Total size of those blocks
+ */
+struct prof_site {
+	ulong caller;
+	ulong count;
+	ulong bytes;
+};
+
+static struct prof_state {
+	struct prof_rec table[PROF_ENTRIES];
+	struct malloc_prof_stats total;
+	struct malloc_prof_stats cat[LOGC_COUNT];
+	int cur_cat;
+	bool busy;
+} prof;
+
+static struct prof_site prof_sites[PROF_MAX_SITES + 1];
+
+static uint prof_hash(ulong ptr)
+{
+	return ((ptr >> 3) ^ (ptr >> 15)) % PROF_ENTRIES;
+}
+
+static uint prof_next(uint i)
+{
+	return i + 1 < PROF_ENTRIES ? i + 1 : 0;
+}
+
+/* Nothing is tracked before relocation, or while tracking allocates */
+static bool prof_ready(void)
+{
+	return (gd->flags & GD_FLG_FULL_MALLOC_INIT) && !prof.busy;
+}
+
+static u32 prof_time(void)
+{
+#ifdef CONFIG_TIMER
+	/* don't probe the timer from inside malloc() */
+	if (!gd->timer)
+		return 0;
+#endif
+	return get_timer(0);
+}
+
+static struct prof_rec *prof_find(ulong ptr)
+{
+	uint i = prof_hash(ptr);
+	struct prof_rec *rec;
+
+	for (rec = &prof.table[i]; rec->ptr; rec = &prof.table[i]) {
+		if (rec->ptr == ptr)
+			return rec;
+		i = prof_next(i);
+	}
+
+	return NULL;
+}
+
+/* Check whether @home lies in the cyclic range (@from, @to] */
+static bool prof_in_range(uint from, uint home, uint to)
+{
+	if (from <= to)
+		return home > from && home <= to;
+
+	return home > from || home <= to;
+}
+
+/* Remove a record, moving back later entries so no lookup is cut short */
+static void prof_remove(struct prof_rec *rec)
+{
+	uint hole = rec - prof.table;
+	uint i;
+
+	for (i = prof_next(hole); prof.table[i].ptr; i = prof_next(i)) {
+		if (prof_in_range(hole, prof_hash(prof.table[i].ptr), i))
+			continue;
+		prof.table[hole] = prof.table[i];
+		hole = i;
+	}
+	prof.table[hole].ptr = 0;
+}
+
+static void prof_add(struct malloc_prof_stats *stats, ulong size)
+{
+	stats->allocs++;
+	stats->count++;
+	stats->cur += size;
+	stats->peak = max(stats->peak, stats->cur);
+}
+
+static void prof_sub(struct malloc_prof_stats *stats, ulong size)
+{
+	stats->frees++;
+	stats->count--;
+	stats->cur -= size;
+}
+
+void malloc_prof_alloc(void *ptr, size_t size, void *caller)
+{
+	struct prof_rec *rec;
+	uint i;
+
+	if (!ptr || !prof_ready())
+		return;
+	prof.busy = true;
+
+	/*
+	 * An inner call, e.g. malloc() from calloc(), may have recorded the
+	 * block already; the outermost caller is the one that matters
+	 */
+	rec = prof_find((ulong)ptr);
+	if (rec) {
+		prof.total.cur += size - rec->size;
+		prof.cat[rec->cat].cur += size - rec->size;
+		rec->size = size;
+		rec->caller = (ulong)caller;
+		goto out;
+	}
+
+	if (prof.total.count >= PROF_MAX_LIVE) {
+		prof.total.dropped++;
+		prof.cat[prof.cur_cat].dropped++;
+		goto out;
+	}
+
+	for (i = prof_hash((ulong)ptr); prof.table[i].ptr; i = prof_next(i))
+		;
+	rec = &prof.table[i];
+	rec->ptr = (ulong)ptr;
+	rec->caller = (ulong)caller;
+	rec->size = size;
+	rec->time_ms = prof_time();
+	rec->cat = prof.cur_cat;
+	prof_add(&prof.total, size);
+	prof_add(&prof.cat[rec->cat], size);
+out:
+	prof.busy = false;
+}
+
+void malloc_prof_free(void *ptr)
+{
+	struct prof_rec *rec;
+
+	if (!ptr || !prof_ready())
+		return;
+
+	rec = prof_find((ulong)ptr);
+	if (!rec)
+		return;
+	prof_sub(&prof.total, rec->size);
+	prof_sub(&prof.cat[rec->cat], rec->size);
+	prof_remove(rec);
+}
+
+int malloc_prof_set_cat(int cat)
+{
+	int old;
+
+	/* BSS is not available before relocation */
+	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return LOGC_NONE;
+
+	old = prof.cur_cat;
+	prof.cur_cat = cat >= 0 && cat < LOGC_COUNT ? cat : LOGC_NONE;
+
+	return old;
+}
+
+int malloc_prof_get_stats(int cat, struct malloc_prof_stats *stats)
+{
+	if (cat == MALLOC_PROF_ALL)
+		*stats = prof.total;
+	else if (cat >= 0 && cat < LOGC_COUNT)
+		*stats = prof.cat[cat];
+	else
+		return -ENOENT;
+
+	return 0;
+}
+
+int malloc_prof_find(const void *ptr, struct malloc_prof_block *blk)
+{
+	struct prof_rec *rec;
+
+	rec = ptr ? prof_find((ulong)ptr) : NULL;
+	if (!rec)
+		return -ENOENT;
+
+	blk->ptr = (void *)rec->ptr;
+	blk->caller = rec->caller;
+	blk->size = rec->size;
+	blk->time_ms = rec->time_ms;
+	blk->cat = rec->cat;
+
+	return 0;
+}
+
+static void prof_show_cat(const char *name, int cat,
+			  struct malloc_prof_stats *stats)
+{
+	if (name)
+		printf("%-16s", name);
+	else
+		printf("%-16d", cat);
+	printf(" %8lu %10lu %10lu %8lu\n", stats->count, stats->cur,
+	       stats->peak, stats->dropped);
+}
+
+static int prof_site_cmp(const void *a, const void *b)
+{
+	const struct prof_site *sa = a, *sb = b;
+
+	if (sa->bytes != sb->bytes)
+		return sa->bytes < sb->bytes ? 1 : -1;
+
+	return 0;
+}
+
+static void prof_show_sites(void)
+{
+	struct prof_site *other = &prof_sites[PROF_MAX_SITES];
+	uint i, j, count = 0;
+
+	memset(prof_sites, '\0', sizeof(prof_sites));
+	for (i = 0; i < PROF_ENTRIES; i++) {
+		struct prof_rec *rec = &prof.table[i];
+		struct prof_site *site = other;
+
+		if (!rec->ptr)
+			continue;
+		for (j = 0; j < count; j++) {
+			if (prof_sites[j].caller == rec->caller)
+				break;
+		}
+		if (j < count) {
+			site = &prof_sites[j];
+		} else if (count < PROF_MAX_SITES) {
+			site = &prof_sites[count++];
+			site->caller = rec->caller;
+		}
+		site->count++;
+		site->bytes += rec->size;
+	}
+	qsort(prof_sites, count, sizeof(*prof_sites), prof_site_cmp);
+
+	printf("\n%-16s %8s %10s\n", "Caller", "Blocks", "Bytes");
+	for (i = 0; i < min(count, (uint)PROF_SHOW_SITES); i++)
+		printf("%16lx %8lu %10lu\n",
+		       prof_sites[i].caller - gd->reloc_off,
+		       prof_sites[i].count, prof_sites[i].bytes);
+	if (other->count)
+		printf("%-16s %8lu %10lu\n", "(other)", other->count,
+		       other->bytes);
+}
+
+static void prof_show_blocks(void)
+{
+	struct prof_rec *top[PROF_SHOW_BLOCKS];
+	uint i, j, count = 0;
+
+	for (i = 0; i < PROF_ENTRIES; i++) {
+		struct prof_rec *rec = &prof.table[i];
+
+		if (!rec->ptr)
+			continue;
+		if (count == PROF_SHOW_BLOCKS) {
+			if (rec->size <= top[count - 1]->size)
+				continue;
+			count--;
+		}
+		for (j = count; j && top[j - 1]->size < rec->size; j--)
+			top[j] = top[j - 1];
+		top[j] = rec;
+		count++;
+	}
+
+	printf("\n%-16s %10s %16s %8s %s\n", "Address", "Bytes", "Caller",
+	       "Time", "Category");
+	for (i = 0; i < count; i++) {
+		printf("%16lx %10lu %16lx %8u ", top[i]->ptr, top[i]->size,
+		       top[i]->caller - gd->reloc_off, top[i]->time_ms);
+		if (IS_ENABLED(CONFIG_LOG))
+			printf("%s\n", log_get_cat_name(top[i]->cat));
+		else
+			printf("%d\n", top[i]->cat);
+	}
+}
+
+void malloc_prof_show(void)
+{
+	struct malloc_prof_stats *stats = &prof.total;
+	int cat;
+
+	printf("Heap: %lu bytes in %lu blocks, peak %lu bytes\n", stats->cur,
+	       stats->count, stats->peak);
+	printf("Allocs %lu, frees %lu, untracked %lu\n", stats->allocs,
+	       stats->frees, stats->dropped);
+
+	printf("\n%-16s %8s %10s %10s %8s\n", "Category", "Blocks", "Bytes",
+	       "Peak", "Untracked");
+	for (cat = 0; cat < LOGC_COUNT; cat++) {
+		stats = &prof.cat[cat];
+		if (!stats->allocs && !stats->dropped)
+			continue;
+		prof_show_cat(IS_ENABLED(CONFIG_LOG) ?
+			      log_get_cat_name(cat) : NULL, cat, stats);
+	}
+
+	prof_show_sites();
+	prof_show_blocks();
+}
+
+void malloc_prof_init(void)
+{
+	memset(&prof, '\0', sizeof(prof));
+	prof.cur_cat = LOGC_NONE;
+}
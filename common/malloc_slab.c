@@ -0,0 +1,319 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Slab front-end for malloc()
+ *
+ * Allocations of up to MALLOC_SLAB_MAX bytes are served from power-of-two
+ * size classes. Each class carves its objects out of pages taken from the
+ * main malloc() pool, so allocating or freeing an object is just a free-list
+ * operation, with no bin search or coalescing, and the many small objects
+ * created by driver model and friends do not fragment the main pool.
+ *
+ * Pages are aligned to their size and objects to their own size, so every
+ * object in a class of at least ARCH_DMA_MINALIGN bytes has a cache line to
+ * itself. A bitmap with one bit for each page of the malloc() area lets
+ * free() tell slab objects from ordinary chunks.
+ */
+
+#include <errno.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <asm/cache.h>
+#include <linux/bitops.h>
+#include <linux/kernel.h>
+#include <linux/list.h>
+#include <linux/sizes.h>
+#include <linux/string.h>
+
+/* Size and alignment of each page taken from the malloc() pool */
+#define SLAB_PAGE_SIZE		SZ_16K
+
+/* Smallest class; the others double in size up to MALLOC_SLAB_MAX */
+#define SLAB_MIN_SHIFT		4
+
+/**
+ * struct slab_page - header at the start of each slab page
+ *
+ * @sibling: Node in the class's list of pages with free objects
+ * @freelist: Most recently freed object, which holds a pointer to the next
+ *	one, or NULL if there are none
+ * @carved: Number of objects handed out at least once; the rest of the page
+ *	is untouched
+ * @inuse: Number of objects currently allocated
+ * @total: Number of objects which fit in the page
+ * @cls: Class index
+ */
+struct slab_page {
+	struct list_head sibling;
+	void *freelist;
+	ushort carved;
+	ushort inuse;
+	ushort total;
+	ushort cls;
+};
+
+/**
+ * struct slab_class - a size class
+ *
+ * @partial: Pages with free objects, most recently used first
+ * @stats: Statistics for this class
+ */
+struct slab_class {
+	struct list_head partial;
+	struct malloc_slab_stats stats;
+};
+
+/**
+ * struct slab_state - state of the slab front-end
+ *
+ * @cls: Size classes, smallest first
+ * @map: Bitmap with a bit set for each page of the malloc() area which
+ *	belongs to the slab, or NULL if not set up yet
+ * @base: Address of the page corresponding to bit 0 of @map
+ * @npages: Number of bits in @map
+ * @heap: Bytes of the malloc() pool held by the slab, including @map
+ * @setup: true while @map is being allocated
+ */
+static struct slab_state {
+	struct slab_class cls[MALLOC_SLAB_CLASSES];
+	ulong *map;
+	ulong base;
+	ulong npages;
+	ulong heap;
+	bool setup;
+} slab;
+
+static uint slab_size(uint cls)
+{
+	return 1U << (cls + SLAB_MIN_SHIFT);
+}
+
+static uint slab_class(size_t bytes)
+{
+	if (bytes <= 1U << SLAB_MIN_SHIFT)
+		return 0;
+
+	return fls(bytes - 1) - SLAB_MIN_SHIFT;
+}
+
+/* Offset of the first object in a page, keeping objects size-aligned */
+static uint slab_first(uint size)
+{
+	return ALIGN(sizeof(struct slab_page), size);
+}
+
+/*
+ * Heap space taken by a block from the malloc() pool, as counted by
+ * mallinfo(): the usable size plus the chunk's size field
+ */
+static ulong slab_heap_size(void *ptr)
+{
+	return malloc_usable_size(ptr) + sizeof(size_t);
+}
+
+static bool slab_test(ulong bit)
+{
+	return slab.map[bit / BITS_PER_LONG] & BIT(bit % BITS_PER_LONG);
+}
+
+static void slab_mark(void *ptr, bool set)
+{
+	ulong bit = ((ulong)ptr - slab.base) / SLAB_PAGE_SIZE;
+
+	if (set)
+		slab.map[bit / BITS_PER_LONG] |= BIT(bit % BITS_PER_LONG);
+	else
+		slab.map[bit / BITS_PER_LONG] &= ~BIT(bit % BITS_PER_LONG);
+}
+
+static struct slab_page *slab_page_of(const void *ptr)
+{
+	ulong addr = (ulong)ptr;
+	ulong bit;
+
+	if (!slab.map || addr < slab.base)
+		return NULL;
+	bit = (addr - slab.base) / SLAB_PAGE_SIZE;
+	if (bit >= slab.npages || !slab_test(bit))
+		return NULL;
+
+	return (struct slab_page *)(slab.base + bit * SLAB_PAGE_SIZE);
+}
+
+static int slab_setup(void)
+{
+	ulong base, npages;
+	ulong *map;
+	int i;
+
+	/* the calloc() below may come back here; let it use the main pool */
+	if (slab.setup)
+		return -EBUSY;
+	slab.setup = true;
+	base = ALIGN_DOWN(mem_malloc_start, SLAB_PAGE_SIZE);
+	npages = DIV_ROUND_UP(mem_malloc_end - base, SLAB_PAGE_SIZE);
+	map = calloc(BITS_TO_LONGS(npages), sizeof(ulong));
+	slab.setup = false;
+	if (!map)
+		return -ENOMEM;
+
+	for (i = 0; i < MALLOC_SLAB_CLASSES; i++)
+		INIT_LIST_HEAD(&slab.cls[i].partial);
+	slab.base = base;
+	slab.npages = npages;
+	slab.heap = slab_heap_size(map);
+	slab.map = map;
+
+	return 0;
+}
+
+static struct slab_page *slab_new_page(uint cls)
+{
+	struct slab_class *sc = &slab.cls[cls];
+	struct slab_page *page;
+	uint size = slab_size(cls);
+
+	/* the profiler tracks the objects, not the page holding them */
+	page = memalign_unrecorded(SLAB_PAGE_SIZE, SLAB_PAGE_SIZE);
+	if (!page)
+		return NULL;
+
+	page->freelist = NULL;
+	page->carved = 0;
+	page->inuse = 0;
+	page->total = (SLAB_PAGE_SIZE - slab_first(size)) / size;
+	page->cls = cls;
+	list_add(&page->sibling, &sc->partial);
+	slab_mark(page, true);
+	slab.heap += slab_heap_size(page);
+	sc->stats.pages++;
+	sc->stats.objs += page->total;
+	sc->stats.max_pages = max(sc->stats.max_pages, sc->stats.pages);
+
+	return page;
+}
+
+static void slab_free_page(struct slab_page *page)
+{
+	struct slab_class *sc = &slab.cls[page->cls];
+
+	list_del(&page->sibling);
+	sc->stats.pages--;
+	sc->stats.objs -= page->total;
+	slab.heap -= slab_heap_size(page);
+	/* clear the bit first, so that free() treats it as a normal chunk */
+	slab_mark(page, false);
+	free(page);
+}
+
+void *malloc_slab_alloc(size_t bytes)
+{
+	struct slab_class *sc;
+	struct slab_page *page;
+	uint cls, size;
+	void *obj;
+
+	if (bytes > MALLOC_SLAB_MAX)
+		return NULL;
+	if (!slab.map && slab_setup())
+		return NULL;
+
+	cls = slab_class(bytes);
+	sc = &slab.cls[cls];
+	if (list_empty(&sc->partial)) {
+		page = slab_new_page(cls);
+		if (!page)
+			return NULL;
+	} else {
+		page = list_first_entry(&sc->partial, struct slab_page,
+					sibling);
+	}
+
+	size = slab_size(cls);
+	if (page->freelist) {
+		obj = page->freelist;
+		page->freelist = *(void **)obj;
+	} else {
+		obj = (void *)page + slab_first(size) + page->carved * size;
+		page->carved++;
+	}
+	page->inuse++;
+	if (page->inuse == page->total)
+		list_del(&page->sibling);
+	sc->stats.allocs++;
+	sc->stats.inuse++;
+
+	return obj;
+}
+
+bool malloc_slab_free(void *ptr)
+{
+	struct slab_page *page = slab_page_of(ptr);
+	struct slab_class *sc;
+	uint size, first;
+	ulong offset;
+
+	if (!page)
+		return false;
+
+	/*
+	 * A pointer into a slab page which is not the start of an object must
+	 * not reach the free list, nor be passed on to the main pool
+	 */
+	size = slab_size(page->cls);
+	first = slab_first(size);
+	offset = (ulong)ptr - (ulong)page;
+	if (offset < first || (offset - first) % size ||
+	    (offset - first) / size >= page->carved) {
+		printf("free(): invalid slab pointer %p\n", ptr);
+		return true;
+	}
+
+	sc = &slab.cls[page->cls];
+	if (page->inuse == page->total)
+		list_add(&page->sibling, &sc->partial);
+	*(void **)ptr = page->freelist;
+	page->freelist = ptr;
+	page->inuse--;
+	sc->stats.frees++;
+	sc->stats.inuse--;
+
+	/* keep one page with free objects, so alloc/free pairs do not thrash */
+	if (!page->inuse && !list_is_singular(&sc->partial))
+		slab_free_page(page);
+
+	return true;
+}
+
+size_t malloc_slab_usable_size(const void *ptr)
+{
+	struct slab_page *page = slab_page_of(ptr);
+
+	return page ? slab_size(page->cls) : 0;
+}
+
+ulong malloc_slab_unused(void)
+{
+	ulong used = 0;
+	int i;
+
+	for (i = 0; i < MALLOC_SLAB_CLASSES; i++)
+		used += slab.cls[i].stats.inuse * slab_size(i);
+
+	return slab.heap - used;
+}
+
+int malloc_slab_get_stats(uint cls, struct malloc_slab_stats *stats)
+{
+	if (cls >= MALLOC_SLAB_CLASSES)
+		return -ENOENT;
+
+	*stats = slab.cls[cls].stats;
+	stats->size = slab_size(cls);
+
+	return 0;
+}
+
+void malloc_slab_init(void)
+{
+	memset(&slab, '\0', sizeof(slab));
+}
@@ -18,9 +18,14 @@
 #include <asm/io.h>
 #include <linux/libfdt.h>
 #include <linux/printk.h>
+#include <linux/sizes.h>
+#include <linux/zstd.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/* Amount of compressed data read at a time when streaming an image */
+#define SPL_FIT_STREAM_CHUNK	SZ_64K
+
 struct spl_fit_info {
 	const void *fit;	/* Pointer to a valid FIT blob */
 	size_t ext_data_offset;	/* Offset to FIT external data (end of FIT) */
@@ -187,6 +192,74 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return ALIGN(data_size, spl_get_bl_len(info));
 }
 
+/**
+ * spl_fit_stream_zstd() - read and decompress zstd image data chunk-wise
+ *
+ * This avoids reading the whole compressed image into a temporary buffer
+ * first: each chunk is decompressed straight to the load address as soon as
+ * it has been read.
+ *
+ * @info:	points to information about the device to load data from
+ * @fit_offset:	offset of the FIT on the device
+ * @offset:	offset of the image data, relative to @fit_offset
+ * @len:	size of the compressed image data
+ * @dst:	buffer to decompress into
+ * @dst_size:	size of @dst
+ * @sizep:	returns the decompressed size
+ * Return:	0 on success or a negative error number
+ */
+static int spl_fit_stream_zstd(struct spl_load_info *info, ulong fit_offset,
+			       int offset, ulong len, void *dst,
+			       ulong dst_size, ulong *sizep)
+{
+	zstd_out_buffer out = { .dst = dst, .size = dst_size };
+	ulong chunk, pos, left, overhead, size;
+	struct zstd_stream strm;
+	zstd_in_buffer in;
+	void *buf;
+	int ret;
+
+	chunk = ALIGN(SPL_FIT_STREAM_CHUNK, spl_get_bl_len(info));
+	buf = malloc_cache_aligned(chunk);
+	if (!buf)
+		return -ENOMEM;
+
+	ret = zstd_stream_init(&strm, 0, true);
+	if (ret)
+		goto out_buf;
+
+	overhead = get_aligned_image_overhead(info, offset);
+	pos = fit_offset + get_aligned_image_offset(info, offset);
+	left = len + overhead;
+	do {
+		size = min(chunk, left);
+		if (info->read(info, pos,
+			       ALIGN(size, spl_get_bl_len(info)), buf) < size) {
+			ret = -EIO;
+			break;
+		}
+		in.src = buf + overhead;
+		in.size = size - overhead;
+		in.pos = 0;
+		ret = zstd_stream_feed(&strm, &in, &out);
+		pos += size;
+		left -= size;
+		overhead = 0;
+	} while (!ret && left);
+
+	if (ret >= 0) {
+		ret = zstd_stream_finish(&strm);
+		*sizep = out.pos;
+	} else {
+		zstd_stream_finish(&strm);
+	}
+	debug("zstd stream: %lx -> %lx, ret=%d\n", len, (ulong)out.pos, ret);
+out_buf:
+	free(buf);
+
+	return ret;
+}
+
 /**
  * load_simple_fit(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -261,8 +334,28 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 			return 0;
 		}
 
+		/*
+		 * Without a hash check or post-processing the compressed data
+		 * is not needed in one piece, so zstd images can be
+		 * decompressed while being read
+		 */
+		if (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD &&
+		    !CONFIG_IS_ENABLED(FIT_SIGNATURE) &&
+		    !CONFIG_IS_ENABLED(FIT_IMAGE_POST_PROCESS)) {
+			load_ptr = map_sysmem(load_addr, 0);
+			if (spl_fit_stream_zstd(info, fit_offset, offset, len,
+						load_ptr, CONFIG_SYS_BOOTM_LEN,
+						&size)) {
+				puts("Uncompressing error\n");
+				return -EIO;
+			}
+			length = size;
+			goto done;
+		}
+
 		if (spl_decompression_enabled() &&
-		    (image_comp == IH_COMP_GZIP || image_comp == IH_COMP_LZMA))
+		    (image_comp == IH_COMP_GZIP || image_comp == IH_COMP_LZMA ||
+		     image_comp == IH_COMP_ZSTD))
 			src_ptr = map_sysmem(ALIGN(CONFIG_SYS_LOAD_ADDR, ARCH_DMA_MINALIGN), len);
 		else
 			src_ptr = map_sysmem(ALIGN(load_addr, ARCH_DMA_MINALIGN), len);
@@ -311,11 +404,12 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 			return -EIO;
 		}
 		length = size;
-	} else if (IS_ENABLED(CONFIG_SPL_LZMA) && image_comp == IH_COMP_LZMA) {
+	} else if ((IS_ENABLED(CONFIG_SPL_LZMA) && image_comp == IH_COMP_LZMA) ||
+		   (IS_ENABLED(CONFIG_SPL_ZSTD) && image_comp == IH_COMP_ZSTD)) {
 		size = CONFIG_SYS_BOOTM_LEN;
 		ulong loadEnd;
 
-		if (image_decomp(IH_COMP_LZMA, CONFIG_SYS_LOAD_ADDR, 0, 0,
+		if (image_decomp(image_comp, CONFIG_SYS_LOAD_ADDR, 0, 0,
 				 load_ptr, src, length, size, &loadEnd)) {
 			puts("Uncompressing error\n");
 			return -EIO;
@@ -325,6 +419,7 @@ static int load_simple_fit(struct spl_load_info *info, ulong fit_offset,
 		memcpy(load_ptr, src, length);
 	}
 
+done:
 	if (image_info) {
 		ulong entry_point;
 
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Device dependencies taken from the devicetree
+ *
+ * Rather than probing every device in a uclass, boot code can probe just the
+ * device it needs with device_probe_deps(). This finds the providers the
+ * device refers to in its node and probes those first, so that the driver
+ * does not have to wait for them one at a time from its probe() method.
+ */
+
+#define LOG_CATEGORY LOGC_DM
+
+#include <dm.h>
+#include <errno.h>
+#include <log.h>
+#include <dm/deps.h>
+#include <dm/device-internal.h>
+#include <dm/ofnode.h>
+#include <linux/kernel.h>
+
+/* Maximum number of dependencies followed for each device */
+#define DM_DEPS_MAX		16
+
+/**
+ * struct dep_prop - a devicetree property which refers to a provider
+ *
+ * @list: Name of the property holding the phandles
+ * @cells: Name of the property in the provider giving the number of argument
+ *	cells after each phandle, or NULL if there are none
+ */
+struct dep_prop {
+	const char *list;
+	const char *cells;
+};
+
+static const struct dep_prop dep_props[] = {
+	{ "clocks", "#clock-cells" },
+	{ "resets", "#reset-cells" },
+	{ "power-domains", "#power-domain-cells" },
+	{ "phys", "#phy-cells" },
+	{ "pinctrl-0", NULL },
+};
+
+static bool dep_is_ancestor(struct udevice *dev, struct udevice *dep)
+{
+	for (dev = dev->parent; dev; dev = dev->parent) {
+		if (dev == dep)
+			return true;
+	}
+
+	return false;
+}
+
+/* Find the device for a node, or for the nearest ancestor that has one */
+static struct udevice *dep_find_owner(ofnode node)
+{
+	struct udevice *owner;
+	ofnode root = ofnode_root();
+
+	for (; ofnode_valid(node) && !ofnode_equal(node, root);
+	     node = ofnode_get_parent(node)) {
+		if (!device_find_global_by_ofnode(node, &owner))
+			return owner;
+	}
+
+	return NULL;
+}
+
+int dev_get_deps(struct udevice *dev, struct udevice **deps, int max)
+{
+	ofnode node = dev_ofnode(dev);
+	struct ofnode_phandle_args args;
+	struct udevice *dep;
+	int count = 0;
+	int i, j;
+
+	if (!ofnode_valid(node))
+		return 0;
+
+	for (i = 0; i < ARRAY_SIZE(dep_props); i++) {
+		const struct dep_prop *prop = &dep_props[i];
+		int index;
+
+		for (index = 0; ; index++) {
+			if (ofnode_parse_phandle_with_args(node, prop->list,
+							   prop->cells, 0,
+							   index, &args))
+				break;
+			dep = dep_find_owner(args.node);
+			if (!dep || dep == dev || dep_is_ancestor(dev, dep))
+				continue;
+			for (j = 0; j < count; j++) {
+				if (deps[j] == dep)
+					break;
+			}
+			if (j < count)
+				continue;
+			if (count == max)
+				return -E2BIG;
+			deps[count++] = dep;
+		}
+	}
+
+	return count;
+}
+
+static bool dep_in_path(struct udevice **path, int depth, struct udevice *dev)
+{
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		if (path[i] == dev)
+			return true;
+	}
+
+	return false;
+}
+
+static int probe_deps(struct udevice *dev, struct udevice **path, int depth)
+{
+	struct udevice *deps[DM_DEPS_MAX];
+	int count, i, ret;
+
+	if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
+		return 0;
+
+	if (depth < DM_DEPS_MAX_DEPTH) {
+		path[depth] = dev;
+		if (dev->parent && !dep_in_path(path, depth, dev->parent))
+			probe_deps(dev->parent, path, depth + 1);
+		count = dev_get_deps(dev, deps, ARRAY_SIZE(deps));
+		if (count == -E2BIG)
+			count = ARRAY_SIZE(deps);
+		for (i = 0; i < count; i++) {
+			if (dep_in_path(path, depth, deps[i]))
+				continue;
+			ret = probe_deps(deps[i], path, depth + 1);
+			if (ret)
+				log_debug("%s: dependency %s failed to probe: %d\n",
+					  dev->name, deps[i]->name, ret);
+		}
+	}
+
+	return device_probe(dev);
+}
+
+int device_probe_deps(struct udevice *dev)
+{
+	struct udevice *path[DM_DEPS_MAX_DEPTH];
+
+	if (!dev)
+		return -EINVAL;
+
+	return probe_deps(dev, path, 0);
+}
+
+static int dep_level(struct udevice *dev, struct udevice **path, int depth)
+{
+	struct udevice *deps[DM_DEPS_MAX];
+	int count, level, i;
+
+	/* the root device is always probed first */
+	if (!dev->parent)
+		return -1;
+	if (depth == DM_DEPS_MAX_DEPTH || dep_in_path(path, depth, dev))
+		return -ELOOP;
+	path[depth] = dev;
+
+	level = dep_level(dev->parent, path, depth + 1);
+	if (level == -ELOOP)
+		return level;
+	count = dev_get_deps(dev, deps, ARRAY_SIZE(deps));
+	if (count == -E2BIG)
+		count = ARRAY_SIZE(deps);
+	for (i = 0; i < count; i++) {
+		int ret = dep_level(deps[i], path, depth + 1);
+
+		if (ret == -ELOOP)
+			return ret;
+		level = max(level, ret);
+	}
+
+	return level + 1;
+}
+
+int dev_get_dep_level(struct udevice *dev)
+{
+	struct udevice *path[DM_DEPS_MAX_DEPTH];
+
+	if (!dev)
+		return -EINVAL;
+	if (!dev->parent)
+		return 0;
+
+	return dep_level(dev, path, 0);
+}
@@ -33,6 +33,7 @@
 #include <linux/err.h>
 #include <linux/list.h>
 #include <power-domain.h>
+#include <time.h>
 #include <linux/printk.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -478,9 +479,57 @@ static int device_get_dma_constraints(struct udevice *dev)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(DM_PROBE_TIMES)
+struct probe_time {
+	bool active;
+	ulong start;
+	ulong nested;
+};
+
+/* Read the timer, unless that would mean probing the timer device */
+static bool probe_time_now(ulong *now)
+{
+#ifdef CONFIG_TIMER
+	if (!gd->timer)
+		return false;
+#endif
+	*now = timer_get_us();
+
+	return true;
+}
+
+static void probe_time_start(struct probe_time *pt)
+{
+	pt->active = probe_time_now(&pt->start);
+	pt->nested = gd->dm_probe_nested_us;
+}
+
+static void probe_time_end(struct udevice *dev, struct probe_time *pt)
+{
+	ulong now, taken, nested;
+
+	if (!pt->active || !probe_time_now(&now))
+		return;
+
+	taken = now - pt->start;
+	nested = gd->dm_probe_nested_us - pt->nested;
+	dev->probe_time_us_ = taken > nested ? taken - nested : 0;
+	gd->dm_probe_nested_us = pt->nested + taken;
+}
+#else
+struct probe_time {
+};
+
+static inline void probe_time_start(struct probe_time *pt) {}
+static inline void probe_time_end(struct udevice *dev,
+				  struct probe_time *pt) {}
+#endif
+
 int device_probe(struct udevice *dev)
 {
+	struct probe_time pt = {};
 	const struct driver *drv;
+	int old_cat;
 	int ret;
 
 	if (!dev)
@@ -496,6 +545,9 @@ int device_probe(struct udevice *dev)
 	drv = dev->driver;
 	assert(drv);
 
+	/* charge what the device allocates to its uclass */
+	old_cat = malloc_prof_set_cat(device_get_uclass_id(dev));
+
 	ret = device_of_to_plat(dev);
 	if (ret)
 		goto fail;
@@ -512,11 +564,14 @@ int device_probe(struct udevice *dev)
 		 * (e.g. PCI bridge devices). Test the flags again
 		 * so that we don't mess up the device.
 		 */
-		if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
+		if (dev_get_flags(dev) & DM_FLAG_ACTIVATED) {
+			malloc_prof_set_cat(old_cat);
 			return 0;
+		}
 	}
 
 	dev_or_flags(dev, DM_FLAG_ACTIVATED);
+	probe_time_start(&pt);
 
 	if (CONFIG_IS_ENABLED(POWER_DOMAIN) && dev->parent &&
 	    (device_get_uclass_id(dev) != UCLASS_POWER_DOMAIN) &&
@@ -600,6 +655,8 @@ int device_probe(struct udevice *dev)
 	ret = device_notify(dev, EVT_DM_POST_PROBE);
 	if (ret)
 		goto fail_event;
+	probe_time_end(dev, &pt);
+	malloc_prof_set_cat(old_cat);
 
 	return 0;
 fail_event:
@@ -609,6 +666,8 @@ fail_uclass:
 			__func__, dev->name);
 	}
 fail:
+	probe_time_end(dev, &pt);
+	malloc_prof_set_cat(old_cat);
 	dev_bic_flags(dev, DM_FLAG_ACTIVATED);
 
 	device_free(dev);
@@ -1180,6 +1239,13 @@ void dev_set_uclass_plat(struct udevice *dev, void *uclass_plat)
 }
 
 #if CONFIG_IS_ENABLED(OF_REAL)
+void dev_set_ofnode(struct udevice *dev, ofnode node)
+{
+	dev->node_ = node;
+	if (dev->uclass)
+		uclass_index_invalidate(dev->uclass);
+}
+
 bool device_is_compatible(const struct udevice *dev, const char *compat)
 {
 	return ofnode_device_is_compatible(dev_ofnode(dev), compat);
@@ -8,6 +8,7 @@
 #include <malloc.h>
 #include <mapmem.h>
 #include <sort.h>
+#include <dm/deps.h>
 #include <dm/root.h>
 #include <dm/util.h>
 #include <dm/uclass-internal.h>
@@ -357,3 +358,66 @@ void dm_dump_mem(struct dm_stats *stats)
 	printf("Drop device name (not SRAM): %x (%d)\n", stats->dev_name_size,
 	       stats->dev_name_size);
 }
+
+#if CONFIG_IS_ENABLED(DM_PROBE_TIMES)
+static int h_cmp_probe_time(const void *d1, const void *d2)
+{
+	const struct udevice *const *dev1 = d1;
+	const struct udevice *const *dev2 = d2;
+	ulong time1 = dev_get_probe_time_us(*dev1);
+	ulong time2 = dev_get_probe_time_us(*dev2);
+
+	if (time1 != time2)
+		return time1 < time2 ? 1 : -1;
+
+	return strcmp((*dev1)->name, (*dev2)->name);
+}
+
+static int add_probed(struct udevice *dev, struct udevice **devs, int count)
+{
+	struct udevice *child;
+
+	if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
+		devs[count++] = dev;
+	device_foreach_child(child, dev)
+		count = add_probed(child, devs, count);
+
+	return count;
+}
+
+void dm_dump_probe_times(void)
+{
+	struct udevice **devs;
+	int dev_count, uclasses;
+	ulong total = 0;
+	int count, i;
+
+	dm_get_stats(&dev_count, &uclasses);
+	devs = calloc(dev_count, sizeof(struct udevice *));
+	if (!devs) {
+		printf("(out of memory)\n");
+		return;
+	}
+	count = add_probed(dm_root(), devs, 0);
+	qsort(devs, count, sizeof(struct udevice *), h_cmp_probe_time);
+
+	printf("    Time  Level  Class       Name\n");
+	printf("--------------------------------------------------\n");
+	for (i = 0; i < count; i++) {
+		struct udevice *dev = devs[i];
+		ulong time = dev_get_probe_time_us(dev);
+		int level = dev_get_dep_level(dev);
+
+		total += time;
+		printf("%8lu  ", time);
+		if (level >= 0)
+			printf("%5d", level);
+		else
+			printf("%5s", "-");
+		printf("  %-10.10s  %s\n", dev->uclass->uc_drv->name, dev->name);
+	}
+	printf("--------------------------------------------------\n");
+	printf("%8lu  us total for %d devices\n", total, count);
+	free(devs);
+}
+#endif
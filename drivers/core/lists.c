@@ -9,8 +9,11 @@
 #define LOG_CATEGORY LOGC_DM
 
 #include <common.h>
+#include <bootstage.h>
 #include <errno.h>
 #include <log.h>
+#include <malloc.h>
+#include <sort.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -18,8 +21,11 @@
 #include <dm/uclass.h>
 #include <dm/util.h>
 #include <fdtdec.h>
+#include <asm/global_data.h>
 #include <linux/compiler.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 struct driver *lists_driver_lookup_name(const char *name)
 {
 	struct driver *drv =
@@ -181,11 +187,134 @@ static int driver_check_compatible(const struct udevice_id *of_match,
 	return -ENOENT;
 }
 
-int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
-		   struct driver *drv, bool pre_reloc_only)
+/**
+ * struct lists_compat - entry in the compatible-string index
+ *
+ * @id:		Entry in the driver's of_match table
+ * @drv:	Driver which has this entry
+ */
+struct lists_compat {
+	const struct udevice_id *id;
+	struct driver *drv;
+};
+
+/**
+ * struct lists_compat_index - drivers indexed by compatible string
+ *
+ * @drivers:	Start of the driver linker list when the index was built, so
+ *		that a stale index from before relocation is never used
+ * @count:	Number of entries
+ * @entry:	Entries, sorted by compatible string and then by linker-list
+ *		order, so the first match is the one a linear search would find
+ */
+struct lists_compat_index {
+	struct driver *drivers;
+	int count;
+	struct lists_compat entry[];
+};
+
+static int lists_compat_cmp(const void *a, const void *b)
+{
+	const struct lists_compat *x = a, *y = b;
+	int ret;
+
+	ret = strcmp(x->id->compatible, y->id->compatible);
+	if (ret)
+		return ret;
+	if (x->drv != y->drv)
+		return x->drv < y->drv ? -1 : 1;
+
+	return x->id < y->id ? -1 : x->id > y->id;
+}
+
+/**
+ * lists_compat_index() - Get the compatible-string index, building it if needed
+ *
+ * Return: index, or NULL if it is not available
+ */
+static struct lists_compat_index *lists_compat_index(void)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct lists_compat_index *idx = gd_dm_compat_index();
+	const struct udevice_id *id;
+	struct driver *entry;
+	int count = 0;
+
+	if (idx && idx->drivers == driver)
+		return idx;
+
+	/* Don't use up the small pre-relocation heap */
+	if (!(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return NULL;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++)
+			count++;
+	}
+	idx = malloc(sizeof(*idx) + count * sizeof(idx->entry[0]));
+	if (!idx) {
+		log_debug("Cannot allocate compatible index\n");
+		return NULL;
+	}
+	idx->drivers = driver;
+	idx->count = 0;
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			idx->entry[idx->count].id = id;
+			idx->entry[idx->count].drv = entry;
+			idx->count++;
+		}
+	}
+	qsort(idx->entry, idx->count, sizeof(idx->entry[0]), lists_compat_cmp);
+	gd_set_dm_compat_index(idx);
+	log_debug("Indexed %d compatible strings\n", idx->count);
+
+	return idx;
+}
+
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp)
 {
 	struct driver *driver = ll_entry_start(struct driver, driver);
 	const int n_ents = ll_entry_count(struct driver, driver);
+	struct lists_compat_index *idx = NULL;
+	struct driver *entry;
+	int lo, hi, mid;
+
+	*idp = NULL;
+	if (CONFIG_IS_ENABLED(DM_COMPAT_INDEX))
+		idx = lists_compat_index();
+	if (idx) {
+		/* find the first entry which is not less than @compat */
+		lo = 0;
+		hi = idx->count;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (strcmp(idx->entry[mid].id->compatible, compat) < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo == idx->count ||
+		    strcmp(idx->entry[lo].id->compatible, compat))
+			return NULL;
+		*idp = idx->entry[lo].id;
+
+		return idx->entry[lo].drv;
+	}
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		if (!driver_check_compatible(entry->of_match, idp, compat))
+			return entry;
+	}
+
+	return NULL;
+}
+
+int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
+		   struct driver *drv, bool pre_reloc_only)
+{
 	const struct udevice_id *id;
 	struct driver *entry;
 	struct udevice *dev;
@@ -223,19 +352,18 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 			  compat);
 
 		id = NULL;
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			if (drv) {
-				if (drv != entry)
-					continue;
-				if (!entry->of_match)
-					break;
-			}
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if (!ret)
-				break;
-		}
-		if (entry == driver + n_ents)
+		if (CONFIG_IS_ENABLED(DM_MATCH_TIME))
+			bootstage_start(BOOTSTAGE_ID_ACCUM_DM_MATCH, "dm_match");
+		if (!drv)
+			entry = lists_driver_lookup_compat(compat, &id);
+		else if (!drv->of_match ||
+			 !driver_check_compatible(drv->of_match, &id, compat))
+			entry = drv;
+		else
+			entry = NULL;
+		if (CONFIG_IS_ENABLED(DM_MATCH_TIME))
+			bootstage_accum(BOOTSTAGE_ID_ACCUM_DM_MATCH);
+		if (!entry)
 			continue;
 
 		if (pre_reloc_only) {
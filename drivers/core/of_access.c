@@ -47,6 +47,24 @@ static struct device_node *of_stdout;
 /* pointer to options given after the alias (separated by :) or NULL if none */
 static const char *of_stdout_options;
 
+/**
+ * struct of_phandle_index - nodes of a live tree indexed by phandle
+ *
+ * @link:	List node to link the structure in of_phandle_indexes list
+ * @root:	Root node of the tree
+ * @count:	Number of entries in @node
+ * @node:	First node with each phandle, in tree order, or NULL if none
+ */
+struct of_phandle_index {
+	struct list_head link;
+	struct device_node *root;
+	uint count;
+	struct device_node *node[];
+};
+
+/* list of struct of_phandle_index, one for each unflattened tree */
+static LIST_HEAD(of_phandle_indexes);
+
 /**
  * struct alias_prop - Alias property in 'aliases' node
  *
@@ -445,14 +463,78 @@ struct device_node *of_find_node_by_prop_value(struct device_node *from,
 	return np;
 }
 
+static struct of_phandle_index *of_phandle_index_find(struct device_node *root)
+{
+	struct of_phandle_index *idx;
+
+	list_for_each_entry(idx, &of_phandle_indexes, link) {
+		if (idx->root == root)
+			return idx;
+	}
+
+	return NULL;
+}
+
+void of_phandle_index_remove(struct device_node *root)
+{
+	struct of_phandle_index *idx = of_phandle_index_find(root);
+
+	if (idx) {
+		list_del(&idx->link);
+		free(idx);
+	}
+}
+
+int of_phandle_index_add(struct device_node *root)
+{
+	struct of_phandle_index *idx;
+	struct device_node *np;
+	phandle max = 0;
+	uint nodes = 0;
+
+	of_phandle_index_remove(root);
+	for (np = root; np; np = of_find_all_nodes(np)) {
+		max = max(max, np->phandle);
+		nodes++;
+	}
+
+	/* dtc allocates phandles in order, so a sparse set is unusual */
+	if (!max || max > nodes * 2 + 16)
+		return 0;
+	idx = calloc(1, sizeof(*idx) + (max + 1) * sizeof(idx->node[0]));
+	if (!idx)
+		return -ENOMEM;
+	idx->root = root;
+	idx->count = max + 1;
+	for (np = root; np; np = of_find_all_nodes(np)) {
+		if (np->phandle && !idx->node[np->phandle])
+			idx->node[np->phandle] = np;
+	}
+	list_add(&idx->link, &of_phandle_indexes);
+
+	return 0;
+}
+
 struct device_node *of_find_node_by_phandle(struct device_node *root,
 					    phandle handle)
 {
+	struct of_phandle_index *idx;
 	struct device_node *np;
 
 	if (!handle)
 		return NULL;
 
+	idx = of_phandle_index_find(root ? root : gd_of_root());
+	if (idx && handle < idx->count) {
+		np = idx->node[handle];
+		/*
+		 * The index may be out of date, so only trust a match. The
+		 * search below skips @root itself
+		 */
+		if (np && np != root && np->phandle == handle)
+			return np;
+	}
+
 	for_each_of_allnodes_from(root, np)
 		if (np->phandle == handle)
 			break;
@@ -1093,6 +1175,11 @@ int of_remove_node(struct device_node *to_remove)
 	else
 		parent->child = np->sibling;
 
+	/* the phandle index may refer to the removed nodes */
+	while (parent->parent)
+		parent = parent->parent;
+	of_phandle_index_remove(parent);
+
 	/*
 	 * don't free it, since if this is an unflattened tree, all the memory
 	 * was alloced in one block; this pointer will be somewhere in the
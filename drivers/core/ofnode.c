@@ -248,6 +248,267 @@ int oftree_new(oftree *treep)
 
 #endif /* OFNODE_MULTI_TREE */
 
+#if CONFIG_IS_ENABLED(OF_LOOKUP_CACHE)
+/* Number of path and subnode lookups to cache, must be a power of two */
+#define OF_CACHE_LOOKUPS	32
+
+/* Parent value for an unused entry in the lookup cache */
+#define OF_CACHE_UNUSED		(-2)
+
+/* Space for a path or subnode name in the cache, longer ones are not cached */
+#define OF_CACHE_KEY_LEN	24
+
+/**
+ * struct ofnode_cache_ent - a cached path or subnode lookup
+ *
+ * @parent: Offset of the parent node for a subnode, -1 for a path, or
+ *	OF_CACHE_UNUSED
+ * @offset: Offset of the node found, or -ve FDT_ERR_... value if none
+ * @key: Path, or subnode name, nul-terminated
+ */
+struct ofnode_cache_ent {
+	int parent;
+	int offset;
+	char key[OF_CACHE_KEY_LEN];
+};
+
+/**
+ * struct ofnode_cache - lookup cache for the control FDT
+ *
+ * The ofnode and fdtdec functions which write to the FDT drop the cache
+ * with ofnode_cache_invalidate(). For other writers, it is also rebuilt
+ * when the size of the FDT's structure block changes, which covers adding,
+ * deleting and resizing nodes and properties, and entries are checked
+ * against the FDT when used.
+ *
+ * @fdt: FDT this cache is for
+ * @struct_size: Size of the FDT structure block when the cache was built,
+ *	or 0 if it must be rebuilt
+ * @full: true if allocated from the full malloc() pool
+ * @size: Number of bytes allocated
+ * @phandle_count: Number of entries in @phandle, 0 if there is no table
+ * @lookup: Path and subnode lookups, indexed by hash
+ * @phandle: Offset of the node for each phandle, -1 if none
+ */
+struct ofnode_cache {
+	const void *fdt;
+	uint struct_size;
+	bool full;
+	uint size;
+	uint phandle_count;
+	struct ofnode_cache_ent lookup[OF_CACHE_LOOKUPS];
+	int phandle[];
+};
+
+/* Marks that the cache could not be allocated from the pre-relocation pool */
+static const struct ofnode_cache ofnode_cache_none;
+
+static struct ofnode_cache *ofnode_cache_build(const void *fdt, bool full)
+{
+	struct ofnode_cache *cache = gd_of_cache();
+	uint max_phandle = 0, count, size, alloc, i;
+	int offset, nodes = 0;
+
+	for (offset = fdt_next_node(fdt, -1, NULL); offset >= 0;
+	     offset = fdt_next_node(fdt, offset, NULL)) {
+		nodes++;
+		max_phandle = max(max_phandle, fdt_get_phandle(fdt, offset));
+	}
+
+	/* dtc allocates phandles in order, so a sparse set is unusual */
+	count = max_phandle + 1;
+	if (!max_phandle || count > nodes * 2 + 16)
+		count = 0;
+	size = sizeof(*cache) + count * sizeof(int);
+	if (!full && size > CONFIG_OF_LOOKUP_CACHE_F_SIZE) {
+		count = 0;
+		size = sizeof(*cache);
+	}
+
+	/*
+	 * Pre-relocation memory cannot be freed, so allocate the largest cache
+	 * allowed there the first time and reuse it for every rebuild
+	 */
+	alloc = full ? size : CONFIG_OF_LOOKUP_CACHE_F_SIZE;
+	if (cache == &ofnode_cache_none)
+		cache = NULL;
+	if (!cache || cache->full != full || cache->size < size) {
+		if (cache && cache->full)
+			free(cache);
+		cache = NULL;
+		if (size <= alloc)
+			cache = malloc(alloc);
+		if (!cache) {
+			gd_set_of_cache(full ? NULL :
+					(struct ofnode_cache *)&ofnode_cache_none);
+			return NULL;
+		}
+		cache->size = alloc;
+		cache->full = full;
+	}
+	cache->fdt = fdt;
+	cache->struct_size = fdt_size_dt_struct(fdt);
+	cache->phandle_count = count;
+	for (i = 0; i < OF_CACHE_LOOKUPS; i++)
+		cache->lookup[i].parent = OF_CACHE_UNUSED;
+	for (i = 0; i < count; i++)
+		cache->phandle[i] = -1;
+	for (offset = fdt_next_node(fdt, -1, NULL); count && offset >= 0;
+	     offset = fdt_next_node(fdt, offset, NULL)) {
+		uint phandle = fdt_get_phandle(fdt, offset);
+
+		if (phandle && cache->phandle[phandle] == -1)
+			cache->phandle[phandle] = offset;
+	}
+	gd_set_of_cache(cache);
+
+	return cache;
+}
+
+/**
+ * ofnode_cache_get() - get the lookup cache for an FDT
+ *
+ * @fdt: FDT to look up
+ * Return: cache, or NULL if @fdt is not the control FDT or there is no memory
+ */
+static struct ofnode_cache *ofnode_cache_get(const void *fdt)
+{
+	struct ofnode_cache *cache = gd_of_cache();
+	bool full = gd->flags & GD_FLG_FULL_MALLOC_INIT;
+
+	if (!fdt || fdt != gd->fdt_blob)
+		return NULL;
+	if (cache == &ofnode_cache_none && !full)
+		return NULL;
+	if (cache && cache->fdt == fdt && cache->full == full &&
+	    cache->struct_size == fdt_size_dt_struct(fdt))
+		return cache;
+
+	return ofnode_cache_build(fdt, full);
+}
+
+void ofnode_cache_invalidate(const void *fdt)
+{
+	struct ofnode_cache *cache = gd_of_cache();
+
+	if (cache && cache != &ofnode_cache_none && cache->fdt == fdt)
+		cache->struct_size = 0;
+}
+
+int ofnode_fdt_phandle_offset(const void *fdt, uint phandle)
+{
+	struct ofnode_cache *cache = ofnode_cache_get(fdt);
+	int offset;
+
+	if (!cache || !phandle || phandle >= cache->phandle_count)
+		return fdt_node_offset_by_phandle(fdt, phandle);
+
+	offset = cache->phandle[phandle];
+	if (offset < 0)
+		return -FDT_ERR_NOTFOUND;
+	if (fdt_get_phandle(fdt, offset) != phandle) {
+		/* The tree was changed in place, so rebuild next time */
+		cache->struct_size = 0;
+		return fdt_node_offset_by_phandle(fdt, phandle);
+	}
+
+	return offset;
+}
+
+/* Check a node name against a path component, as libfdt does */
+static bool ofnode_cache_name_eq(const void *fdt, int offset, const char *name)
+{
+	const char *node_name;
+	int len, name_len;
+
+	node_name = fdt_get_name(fdt, offset, &len);
+	name_len = strlen(name);
+	if (!node_name || len < name_len || memcmp(node_name, name, name_len))
+		return false;
+	if (!node_name[name_len])
+		return true;
+
+	return node_name[name_len] == '@' && !strchr(name, '@');
+}
+
+/* Check that a cached lookup still gives the same node */
+static bool ofnode_cache_check(const void *fdt, int parent, const char *name,
+			       int offset)
+{
+	const char *p;
+
+	if (offset < 0)
+		return true;
+	if (parent != -1)
+		return ofnode_cache_name_eq(fdt, offset, name);
+
+	/*
+	 * The key matched exactly, so an alias can only resolve differently if
+	 * the tree was changed, which drops the cache
+	 */
+	p = strrchr(name, '/');
+	if (!p)
+		return true;
+	if (!p[1])
+		return offset == 0;
+
+	return ofnode_cache_name_eq(fdt, offset, p + 1);
+}
+
+/**
+ * ofnode_cache_lookup() - look up a path or subnode in a flat tree
+ *
+ * @fdt: FDT to search
+ * @parent: Offset of the parent node, or -1 to look up @name as a path
+ * @name: Name of the subnode, or path (which may start with an alias)
+ * Return: offset of the node, or -ve FDT_ERR_... value if not found
+ */
+static int ofnode_cache_lookup(const void *fdt, int parent, const char *name)
+{
+	struct ofnode_cache *cache = ofnode_cache_get(fdt);
+	struct ofnode_cache_ent *ent;
+	const char *p;
+	u32 hash;
+	int offset;
+
+	if (!cache || parent < -1 || strlen(name) >= OF_CACHE_KEY_LEN)
+		goto uncached;
+
+	/* FNV-1a, which only picks the slot */
+	hash = 2166136261U;
+	for (p = name; *p; p++)
+		hash = (hash ^ (u8)*p) * 16777619;
+	ent = &cache->lookup[(hash ^ parent) & (OF_CACHE_LOOKUPS - 1)];
+	if (ent->parent == parent && !strcmp(ent->key, name) &&
+	    ofnode_cache_check(fdt, parent, name, ent->offset))
+		return ent->offset;
+
+	if (parent == -1)
+		offset = fdt_path_offset(fdt, name);
+	else
+		offset = fdt_subnode_offset(fdt, parent, name);
+	ent->parent = parent;
+	ent->offset = offset;
+	strcpy(ent->key, name);
+
+	return offset;
+
+uncached:
+	if (parent == -1)
+		return fdt_path_offset(fdt, name);
+
+	return fdt_subnode_offset(fdt, parent, name);
+}
+#else
+static int ofnode_cache_lookup(const void *fdt, int parent, const char *name)
+{
+	if (parent == -1)
+		return fdt_path_offset(fdt, name);
+
+	return fdt_subnode_offset(fdt, parent, name);
+}
+#endif /* OF_LOOKUP_CACHE */
+
 int oftree_to_fdt(oftree tree, struct abuf *buf)
 {
 	int ret;
@@ -584,7 +845,7 @@ ofnode ofnode_find_subnode(ofnode node, const char *subnode_name)
 		}
 		subnode = np_to_ofnode(np);
 	} else {
-		int ooffset = fdt_subnode_offset(ofnode_to_fdt(node),
+		int ooffset = ofnode_cache_lookup(ofnode_to_fdt(node),
 				ofnode_to_offset(node), subnode_name);
 		subnode = noffset_to_ofnode(node, ooffset);
 	}
@@ -712,8 +973,8 @@ ofnode ofnode_get_by_phandle(uint phandle)
 	if (of_live_active())
 		node = np_to_ofnode(of_find_node_by_phandle(NULL, phandle));
 	else
-		node.of_offset = fdt_node_offset_by_phandle(gd->fdt_blob,
-							    phandle);
+		node.of_offset = ofnode_fdt_phandle_offset(gd->fdt_blob,
+							   phandle);
 
 	return node;
 }
@@ -726,8 +987,8 @@ ofnode oftree_get_by_phandle(oftree tree, uint phandle)
 		node = np_to_ofnode(of_find_node_by_phandle(tree.np, phandle));
 	else
 		node = ofnode_from_tree_offset(tree,
-			fdt_node_offset_by_phandle(oftree_lookup_fdt(tree),
-						   phandle));
+			ofnode_fdt_phandle_offset(oftree_lookup_fdt(tree),
+						  phandle));
 
 	return node;
 }
@@ -945,7 +1206,8 @@ ofnode ofnode_path(const char *path)
 	if (of_live_active())
 		return np_to_ofnode(of_find_node_by_path(path));
 	else
-		return offset_to_ofnode(fdt_path_offset(gd->fdt_blob, path));
+		return offset_to_ofnode(ofnode_cache_lookup(gd->fdt_blob, -1,
+							    path));
 }
 
 ofnode oftree_root(oftree tree)
@@ -965,7 +1227,7 @@ ofnode oftree_path(oftree tree, const char *path)
 	} else if (*path != '/' && tree.fdt != gd->fdt_blob) {
 		return ofnode_null();  /* Aliases only on control FDT */
 	} else {
-		int offset = fdt_path_offset(tree.fdt, path);
+		int offset = ofnode_cache_lookup(tree.fdt, -1, path);
 
 		return ofnode_from_tree_offset(tree, offset);
 	}
@@ -1622,6 +1884,7 @@ int ofnode_write_prop(ofnode node, const char *propname, const void *value,
 			free(newval);
 		return ret;
 	} else {
+		ofnode_cache_invalidate(ofnode_to_fdt(node));
 		return fdt_setprop(ofnode_to_fdt(node), ofnode_to_offset(node),
 				   propname, value, len);
 	}
@@ -1686,6 +1949,7 @@ int ofnode_delete_prop(ofnode node, const char *propname)
 			return of_remove_property(ofnode_to_np(node), prop);
 		return 0;
 	} else {
+		ofnode_cache_invalidate(ofnode_to_fdt(node));
 		return fdt_delprop(ofnode_to_fdt(node), ofnode_to_offset(node),
 				   propname);
 	}
@@ -1857,6 +2121,7 @@ int ofnode_add_subnode(ofnode node, const char *name, ofnode *subnodep)
 		int poffset = ofnode_to_offset(node);
 		int offset;
 
+		ofnode_cache_invalidate(fdt);
 		offset = fdt_add_subnode(fdt, poffset, name);
 		if (offset == -FDT_ERR_EXISTS) {
 			offset = fdt_subnode_offset(fdt, poffset, name);
@@ -1884,6 +2149,7 @@ int ofnode_delete(ofnode *nodep)
 		void *fdt = ofnode_to_fdt(node);
 		int offset = ofnode_to_offset(node);
 
+		ofnode_cache_invalidate(fdt);
 		ret = fdt_del_node(fdt, offset);
 		if (ret)
 			ret = -EFAULT;
@@ -17,6 +17,7 @@
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
 #include <dm/acpi.h>
+#include <dm/deps.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -100,6 +101,7 @@ int dm_init(bool of_live)
 		dm_warn("Virtual root driver already exists!\n");
 		return -EINVAL;
 	}
+	uclass_table_reset();
 	if (CONFIG_IS_ENABLED(OF_PLATDATA_INST)) {
 		gd->uclass_root = &uclass_head;
 	} else {
@@ -293,7 +295,7 @@ static int dm_probe_devices(struct udevice *dev, bool pre_reloc_only)
 		goto probe_children;
 
 	if (dev_get_flags(dev) & DM_FLAG_PROBE_AFTER_BIND) {
-		ret = device_probe(dev);
+		ret = device_probe_deps(dev);
 		if (ret)
 			return ret;
 	}
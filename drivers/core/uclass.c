@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <log.h>
 #include <malloc.h>
+#include <sort.h>
 #include <asm/global_data.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
@@ -23,20 +24,246 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+/**
+ * struct uclass_node_ent - entry in the ofnode index of a uclass
+ *
+ * @node: ofnode of the device
+ * @pos: Position of the device in the uclass, so that the first device with
+ *	a given ofnode is found, as with a search of the list
+ * @dev: Device
+ */
+struct uclass_node_ent {
+	ofnode node;
+	int pos;
+	struct udevice *dev;
+};
+
+/**
+ * struct uclass_index - arrays of the devices in a uclass
+ *
+ * This is allocated in one block, with the arrays following the header. It
+ * is kept when the uclass changes and reused if it is large enough.
+ *
+ * @valid: true if the arrays match the device list
+ * @size: Number of bytes allocated
+ * @dev_count: Number of devices in the uclass
+ * @seq_count: Number of entries in @seq, or -1 if the sequence numbers are
+ *	too sparse to index
+ * @node_count: Number of entries in @node
+ * @node: Devices with a valid ofnode, sorted by ofnode
+ * @dev: Devices in the order of the uclass list
+ * @seq: Device for each sequence number, or NULL if none
+ */
+struct uclass_index {
+	bool valid;
+	int size;
+	int dev_count;
+	int seq_count;
+	int node_count;
+	struct uclass_node_ent *node;
+	struct udevice **dev;
+	struct udevice **seq;
+};
+
+/* Get the uclass table, allocating it once the full malloc() is available */
+static struct dm_uclass_table *uclass_table(void)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+
+	if (!tbl && (gd->flags & GD_FLG_FULL_MALLOC_INIT)) {
+		tbl = calloc(1, sizeof(*tbl));
+		gd_set_dm_uclass_table(tbl);
+	}
+
+	return tbl;
+}
+
+/* Record a search which could not use an index */
+static void uclass_count_walk(void)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+
+	if (tbl)
+		tbl->walks++;
+}
+
+static int uclass_node_cmp(const void *a, const void *b)
+{
+	const struct uclass_node_ent *ea = a, *eb = b;
+
+	if (ea->node.of_offset != eb->node.of_offset)
+		return ea->node.of_offset < eb->node.of_offset ? -1 : 1;
+
+	return ea->pos - eb->pos;
+}
+
+void uclass_index_invalidate(struct uclass *uc)
+{
+	if (uc->idx_)
+		uc->idx_->valid = false;
+}
+
+/**
+ * uclass_index() - Get the device index for a uclass
+ *
+ * This builds the index if the uclass has changed since it was last used.
+ *
+ * @uc: uclass to check
+ * Return: index, or NULL if there is none (e.g. before relocation)
+ */
+static struct uclass_index *uclass_index(struct uclass *uc)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+	struct uclass_index *idx = uc->idx_;
+	int count = 0, nodes = 0, max_seq = -1;
+	int seq_count, size, pos;
+	struct udevice *dev;
+
+	if (idx && idx->valid)
+		return idx;
+	if (!tbl)
+		return NULL;
+
+	tbl->walks++;
+	uclass_foreach_dev(dev, uc) {
+		count++;
+		if (ofnode_valid(dev_ofnode(dev)))
+			nodes++;
+		if (dev->seq_ > max_seq)
+			max_seq = dev->seq_;
+	}
+
+	/* Sequence numbers are normally dense, but aliases can be anything */
+	seq_count = max_seq + 1;
+	if (seq_count > count * 2 + 8)
+		seq_count = -1;
+
+	size = sizeof(*idx) + nodes * sizeof(struct uclass_node_ent) +
+		(count + max(seq_count, 0)) * sizeof(struct udevice *);
+	if (!idx || idx->size < size) {
+		free(idx);
+		idx = malloc(size);
+		uc->idx_ = idx;
+		if (!idx)
+			return NULL;
+		idx->size = size;
+	}
+	idx->dev_count = count;
+	idx->seq_count = seq_count;
+	idx->node_count = nodes;
+	idx->node = (struct uclass_node_ent *)(idx + 1);
+	idx->dev = (struct udevice **)(idx->node + nodes);
+	idx->seq = idx->dev + count;
+	if (seq_count > 0)
+		memset(idx->seq, '\0', seq_count * sizeof(struct udevice *));
+
+	pos = 0;
+	nodes = 0;
+	uclass_foreach_dev(dev, uc) {
+		if (ofnode_valid(dev_ofnode(dev))) {
+			idx->node[nodes].node = dev_ofnode(dev);
+			idx->node[nodes].pos = pos;
+			idx->node[nodes].dev = dev;
+			nodes++;
+		}
+		if (dev->seq_ >= 0 && dev->seq_ < seq_count &&
+		    !idx->seq[dev->seq_])
+			idx->seq[dev->seq_] = dev;
+		idx->dev[pos++] = dev;
+	}
+	qsort(idx->node, nodes, sizeof(struct uclass_node_ent),
+	      uclass_node_cmp);
+	idx->valid = true;
+
+	return idx;
+}
+
+/* Find the first device with a given ofnode, or NULL if none */
+static struct udevice *uclass_index_find_node(struct uclass_index *idx,
+					      ofnode node)
+{
+	int lo = 0, hi = idx->node_count;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+
+		if (idx->node[mid].node.of_offset < node.of_offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo < idx->node_count && ofnode_equal(idx->node[lo].node, node))
+		return idx->node[lo].dev;
+
+	return NULL;
+}
+
+/* Drop a uclass which is being destroyed from the indexes */
+static void uclass_index_remove(struct uclass *uc)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+
+	free(uc->idx_);
+	uc->idx_ = NULL;
+	if (tbl && tbl->uc[uc->uc_drv->id] == uc)
+		tbl->uc[uc->uc_drv->id] = NULL;
+}
+
+void uclass_table_reset(void)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+
+	if (tbl)
+		memset(tbl->uc, '\0', sizeof(tbl->uc));
+}
+#else
+struct uclass_index {
+	int dev_count;
+	int seq_count;
+	struct udevice **dev;
+	struct udevice **seq;
+};
+
+static struct dm_uclass_table *uclass_table(void)
+{
+	return NULL;
+}
+
+static void uclass_count_walk(void) {}
+
+static struct uclass_index *uclass_index(struct uclass *uc)
+{
+	return NULL;
+}
+
+static struct udevice *uclass_index_find_node(struct uclass_index *idx,
+					      ofnode node)
+{
+	return NULL;
+}
+
+static void uclass_index_remove(struct uclass *uc) {}
+#endif
+
 struct uclass *uclass_find(enum uclass_id key)
 {
+	struct dm_uclass_table *tbl;
 	struct uclass *uc;
 
 	if (!gd->dm_root)
 		return NULL;
-	/*
-	 * TODO(sjg@chromium.org): Optimise this, perhaps moving the found
-	 * node to the start of the list, or creating a linear array mapping
-	 * id to node.
-	 */
+	tbl = uclass_table();
+	if (tbl && key >= 0 && key < UCLASS_COUNT && tbl->uc[key])
+		return tbl->uc[key];
+
+	uclass_count_walk();
 	list_for_each_entry(uc, gd->uclass_root, sibling_node) {
-		if (uc->uc_drv->id == key)
+		if (uc->uc_drv->id == key) {
+			if (tbl && key >= 0 && key < UCLASS_COUNT)
+				tbl->uc[key] = uc;
 			return uc;
+		}
 	}
 
 	return NULL;
@@ -102,6 +329,7 @@ fail:
 		uclass_set_priv(uc, NULL);
 	}
 	list_del(&uc->sibling_node);
+	uclass_index_remove(uc);
 fail_mem:
 	free(uc);
 
@@ -135,6 +363,7 @@ int uclass_destroy(struct uclass *uc)
 	if (uc_drv->destroy)
 		uc_drv->destroy(uc);
 	list_del(&uc->sibling_node);
+	uclass_index_remove(uc);
 	if (uc_drv->priv_auto)
 		free(uclass_get_priv(uc));
 	free(uc);
@@ -223,6 +452,7 @@ int dev_get_uclass_index(struct udevice *dev, struct uclass **ucp)
 
 int uclass_find_device(enum uclass_id id, int index, struct udevice **devp)
 {
+	struct uclass_index *idx;
 	struct uclass *uc;
 	struct udevice *dev;
 	int ret;
@@ -234,6 +464,15 @@ int uclass_find_device(enum uclass_id id, int index, struct udevice **devp)
 	if (list_empty(&uc->dev_head))
 		return -ENODEV;
 
+	idx = uclass_index(uc);
+	if (idx) {
+		if (index < 0 || index >= idx->dev_count)
+			return -ENODEV;
+		*devp = idx->dev[index];
+		return 0;
+	}
+
+	uclass_count_walk();
 	uclass_foreach_dev(dev, uc) {
 		if (!index--) {
 			*devp = dev;
@@ -330,6 +569,7 @@ int uclass_find_next_free_seq(struct uclass *uc)
 
 int uclass_find_device_by_seq(enum uclass_id id, int seq, struct udevice **devp)
 {
+	struct uclass_index *idx;
 	struct uclass *uc;
 	struct udevice *dev;
 	int ret;
@@ -342,6 +582,15 @@ int uclass_find_device_by_seq(enum uclass_id id, int seq, struct udevice **devp)
 	if (ret)
 		return ret;
 
+	idx = uclass_index(uc);
+	if (idx && idx->seq_count >= 0) {
+		if (seq < 0 || seq >= idx->seq_count || !idx->seq[seq])
+			return -ENODEV;
+		*devp = idx->seq[seq];
+		return 0;
+	}
+
+	uclass_count_walk();
 	uclass_foreach_dev(dev, uc) {
 		log_debug("   - %d '%s'\n", dev->seq_, dev->name);
 		if (dev->seq_ == seq) {
@@ -382,6 +631,7 @@ int uclass_find_device_by_of_offset(enum uclass_id id, int node,
 int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 				 struct udevice **devp)
 {
+	struct uclass_index *idx;
 	struct uclass *uc;
 	struct udevice *dev;
 	int ret;
@@ -394,6 +644,14 @@ int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 	if (ret)
 		return ret;
 
+	idx = uclass_index(uc);
+	if (idx) {
+		*devp = uclass_index_find_node(idx, node);
+		ret = *devp ? 0 : -ENODEV;
+		goto done;
+	}
+
+	uclass_count_walk();
 	uclass_foreach_dev(dev, uc) {
 		log(LOGC_DM, LOGL_DEBUG_CONTENT, "      - checking %s\n",
 		    dev->name);
@@ -694,6 +952,8 @@ int uclass_bind_device(struct udevice *dev)
 
 	uc = dev->uclass;
 	list_add_tail(&dev->uclass_node, &uc->dev_head);
+	/* This also covers child_post_bind() changing the ofnode */
+	uclass_index_invalidate(uc);
 
 	if (dev->parent) {
 		struct uclass_driver *uc_drv = dev->parent->uclass->uc_drv;
@@ -709,6 +969,7 @@ int uclass_bind_device(struct udevice *dev)
 err:
 	/* There is no need to undo the parent's post_bind call */
 	list_del(&dev->uclass_node);
+	uclass_index_invalidate(uc);
 
 	return ret;
 }
@@ -732,6 +993,7 @@ int uclass_pre_unbind_device(struct udevice *dev)
 int uclass_unbind_device(struct udevice *dev)
 {
 	list_del(&dev->uclass_node);
+	uclass_index_invalidate(dev->uclass);
 
 	return 0;
 }
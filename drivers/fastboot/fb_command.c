@@ -11,6 +11,8 @@
 #include <fastboot-internal.h>
 #include <fb_mmc.h>
 #include <fb_nand.h>
+#include <log.h>
+#include <malloc.h>
 #include <part.h>
 #include <stdlib.h>
 #include <linux/printk.h>
@@ -142,8 +144,11 @@ int fastboot_handle_command(char *cmd_string, char *response)
 	for (i = 0; i < FASTBOOT_COMMAND_COUNT; i++) {
 		if (!strcmp(commands[i].command, cmd_string)) {
 			if (commands[i].dispatch) {
+				int old_cat = malloc_prof_set_cat(LOGC_FASTBOOT);
+
 				commands[i].dispatch(cmd_parameter,
 							response);
+				malloc_prof_set_cat(old_cat);
 				return i;
 			} else {
 				pr_err("command %s not supported.\n", cmd_string);
@@ -34,6 +34,7 @@
 #include <linux/bug.h>
 #include <linux/log2.h>
 #include <linux/printk.h>
+#include <bootstage.h>
 #endif
 #include <linux/err.h>
 #include <ubi_uboot.h>
@@ -958,7 +959,8 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 		UBI_FM_MIN_POOL_SIZE);
 
 	ubi->fm_wl_pool.max_size = ubi->fm_pool.max_size / 2;
-	ubi->fm_disabled = !fm_autoconvert;
+	ubi->fm_disabled = !fm_autoconvert &&
+			   !IS_ENABLED(CONFIG_MTD_UBI_FASTMAP_PERSIST);
 	if (fm_debug)
 		ubi_enable_dbg_chk_fastmap(ubi);
 
@@ -998,8 +1000,14 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 	ubi->fm_buf = vzalloc(ubi->fm_size);
 	if (!ubi->fm_buf)
 		goto out_free;
+#endif
+#ifdef __UBOOT__
+	bootstage_start(BOOTSTAGE_ID_ACCUM_UBI_ATTACH, "ubi_attach");
 #endif
 	err = ubi_attach(ubi, 0);
+#ifdef __UBOOT__
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_UBI_ATTACH);
+#endif
 	if (err) {
 		ubi_err(ubi, "failed to attach mtd%d, error %d",
 			mtd->index, err);
@@ -1012,6 +1020,19 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 			goto out_detach;
 	}
 
+#ifdef CONFIG_MTD_UBI_FASTMAP_PERSIST
+	/*
+	 * The device had to be attached by scanning, so write a fastmap right
+	 * away rather than only at detach time, which may never happen before
+	 * the OS is booted. The next attach then only has to read it.
+	 */
+	if (!ubi->fm && !ubi->fm_disabled && !ubi->ro_mode) {
+		err = ubi_update_fastmap(ubi);
+		if (err)
+			ubi_warn(ubi, "unable to write a fastmap: %d", err);
+	}
+#endif
+
 	err = uif_init(ubi, &ref);
 	if (err)
 		goto out_detach;
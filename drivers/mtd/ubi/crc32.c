@@ -26,6 +26,8 @@
 #include <linux/module.h>
 #include <linux/compiler.h>
 #include <u-boot/crc.h>
+#else
+#include <u-boot/crc.h>
 #endif
 #include <linux/types.h>
 
@@ -61,7 +63,16 @@ MODULE_LICENSE("GPL");
  */
 u32  crc32_le(u32 crc, unsigned char const *p, size_t len);
 
-#if CRC_LE_BITS == 1
+#ifdef __UBOOT__
+/*
+ * This is the same CRC as crc32_no_comp(), which has word-wide and CRC
+ * instruction implementations, so use that.
+ */
+u32 crc32_le(u32 crc, unsigned char const *p, size_t len)
+{
+	return crc32_no_comp(crc, p, len);
+}
+#elif CRC_LE_BITS == 1
 /*
  * In fact, the table-based code will work in this case, but it can be
  * simplified by inlining the table in ?: form.
@@ -16,6 +16,7 @@
 #include <common.h>
 #include <dm.h>
 #include <mux-internal.h>
+#include <dm/deps.h>
 #include <dm/device-internal.h>
 #include <dm/device_compat.h>
 #include <dm/devres.h>
@@ -319,7 +320,7 @@ int dm_mux_init(void)
 	}
 	uclass_foreach_dev(dev, uc) {
 		if (dev_read_bool(dev, "u-boot,mux-autoprobe")) {
-			ret = device_probe(dev);
+			ret = device_probe_boot(dev);
 			if (ret)
 				log_debug("unable to probe device %s\n",
 					  dev->name);
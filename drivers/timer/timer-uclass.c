@@ -10,6 +10,7 @@
 #include <cpu.h>
 #include <dm.h>
 #include <asm/global_data.h>
+#include <dm/deps.h>
 #include <dm/lists.h>
 #include <dm/device_compat.h>
 #include <dm/device-internal.h>
@@ -150,7 +151,7 @@ int dm_timer_init(void)
 			 * relocation, bind it anyway.
 			 */
 			if (!lists_bind_fdt(dm_root(), node, &dev, NULL, false)) {
-				ret = device_probe(dev);
+				ret = device_probe_boot(dev);
 				if (ret)
 					return ret;
 			}
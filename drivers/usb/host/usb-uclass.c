@@ -15,6 +15,7 @@
 #include <log.h>
 #include <memalign.h>
 #include <usb.h>
+#include <dm/deps.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <dm/uclass-internal.h>
@@ -327,7 +328,7 @@ int usb_init(void)
 			}
 		}
 
-		ret = device_probe(bus);
+		ret = device_probe_boot(bus);
 		if (ret == -ENODEV) {	/* No such device. */
 			puts("Port not available.\n");
 			controllers_initialized++;
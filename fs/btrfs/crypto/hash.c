@@ -7,7 +7,7 @@
 #include <u-boot/blake2.h>
 #include <u-boot/crc.h>
 
-static u32 btrfs_crc32c_table[256];
+static u32 btrfs_crc32c_table[CRC32C_TABLE_SIZE];
 
 void btrfs_hash_init(void)
 {
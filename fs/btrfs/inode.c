@@ -408,6 +408,188 @@ out:
 	return ret;
 }
 
+/*
+ * Maximum number of sectors whose checksums are fetched from the csum tree in
+ * one go when verifying data.
+ */
+#define BTRFS_CSUM_BATCH_SECTORS	256
+
+/*
+ * Fetch the data checksums for @nr_sectors sectors starting at logical
+ * bytenr @start from the csum tree.
+ *
+ * Checksums are stored into @csums, and @present[i] is set for each sector
+ * which has a checksum (sectors of NODATASUM inodes have none).
+ *
+ * Return 0 on success.
+ * Return <0 for error.
+ */
+static int lookup_data_csums(struct btrfs_fs_info *fs_info, u64 start,
+			     u32 nr_sectors, u8 *csums, u8 *present)
+{
+	struct btrfs_root *csum_root = fs_info->csum_root;
+	u16 csum_size = btrfs_super_csum_size(fs_info->super_copy);
+	u32 sectorsize = fs_info->sectorsize;
+	u64 end = start + (u64)nr_sectors * sectorsize;
+	struct extent_buffer *leaf;
+	struct btrfs_path path;
+	struct btrfs_key key;
+	int ret;
+
+	memset(present, 0, nr_sectors);
+	btrfs_init_path(&path);
+
+	key.objectid = BTRFS_EXTENT_CSUM_OBJECTID;
+	key.type = BTRFS_EXTENT_CSUM_KEY;
+	key.offset = start;
+	ret = btrfs_search_slot(NULL, csum_root, &key, &path, 0, 0);
+	if (ret < 0)
+		goto out;
+	/* A csum item starting before @start can still cover it */
+	if (ret > 0) {
+		ret = btrfs_previous_item(csum_root, &path,
+					  BTRFS_EXTENT_CSUM_OBJECTID,
+					  BTRFS_EXTENT_CSUM_KEY);
+		if (ret < 0)
+			goto out;
+	}
+
+	while (1) {
+		u64 item_end;
+		u64 cur_start;
+		u64 cur_end;
+
+		leaf = path.nodes[0];
+		if (path.slots[0] >= btrfs_header_nritems(leaf))
+			goto next;
+		btrfs_item_key_to_cpu(leaf, &key, path.slots[0]);
+		if (key.objectid != BTRFS_EXTENT_CSUM_OBJECTID ||
+		    key.type != BTRFS_EXTENT_CSUM_KEY)
+			goto next;
+		if (key.offset >= end)
+			break;
+
+		item_end = key.offset + (u64)btrfs_item_size_nr(leaf,
+				path.slots[0]) / csum_size * sectorsize;
+		if (item_end <= start)
+			goto next;
+
+		cur_start = max(key.offset, start);
+		cur_end = min(item_end, end);
+		read_extent_buffer(leaf,
+			csums + (cur_start - start) / sectorsize * csum_size,
+			btrfs_item_ptr_offset(leaf, path.slots[0]) +
+			(cur_start - key.offset) / sectorsize * csum_size,
+			(cur_end - cur_start) / sectorsize * csum_size);
+		memset(present + (cur_start - start) / sectorsize, 1,
+		       (cur_end - cur_start) / sectorsize);
+next:
+		ret = btrfs_next_item(csum_root, &path);
+		if (ret)
+			break;
+	}
+	if (ret > 0)
+		ret = 0;
+out:
+	btrfs_release_path(&path);
+	return ret;
+}
+
+/*
+ * Verify the data read from logical bytenr @logical against the csum tree.
+ *
+ * The checksums are fetched in batches of BTRFS_CSUM_BATCH_SECTORS, rather
+ * than searching the csum tree once per sector.
+ *
+ * Return 0 if all checksums which exist match.
+ * Return -EIO for a mismatch, and <0 for other errors.
+ */
+static int verify_data_csums(struct btrfs_fs_info *fs_info, u64 logical,
+			     const char *data, u64 len)
+{
+	u16 csum_type = btrfs_super_csum_type(fs_info->super_copy);
+	u16 csum_size = btrfs_super_csum_size(fs_info->super_copy);
+	u32 sectorsize = fs_info->sectorsize;
+	u8 result[BTRFS_CSUM_SIZE];
+	u8 *present;
+	u8 *csums;
+	u64 cur;
+	int ret = 0;
+
+	ASSERT(IS_ALIGNED(logical, sectorsize) && IS_ALIGNED(len, sectorsize));
+
+	csums = malloc(BTRFS_CSUM_BATCH_SECTORS * csum_size);
+	present = malloc(BTRFS_CSUM_BATCH_SECTORS);
+	if (!csums || !present) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (cur = 0; cur < len;
+	     cur += (u64)BTRFS_CSUM_BATCH_SECTORS * sectorsize) {
+		u32 nr_sectors = min_t(u64, BTRFS_CSUM_BATCH_SECTORS,
+				       (len - cur) / sectorsize);
+		u32 i;
+
+		ret = lookup_data_csums(fs_info, logical + cur, nr_sectors,
+					csums, present);
+		if (ret < 0)
+			goto out;
+
+		for (i = 0; i < nr_sectors; i++) {
+			u64 off = cur + (u64)i * sectorsize;
+
+			if (!present[i])
+				continue;
+			btrfs_csum_data(csum_type, (u8 *)data + off, result,
+					sectorsize);
+			if (memcmp(result, csums + i * csum_size, csum_size)) {
+				error("csum mismatch at logical %llu",
+				      logical + off);
+				ret = -EIO;
+				goto out;
+			}
+		}
+	}
+out:
+	free(csums);
+	free(present);
+	return ret;
+}
+
+/*
+ * Read @len bytes at logical bytenr @logical into @dest, trying each mirror
+ * until one is read completely and passes data checksum verification.
+ *
+ * Return 0 on success.
+ * Return <0 for error.
+ */
+static int read_data_range(struct btrfs_fs_info *fs_info, u64 logical,
+			   u64 len, char *dest)
+{
+	int num_copies;
+	u64 read;
+	int ret = -EIO;
+	int i;
+
+	num_copies = btrfs_num_copies(fs_info, logical, len);
+	for (i = 1; i <= num_copies; i++) {
+		read = len;
+		ret = read_extent_data(fs_info, dest, logical, &read, i);
+		if (ret < 0 || read != len) {
+			ret = -EIO;
+			continue;
+		}
+		if (IS_ENABLED(CONFIG_FS_BTRFS_DATA_CSUM)) {
+			ret = verify_data_csums(fs_info, logical, dest, len);
+			if (ret == -EIO)
+				continue;
+		}
+		break;
+	}
+	return ret;
+}
+
 /*
  * Read out regular extent.
  *
@@ -426,14 +608,10 @@ int btrfs_read_extent_reg(struct btrfs_path *path,
 	struct btrfs_key key;
 	u64 extent_num_bytes;
 	u64 disk_bytenr;
-	u64 read;
 	char *cbuf = NULL;
 	char *dbuf = NULL;
 	u32 csize;
 	u32 dsize;
-	bool finished = false;
-	int num_copies;
-	int i;
 	int slot = path->slots[0];
 	int ret;
 
@@ -457,25 +635,16 @@ int btrfs_read_extent_reg(struct btrfs_path *path,
 		logical = btrfs_file_extent_disk_bytenr(leaf, fi) +
 			  btrfs_file_extent_offset(leaf, fi) +
 			  offset - key.offset;
-		read = len;
 
-		num_copies = btrfs_num_copies(fs_info, logical, len);
-		for (i = 1; i <= num_copies; i++) {
-			ret = read_extent_data(fs_info, dest, logical, &read, i);
-			if (ret < 0 || read != len)
-				continue;
-			finished = true;
-			break;
-		}
-		if (!finished)
-			return -EIO;
+		ret = read_data_range(fs_info, logical, len, dest);
+		if (ret < 0)
+			return ret;
 		return len;
 	}
 
 	csize = btrfs_file_extent_disk_num_bytes(leaf, fi);
 	dsize = btrfs_file_extent_ram_bytes(leaf, fi);
 	disk_bytenr = btrfs_file_extent_disk_bytenr(leaf, fi);
-	num_copies = btrfs_num_copies(fs_info, disk_bytenr, csize);
 
 	cbuf = malloc_cache_aligned(csize);
 	dbuf = malloc_cache_aligned(dsize);
@@ -484,19 +653,9 @@ int btrfs_read_extent_reg(struct btrfs_path *path,
 		goto out;
 	}
 	/* For compressed extent, we must read the whole on-disk extent */
-	for (i = 1; i <= num_copies; i++) {
-		read = csize;
-		ret = read_extent_data(fs_info, cbuf, disk_bytenr,
-				       &read, i);
-		if (ret < 0 || read != csize)
-			continue;
-		finished = true;
-		break;
-	}
-	if (!finished) {
-		ret = -EIO;
+	ret = read_data_range(fs_info, disk_bytenr, csize, cbuf);
+	if (ret < 0)
 		goto out;
-	}
 
 	ret = btrfs_decompress(btrfs_file_extent_compression(leaf, fi), cbuf,
 			       csize, dbuf, dsize);
@@ -657,6 +816,71 @@ static int read_and_truncate_page(struct btrfs_path *path,
 	return len;
 }
 
+/*
+ * Read the uncompressed regular extent @path points to, starting from file
+ * offset @cur, together with any following file extents which are physically
+ * contiguous with it, using a single device read.
+ *
+ * Reading stops at @end, which must be sectorsize aligned. The number of
+ * bytes read is returned in @read_len.
+ * @path is left pointing at the last file extent which was read, or beyond it.
+ *
+ * Return 0 on success.
+ * Return <0 for error.
+ */
+static int read_contiguous_extents(struct btrfs_root *root,
+				   struct btrfs_path *path, u64 ino, u64 cur,
+				   u64 end, char *dest, u64 *read_len)
+{
+	struct btrfs_fs_info *fs_info = root->fs_info;
+	struct btrfs_file_extent_item *fi;
+	struct extent_buffer *leaf;
+	struct btrfs_key key;
+	u64 logical;
+	u64 len;
+	int ret;
+
+	leaf = path->nodes[0];
+	fi = btrfs_item_ptr(leaf, path->slots[0],
+			    struct btrfs_file_extent_item);
+	btrfs_item_key_to_cpu(leaf, &key, path->slots[0]);
+	logical = btrfs_file_extent_disk_bytenr(leaf, fi) +
+		  btrfs_file_extent_offset(leaf, fi) + cur - key.offset;
+	len = min(key.offset + btrfs_file_extent_num_bytes(leaf, fi), end) -
+	      cur;
+
+	while (cur + len < end) {
+		ret = btrfs_next_item(root, path);
+		if (ret < 0)
+			return ret;
+		if (ret > 0)
+			break;
+
+		leaf = path->nodes[0];
+		btrfs_item_key_to_cpu(leaf, &key, path->slots[0]);
+		if (key.objectid != ino || key.type != BTRFS_EXTENT_DATA_KEY ||
+		    key.offset != cur + len)
+			break;
+		fi = btrfs_item_ptr(leaf, path->slots[0],
+				    struct btrfs_file_extent_item);
+		if (btrfs_file_extent_type(leaf, fi) != BTRFS_FILE_EXTENT_REG ||
+		    btrfs_file_extent_compression(leaf, fi) !=
+		    BTRFS_COMPRESS_NONE ||
+		    btrfs_file_extent_disk_bytenr(leaf, fi) == 0 ||
+		    btrfs_file_extent_disk_bytenr(leaf, fi) +
+		    btrfs_file_extent_offset(leaf, fi) != logical + len)
+			break;
+		len += min(btrfs_file_extent_num_bytes(leaf, fi),
+			   end - key.offset);
+	}
+
+	ret = read_data_range(fs_info, logical, len, dest);
+	if (ret < 0)
+		return ret;
+	*read_len = len;
+	return 0;
+}
+
 int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 		    char *dest)
 {
@@ -744,6 +968,19 @@ int btrfs_file_read(struct btrfs_root *root, u64 ino, u64 file_offset, u64 len,
 		/* Read the remaining part of the extent */
 		extent_num_bytes = btrfs_file_extent_num_bytes(path.nodes[0],
 							       fi);
+		if (btrfs_file_extent_compression(path.nodes[0], fi) ==
+		    BTRFS_COMPRESS_NONE) {
+			u64 read_len;
+
+			ret = read_contiguous_extents(root, &path, ino, cur,
+						      aligned_end,
+						      dest + cur - file_offset,
+						      &read_len);
+			if (ret < 0)
+				goto out;
+			cur += read_len;
+			continue;
+		}
 		ret = btrfs_read_extent_reg(&path, fi, cur,
 				min(extent_num_bytes, aligned_end - cur),
 				dest + cur - file_offset);
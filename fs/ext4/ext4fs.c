@@ -241,22 +241,35 @@ int ext4fs_probe(struct blk_desc *fs_dev_desc,
 	return 0;
 }
 
+int ext4_open_file(const char *filename, loff_t *size)
+{
+	if (ext4fs_open(filename, size) < 0) {
+		printf("** File not found %s **\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
+
+int ext4_pread_file(void *buf, loff_t offset, loff_t len, loff_t *actread)
+{
+	return ext4fs_read(buf, offset, len, actread);
+}
+
 int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 		   loff_t *len_read)
 {
 	loff_t file_len;
 	int ret;
 
-	ret = ext4fs_open(filename, &file_len);
-	if (ret < 0) {
-		printf("** File not found %s **\n", filename);
-		return -1;
-	}
+	ret = ext4_open_file(filename, &file_len);
+	if (ret)
+		return ret;
 
 	if (len == 0)
 		len = file_len;
 
-	return ext4fs_read(buf, offset, len, len_read);
+	return ext4_pread_file(buf, offset, len, len_read);
 }
 
 int ext4fs_uuid(char *uuid_str)
@@ -38,6 +38,10 @@ static struct blk_desc *fs_dev_desc;
 static int fs_dev_part;
 static struct disk_partition fs_partition;
 static int fs_type = FS_TYPE_ANY;
+/* Sequence number given to each mount kept for a file handle */
+static uint fs_mount_seq;
+/* Sequence number of the mount kept for a file handle, 0 if none */
+static uint fs_file_mount;
 
 void fs_set_type(int type)
 {
@@ -161,6 +165,16 @@ struct fstype_info {
 	int (*size)(const char *filename, loff_t *size);
 	int (*read)(const char *filename, void *buf, loff_t offset,
 		    loff_t len, loff_t *actread);
+	/*
+	 * Optional: look up a file and keep it as the filesystem's current
+	 * file, returning its size. While the filesystem stays mounted,
+	 * .file_pread() then reads from it without resolving the path
+	 * again. See fs_file_open().
+	 */
+	int (*file_open)(const char *filename, loff_t *size);
+	/* Read from the file opened by .file_open(), see fs_file_pread() */
+	int (*file_pread)(void *buf, loff_t offset, loff_t len,
+			  loff_t *actread);
 	int (*write)(const char *filename, void *buf, loff_t offset,
 		     loff_t len, loff_t *actwrite);
 	void (*close)(void);
@@ -224,6 +238,8 @@ static struct fstype_info fstypes[] = {
 		.exists = ext4fs_exists,
 		.size = ext4fs_size,
 		.read = ext4_read_file,
+		.file_open = ext4_open_file,
+		.file_pread = ext4_pread_file,
 #ifdef CONFIG_CMD_EXT4_WRITE
 		.write = ext4_write_file,
 		.ln = ext4fs_create_link,
@@ -423,6 +439,10 @@ int fs_set_blk_dev(const char *ifname, const char *dev_part_str, int fstype)
 	struct fstype_info *info;
 	int part, i;
 
+	/* Drop the filesystem kept mounted for an open file handle */
+	if (fs_file_mount)
+		fs_close();
+
 	part = part_get_info_by_dev_and_name_or_num(ifname, dev_part_str, &fs_dev_desc,
 						    &fs_partition, 1);
 	if (part < 0)
@@ -452,6 +472,10 @@ int fs_set_blk_dev_with_part(struct blk_desc *desc, int part)
 	struct fstype_info *info;
 	int ret, i;
 
+	/* Drop the filesystem kept mounted for an open file handle */
+	if (fs_file_mount)
+		fs_close();
+
 	if (part >= 1)
 		ret = part_get_info(desc, part, &fs_partition);
 	else
@@ -478,6 +502,7 @@ void fs_close(void)
 	info->close();
 
 	fs_type = FS_TYPE_ANY;
+	fs_file_mount = 0;
 }
 
 int fs_uuid(char *uuid_str)
@@ -526,18 +551,182 @@ int fs_size(const char *filename, loff_t *size)
 	return ret;
 }
 
+/* Record that the filesystem is now kept mounted for @file */
+static void fs_file_keep_mount(struct fs_file *file)
+{
+	/* 0 means that no mount is kept */
+	if (!++fs_mount_seq)
+		fs_mount_seq++;
+	file->mount = fs_mount_seq;
+	fs_file_mount = fs_mount_seq;
+}
+
+int fs_file_open(const char *filename, struct fs_file **filep)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file *file;
+	int ret;
+
+	file = calloc(1, sizeof(*file) + strlen(filename) + 1);
+	if (!file) {
+		fs_close();
+		return -ENOMEM;
+	}
+	file->desc = fs_dev_desc;
+	if (fs_dev_desc) {
+		file->uclass_id = fs_dev_desc->uclass_id;
+		file->devnum = fs_dev_desc->devnum;
+	}
+	file->part = fs_partition;
+	file->dev_part = fs_dev_part;
+	file->fstype = fs_type;
+	file->size = -1;
+	strcpy(file->name, filename);
+
+	if (info->file_open) {
+		ret = info->file_open(filename, &file->size);
+		if (ret) {
+			free(file);
+			fs_close();
+			return -ENOENT;
+		}
+	}
+	fs_file_keep_mount(file);
+	*filep = file;
+
+	return 0;
+}
+
+/*
+ * Check that the block device and partition of @file are still there. The
+ * device may be removed while the file is open, e.g. by 'usb stop', so the
+ * blk_desc pointer in @file is only used once the device is found again.
+ */
+static int fs_file_check_dev(struct fs_file *file, bool check_part)
+{
+	struct disk_partition part;
+	int ret;
+
+	if (!file->desc || !CONFIG_IS_ENABLED(BLK))
+		return 0;
+	if (blk_get_devnum_by_uclass_id(file->uclass_id, file->devnum) !=
+	    file->desc)
+		return -ENODEV;
+	if (!check_part)
+		return 0;
+
+	if (file->dev_part >= 1)
+		ret = part_get_info(file->desc, file->dev_part, &part);
+	else
+		ret = part_get_info_whole_disk(file->desc, &part);
+	if (ret || part.start != file->part.start ||
+	    part.size != file->part.size || part.blksz != file->part.blksz)
+		return -ENODEV;
+
+	return 0;
+}
+
+/*
+ * Make sure that the filesystem of @file is mounted with the file open. If
+ * another filesystem operation closed it, mount it and open the file again.
+ */
+static int fs_file_use(struct fs_file *file)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	bool mounted = file->mount == fs_file_mount;
+	loff_t size;
+	int ret;
+
+	ret = fs_file_check_dev(file, !mounted);
+	if (ret) {
+		log_debug("Device for '%s' has gone\n", file->name);
+		if (mounted)
+			fs_close();
+		return ret;
+	}
+	if (mounted)
+		return 0;
+
+	if (fs_type != FS_TYPE_ANY)
+		fs_close();
+
+	fs_dev_desc = file->desc;
+	fs_partition = file->part;
+	if (info->probe(fs_dev_desc, &fs_partition))
+		return -EIO;
+	fs_type = file->fstype;
+	fs_dev_part = file->dev_part;
+
+	if (info->file_open && info->file_open(file->name, &size)) {
+		fs_close();
+		return -ENOENT;
+	}
+	fs_file_keep_mount(file);
+
+	return 0;
+}
+
+int fs_file_size(struct fs_file *file, loff_t *size)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	int ret;
+
+	if (file->size < 0) {
+		ret = fs_file_use(file);
+		if (ret)
+			return ret;
+		ret = info->size(file->name, &file->size);
+		if (ret) {
+			file->size = -1;
+			return ret;
+		}
+	}
+	*size = file->size;
+
+	return 0;
+}
+
+int fs_file_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+		  loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	int ret;
+
+	ret = fs_file_use(file);
+	if (ret)
+		return ret;
+
+	if (!info->file_pread)
+		return info->read(file->name, buf, offset, len, actread);
+
+	if (!len)
+		len = file->size;
+
+	return info->file_pread(buf, offset, len, actread);
+}
+
+void fs_file_close(struct fs_file *file)
+{
+	if (!file)
+		return;
+	if (file->mount == fs_file_mount)
+		fs_close();
+	free(file);
+}
+
 #ifdef CONFIG_LMB
 /* Check if a file may be read to the given address */
-static int fs_read_lmb_check(const char *filename, ulong addr, loff_t offset,
-			     loff_t len, struct fstype_info *info)
+static int fs_read_lmb_check(struct fs_file *file, ulong addr, loff_t offset,
+			     loff_t len)
 {
 	struct lmb lmb;
+	phys_addr_t alloced;
 	int ret;
 	loff_t size;
 	loff_t read_len;
 
 	/* get the actual size of the file */
-	ret = info->size(filename, &size);
+	ret = fs_file_size(file, &size);
 	if (ret)
 		return ret;
 	if (offset >= size) {
@@ -552,8 +741,9 @@ static int fs_read_lmb_check(const char *filename, ulong addr, loff_t offset,
 
 	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
 	lmb_dump_all(&lmb);
-
-	if (lmb_alloc_addr(&lmb, addr, read_len) == addr)
+	alloced = lmb_alloc_addr(&lmb, addr, read_len);
+	lmb_uninit(&lmb);
+	if (alloced == addr)
 		return 0;
 
 	log_err("** Reading file would overwrite reserved memory **\n");
@@ -564,15 +754,21 @@ static int fs_read_lmb_check(const char *filename, ulong addr, loff_t offset,
 static int _fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 		    int do_lmb_check, loff_t *actread)
 {
-	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file *file;
 	void *buf;
 	int ret;
 
+	ret = fs_file_open(filename, &file);
+	if (ret)
+		return ret;
+
 #ifdef CONFIG_LMB
 	if (do_lmb_check) {
-		ret = fs_read_lmb_check(filename, addr, offset, len, info);
-		if (ret)
+		ret = fs_read_lmb_check(file, addr, offset, len);
+		if (ret) {
+			fs_file_close(file);
 			return ret;
+		}
 	}
 #endif
 
@@ -581,13 +777,13 @@ static int _fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	 * means read the whole file.
 	 */
 	buf = map_sysmem(addr, len);
-	ret = info->read(filename, buf, offset, len, actread);
+	ret = fs_file_pread(file, buf, offset, len, actread);
 	unmap_sysmem(buf);
 
 	/* If we requested a specific number of bytes, check we got it */
 	if (ret == 0 && len && *actread != len)
 		log_debug("** %s shorter than offset + len **\n", filename);
-	fs_close();
+	fs_file_close(file);
 
 	return ret;
 }
@@ -595,7 +791,13 @@ static int _fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	    loff_t *actread)
 {
-	return _fs_read(filename, addr, offset, len, 0, actread);
+	int old_cat, ret;
+
+	old_cat = malloc_prof_set_cat(LOGC_FS);
+	ret = _fs_read(filename, addr, offset, len, 0, actread);
+	malloc_prof_set_cat(old_cat);
+
+	return ret;
 }
 
 int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
@@ -1247,6 +1247,34 @@ static int ubifs_parse_options(struct ubifs_info *c, char *options,
 
 	return 0;
 }
+#else
+/*
+ * ubifs_parse_options - parse mount parameters.
+ *
+ * Only the options which matter for a read-only mount are supported.
+ */
+static int ubifs_parse_options(struct ubifs_info *c, char *options,
+			       int is_remount)
+{
+	char *p;
+
+	while (options && (p = strsep(&options, ","))) {
+		if (!*p)
+			continue;
+		if (!strcmp(p, "bulk_read")) {
+			c->mount_opts.bulk_read = 2;
+			c->bulk_read = 1;
+		} else if (!strcmp(p, "no_bulk_read")) {
+			c->mount_opts.bulk_read = 1;
+			c->bulk_read = 0;
+		} else {
+			ubifs_err(c, "unrecognized mount option \"%s\"", p);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
 #endif
 
 /**
@@ -2234,6 +2262,10 @@ static struct ubifs_info *alloc_ubifs_info(struct ubi_volume_desc *ubi)
 		INIT_LIST_HEAD(&c->orph_list);
 		INIT_LIST_HEAD(&c->orph_new);
 		c->no_chk_data_crc = 1;
+#ifdef __UBOOT__
+		/* Bulk-read is a mount option in Linux, a config option here */
+		c->bulk_read = IS_ENABLED(CONFIG_UBIFS_BULK_READ);
+#endif
 
 		c->highest_inum = UBIFS_FIRST_INO;
 		c->lhead_lnum = c->ltail_lnum = UBIFS_LOG_LNUM;
@@ -2288,6 +2320,10 @@ static int ubifs_fill_super(struct super_block *sb, void *data, int silent)
 		goto out_bdi;
 
 	sb->s_bdi = &c->bdi;
+#else
+	err = ubifs_parse_options(c, data, 0);
+	if (err)
+		goto out_close;
 #endif
 	sb->s_fs_info = c;
 	sb->s_magic = UBIFS_SUPER_MAGIC;
@@ -2338,8 +2374,8 @@ out_unlock:
 #ifndef __UBOOT__
 out_bdi:
 	bdi_destroy(&c->bdi);
-out_close:
 #endif
+out_close:
 	ubi_close_volume(c->ubi);
 out:
 	return err;
@@ -2691,7 +2727,7 @@ MODULE_VERSION(__stringify(UBIFS_VERSION));
 MODULE_AUTHOR("Artem Bityutskiy, Adrian Hunter");
 MODULE_DESCRIPTION("UBIFS - UBI File System");
 #else
-int uboot_ubifs_mount(char *vol_name)
+int uboot_ubifs_mount(char *vol_name, char *options)
 {
 	struct dentry *ret;
 	int flags;
@@ -2706,7 +2742,7 @@ int uboot_ubifs_mount(char *vol_name)
 	 * Mount in read-only mode
 	 */
 	flags = MS_RDONLY;
-	ret = ubifs_mount(&ubifs_fs_type, flags, vol_name, NULL);
+	ret = ubifs_mount(&ubifs_fs_type, flags, vol_name, options);
 	if (IS_ERR(ret)) {
 		printf("Error reading superblock on volume '%s' " \
 			"errno=%d!\n", vol_name, (int)PTR_ERR(ret));
@@ -666,23 +666,17 @@ static inline void *kmap(struct page *page)
 	return page->addr;
 }
 
-static int read_block(struct inode *inode, void *addr, unsigned int block,
-		      struct ubifs_data_node *dn)
+/*
+ * Decompress data node @dn, holding data block @block of @inode, to @addr,
+ * zeroing the remainder of the block.
+ */
+static int decode_data_node(struct inode *inode, void *addr,
+			    unsigned int block, struct ubifs_data_node *dn)
 {
 	struct ubifs_info *c = inode->i_sb->s_fs_info;
 	int err, len, out_len;
-	union ubifs_key key;
 	unsigned int dlen;
 
-	data_key_init(c, &key, inode->i_ino, block);
-	err = ubifs_tnc_lookup(c, &key, dn);
-	if (err) {
-		if (err == -ENOENT)
-			/* Not found, so it must be a hole */
-			memset(addr, 0, UBIFS_BLOCK_SIZE);
-		return err;
-	}
-
 	ubifs_assert(le64_to_cpu(dn->ch.sqnum) > ubifs_inode(inode)->creat_sqnum);
 
 	len = le32_to_cpu(dn->size);
@@ -713,6 +707,83 @@ dump:
 	return -EINVAL;
 }
 
+static int read_block(struct inode *inode, void *addr, unsigned int block,
+		      struct ubifs_data_node *dn)
+{
+	struct ubifs_info *c = inode->i_sb->s_fs_info;
+	union ubifs_key key;
+	int err;
+
+	data_key_init(c, &key, inode->i_ino, block);
+	err = ubifs_tnc_lookup(c, &key, dn);
+	if (err) {
+		if (err == -ENOENT)
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+		return err;
+	}
+
+	return decode_data_node(inode, addr, block, dn);
+}
+
+/*
+ * Read up to @max_blocks whole data blocks of @inode, starting at @block, to
+ * @addr using bulk-read.
+ *
+ * The index is walked once to collect the keys of the data nodes which lie
+ * consecutively in the same LEB, the whole region is read from UBI in one go
+ * and every data node it contains is then decoded in place. Holes between
+ * the nodes are zero-filled.
+ *
+ * Returns the number of blocks read, which may be 0 if bulk-read is not
+ * possible at @block, or a negative error code.
+ */
+static int do_bulk_read(struct ubifs_info *c, struct inode *inode,
+			unsigned int block, unsigned int max_blocks,
+			void *addr)
+{
+	struct bu_info *bu = &c->bu;
+	unsigned int i, n = 0, nr;
+	int err, offs = 0;
+
+	if (!bu->buf)
+		return 0;
+
+	data_key_init(c, &bu->key, inode->i_ino, block);
+	bu->buf_len = c->max_bu_buf_len;
+	err = ubifs_tnc_get_bu_keys(c, bu);
+	if (err)
+		return err;
+	if (!bu->cnt)
+		return 0;
+
+	err = ubifs_tnc_bulk_read(c, bu);
+	if (err == -EAGAIN)
+		return 0;
+	if (err)
+		return err;
+
+	nr = min_t(unsigned int, bu->blk_cnt, max_blocks);
+	for (i = 0; i < nr; i++, addr += UBIFS_BLOCK_SIZE) {
+		struct ubifs_data_node *dn = bu->buf + offs;
+
+		if (n >= bu->cnt ||
+		    key_block(c, &bu->zbranch[n].key) != block + i) {
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+			continue;
+		}
+
+		err = decode_data_node(inode, addr, block + i, dn);
+		if (err)
+			return err;
+		offs += ALIGN(bu->zbranch[n].len, 8);
+		n++;
+	}
+
+	return nr;
+}
+
 static int do_readpage(struct ubifs_info *c, struct inode *inode,
 		       struct page *page, int last_block_size)
 {
@@ -885,6 +956,28 @@ int ubifs_read(const char *filename, void *buf, loff_t offset,
 	page.index = offset / PAGE_SIZE;
 	page.inode = inode;
 	for (i = 0; i < count; i++) {
+		/*
+		 * Read whole pages in bulk while possible, leaving the last
+		 * one to do_readpage() so it is truncated to the requested
+		 * size.
+		 */
+		if (UBIFS_BLOCKS_PER_PAGE == 1 && i + 1 < count) {
+			int nr;
+
+			nr = do_bulk_read(c, inode, page.index, count - 1 - i,
+					  page.addr);
+			if (nr < 0) {
+				err = nr;
+				break;
+			}
+			if (nr > 0) {
+				page.addr += nr * PAGE_SIZE;
+				page.index += nr;
+				i += nr - 1;
+				continue;
+			}
+		}
+
 		/*
 		 * Make sure to not read beyond the requested size
 		 */
@@ -217,6 +217,26 @@ struct global_data {
 	 * @uclass_root_s.
 	 */
 	struct list_head *uclass_root;
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+	/**
+	 * @dm_compat_index: drivers sorted by compatible string, built on
+	 * first use by lists_bind_fdt()
+	 */
+	struct lists_compat_index *dm_compat_index;
+#endif
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	/**
+	 * @dm_uclass_table: uclasses indexed by ID, see uclass_find()
+	 */
+	struct dm_uclass_table *dm_uclass_table;
+#endif
+#if CONFIG_IS_ENABLED(DM_PROBE_TIMES)
+	/**
+	 * @dm_probe_nested_us: total time spent in device_probe() so far,
+	 * used to leave nested probes out of each device's probe time
+	 */
+	ulong dm_probe_nested_us;
+#endif
 # if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_RT)
 	/** @dm_driver_rt: Dynamic info about the driver */
 	struct driver_rt *dm_driver_rt;
@@ -260,6 +280,13 @@ struct global_data {
 	 */
 	struct device_node *of_root;
 #endif
+#if CONFIG_IS_ENABLED(OF_LOOKUP_CACHE)
+	/**
+	 * @of_cache: phandle and path lookups in the control FDT, used with
+	 * a flat tree
+	 */
+	struct ofnode_cache *of_cache;
+#endif
 
 #if CONFIG_IS_ENABLED(MULTI_DTB_FIT)
 	/**
@@ -522,6 +549,30 @@ static_assert(sizeof(struct global_data) == GD_SIZE);
 #define gd_set_of_root(_root)
 #endif
 
+#if CONFIG_IS_ENABLED(OF_LOOKUP_CACHE)
+#define gd_of_cache()		gd->of_cache
+#define gd_set_of_cache(_cache)	gd->of_cache = (_cache)
+#else
+#define gd_of_cache()		NULL
+#define gd_set_of_cache(_cache)
+#endif
+
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+#define gd_set_dm_compat_index(_idx)	gd->dm_compat_index = (_idx)
+#define gd_dm_compat_index()		gd->dm_compat_index
+#else
+#define gd_set_dm_compat_index(_idx)
+#define gd_dm_compat_index()		NULL
+#endif
+
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+#define gd_set_dm_uclass_table(_tbl)	gd->dm_uclass_table = (_tbl)
+#define gd_dm_uclass_table()		gd->dm_uclass_table
+#else
+#define gd_set_dm_uclass_table(_tbl)
+#define gd_dm_uclass_table()		NULL
+#endif
+
 #if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_RT)
 #define gd_set_dm_driver_rt(dyn)	gd->dm_driver_rt = dyn
 #define gd_dm_driver_rt()		gd->dm_driver_rt
@@ -213,6 +213,8 @@ enum bootstage_id {
 	BOOTSTAGE_ID_ACCUM_FSP_M,
 	BOOTSTAGE_ID_ACCUM_FSP_S,
 	BOOTSTAGE_ID_ACCUM_MMAP_SPI,
+	BOOTSTAGE_ID_ACCUM_UBI_ATTACH,
+	BOOTSTAGE_ID_ACCUM_DM_MATCH,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -338,6 +340,26 @@ uint32_t bootstage_accum(enum bootstage_id id);
 /* Print a report about boot time */
 void bootstage_report(void);
 
+/**
+ * bootstage_add_initcall() - Record the time taken by an initcall
+ *
+ * This is called by initcall_run_list() when CONFIG_BOOTSTAGE_INITCALLS is
+ * enabled. Nothing is recorded if bootstage is not set up yet.
+ *
+ * @addr: Unrelocated address of the initcall, or INITCALL_EVENT() value
+ * @time_us: Time taken in microseconds
+ */
+void bootstage_add_initcall(ulong addr, ulong time_us);
+
+/**
+ * bootstage_report_initcalls() - Print the initcall timings
+ *
+ * This lists the initcalls recorded by bootstage_add_initcall(), most
+ * expensive first, followed by the total time for board_init_f() and
+ * board_init_r().
+ */
+void bootstage_report_initcalls(void);
+
 /**
  * Add bootstage information to the device tree
  *
@@ -434,6 +456,10 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline void bootstage_add_initcall(ulong addr, ulong time_us)
+{
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Device dependencies taken from the devicetree
+ */
+
+#ifndef _DM_DEPS_H
+#define _DM_DEPS_H
+
+#include <dm/device-internal.h>
+
+struct udevice;
+
+/* Maximum depth of a dependency chain followed by device_probe_deps() */
+#define DM_DEPS_MAX_DEPTH	16
+
+#if CONFIG_IS_ENABLED(DM_DEPS)
+/**
+ * dev_get_deps() - Get the devices that a device depends on
+ *
+ * This looks at the clocks, resets, power-domains, phys and pinctrl-0
+ * properties of the device's node. Each phandle is resolved to the bound
+ * device which owns the node it points to, i.e. the device for that node or
+ * for its nearest ancestor with one. The device's parents are not included,
+ * since they are always probed first anyway. Each device is listed only
+ * once.
+ *
+ * @dev: Device to check
+ * @deps: Returns the devices depended on
+ * @max: Maximum number of devices to return in @deps
+ * Return: number of devices found, or -E2BIG if there are more than @max, in
+ *	which case the first @max are returned in @deps
+ */
+int dev_get_deps(struct udevice *dev, struct udevice **deps, int max);
+
+/**
+ * device_probe_deps() - Probe a device and everything it depends on
+ *
+ * This probes the device's parents and the devices returned by
+ * dev_get_deps(), recursively, before probing the device itself. Use this
+ * in place of probing all the devices in a uclass when only one of them is
+ * actually needed.
+ *
+ * Dependencies which fail to probe are not fatal here, since the driver
+ * may not need them. Only the error from probing @dev is returned. Cycles
+ * are broken, and chains longer than DM_DEPS_MAX_DEPTH are not followed.
+ *
+ * @dev: Device to probe
+ * Return: 0 if OK, -ve on error
+ */
+int device_probe_deps(struct udevice *dev);
+
+/**
+ * dev_get_dep_level() - Get the level of a device in the dependency graph
+ *
+ * A device with no dependencies other than the root device is at level 0.
+ * Otherwise the level is one more than the highest level of its parent and
+ * the devices returned by dev_get_deps(). Devices at the same level do not
+ * depend on each other, so could be probed in any order.
+ *
+ * @dev: Device to check
+ * Return: level of the device, or -ELOOP if the dependency chain is deeper
+ *	than DM_DEPS_MAX_DEPTH
+ */
+int dev_get_dep_level(struct udevice *dev);
+#else
+static inline int dev_get_deps(struct udevice *dev, struct udevice **deps,
+			       int max)
+{
+	return -ENOSYS;
+}
+
+static inline int device_probe_deps(struct udevice *dev)
+{
+	return device_probe(dev);
+}
+
+static inline int dev_get_dep_level(struct udevice *dev)
+{
+	return -ENOSYS;
+}
+#endif
+
+/**
+ * device_probe_boot() - Probe a device needed to boot
+ *
+ * With DM_DEPS_BOOT this probes the devices which @dev depends on first,
+ * using device_probe_deps(), so that each one is probed, and timed, on its
+ * own. Otherwise it is the same as device_probe().
+ *
+ * @dev: Device to probe
+ * Return: 0 if OK, -ve on error
+ */
+static inline int device_probe_boot(struct udevice *dev)
+{
+	if (CONFIG_IS_ENABLED(DM_DEPS_BOOT))
+		return device_probe_deps(dev);
+
+	return device_probe(dev);
+}
+
+#endif
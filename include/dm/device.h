@@ -166,6 +166,9 @@ enum {
  * @dma_offset: Offset between the physical address space (CPU's) and the
  *		device's bus address space
  * @iommu: IOMMU device associated with this device
+ * @probe_time_us_: Time taken by the last probe of this device in
+ *	microseconds, not counting the time spent probing its parents and any
+ *	other devices it probed (do not access outside driver model)
  */
 struct udevice {
 	const struct driver *driver;
@@ -198,6 +201,9 @@ struct udevice {
 #if CONFIG_IS_ENABLED(IOMMU)
 	struct udevice *iommu;
 #endif
+#if CONFIG_IS_ENABLED(DM_PROBE_TIMES)
+	ulong probe_time_us_;
+#endif
 };
 
 static inline int dm_udevice_size(void)
@@ -277,6 +283,12 @@ static inline __attribute_const__ ofnode dev_ofnode(const struct udevice *dev)
 #define dev_get_dma_offset(_dev)		0
 #endif
 
+#if CONFIG_IS_ENABLED(DM_PROBE_TIMES)
+#define dev_get_probe_time_us(_dev)		(_dev)->probe_time_us_
+#else
+#define dev_get_probe_time_us(_dev)		0UL
+#endif
+
 static inline __attribute_const__ int dev_of_offset(const struct udevice *dev)
 {
 #if CONFIG_IS_ENABLED(OF_REAL)
@@ -295,12 +307,22 @@ static inline __attribute_const__ bool dev_has_ofnode(const struct udevice *dev)
 #endif
 }
 
+#if CONFIG_IS_ENABLED(OF_REAL)
+/**
+ * dev_set_ofnode() - Set the device-tree node of a device
+ *
+ * This also drops the index of the device's uclass, if it has one, since
+ * that is sorted by ofnode
+ *
+ * @dev: Device to update
+ * @node: New node for the device
+ */
+void dev_set_ofnode(struct udevice *dev, ofnode node);
+#else
 static inline void dev_set_ofnode(struct udevice *dev, ofnode node)
 {
-#if CONFIG_IS_ENABLED(OF_REAL)
-	dev->node_ = node;
-#endif
 }
+#endif
 
 static inline int dev_seq(const struct udevice *dev)
 {
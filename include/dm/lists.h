@@ -12,6 +12,8 @@
 #include <dm/ofnode.h>
 #include <dm/uclass-id.h>
 
+struct udevice_id;
+
 /**
  * lists_driver_lookup_name() - Return u_boot_driver corresponding to name
  *
@@ -33,6 +35,21 @@ struct driver *lists_driver_lookup_name(const char *name);
  */
 struct uclass_driver *lists_uclass_lookup(enum uclass_id id);
 
+/**
+ * lists_driver_lookup_compat() - Find the driver for a compatible string
+ *
+ * If several drivers have the same compatible string, this returns the first
+ * one in the linker list, which is the one lists_bind_fdt() binds. With
+ * CONFIG_DM_COMPAT_INDEX this uses a sorted index of all the compatible
+ * strings, built on first use.
+ *
+ * @compat: Compatible string to look up
+ * @idp: Returns the matching entry in the driver's of_match table
+ * Return: pointer to driver, or NULL if not found
+ */
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp);
+
 /**
  * lists_bind_drivers() - search for and bind all drivers to parent
  *
@@ -255,6 +255,26 @@ struct device_node *of_find_node_by_prop_value(struct device_node *from,
 					       const char *propname,
 					       const void *propval,
 					       int proplen);
+/**
+ * of_phandle_index_add() - Index the nodes of a tree by phandle
+ *
+ * This allows of_find_node_by_phandle() to find nodes without searching the
+ * tree. It is called by unflatten_device_tree(). The tree must be freed
+ * with of_live_free(), so that the index is dropped too.
+ *
+ * @root:	Root node of the tree
+ * Return: 0 if OK (including when the phandles are too sparse to index),
+ * -ENOMEM if out of memory
+ */
+int of_phandle_index_add(struct device_node *root);
+
+/**
+ * of_phandle_index_remove() - Drop the phandle index of a tree
+ *
+ * @root:	Root node of the tree
+ */
+void of_phandle_index_remove(struct device_node *root);
+
 /**
  * of_find_node_by_phandle() - Find a node given a phandle
  *
@@ -684,6 +684,41 @@ const char *ofnode_get_name(ofnode node);
  */
 int ofnode_get_path(ofnode node, char *buf, int buflen);
 
+/**
+ * ofnode_fdt_phandle_offset() - find the node with a given phandle in an FDT
+ *
+ * For the control FDT this uses a table of phandles, built on first use.
+ * Other trees are searched with fdt_node_offset_by_phandle().
+ *
+ * @fdt:	FDT to search
+ * @phandle:	phandle to find
+ * Return: offset of the node, or -ve FDT_ERR_... value if not found
+ */
+#if CONFIG_IS_ENABLED(OF_LOOKUP_CACHE)
+int ofnode_fdt_phandle_offset(const void *fdt, uint phandle);
+#else
+static inline int ofnode_fdt_phandle_offset(const void *fdt, uint phandle)
+{
+	return fdt_node_offset_by_phandle(fdt, phandle);
+}
+#endif
+
+/**
+ * ofnode_cache_invalidate() - drop the lookup cache before writing to an FDT
+ *
+ * Call this before changing an FDT with libfdt. If it is the control FDT,
+ * the phandle and path lookup cache is rebuilt on next use.
+ *
+ * @fdt:	FDT which is about to be changed
+ */
+#if CONFIG_IS_ENABLED(OF_LOOKUP_CACHE)
+void ofnode_cache_invalidate(const void *fdt);
+#else
+static inline void ofnode_cache_invalidate(const void *fdt)
+{
+}
+#endif
+
 /**
  * ofnode_get_by_phandle() - get ofnode from phandle
  *
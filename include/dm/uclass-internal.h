@@ -10,6 +10,7 @@
 #define _DM_UCLASS_INTERNAL_H
 
 #include <dm/ofnode.h>
+#include <dm/uclass-id.h>
 
 /*
  * These next two macros DM_UCLASS_INST() and DM_UCLASS_REF() are only allowed
@@ -329,6 +330,48 @@ static inline int uclass_pre_remove_device(struct udevice *dev) { return 0; }
  */
 int uclass_get_count(void);
 
+/**
+ * struct dm_uclass_table - uclasses indexed by ID
+ *
+ * This is allocated once the full malloc() pool is available and filled in
+ * as uclasses are looked up.
+ *
+ * @walks: Number of times a list was searched, or a uclass index was built,
+ *	because a lookup could not use an index. This is used by tests.
+ * @uc: Uclass for each ID, or NULL if not looked up yet
+ */
+struct dm_uclass_table {
+	uint walks;
+	struct uclass *uc[UCLASS_COUNT];
+};
+
+/**
+ * uclass_index_invalidate() - Drop the device index of a uclass
+ *
+ * This must be called when a device is added to or removed from a uclass,
+ * or when the sequence number or ofnode of one of its devices changes. The
+ * index is rebuilt on the next lookup.
+ *
+ * @uc: uclass to update
+ */
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+void uclass_index_invalidate(struct uclass *uc);
+#else
+static inline void uclass_index_invalidate(struct uclass *uc) {}
+#endif
+
+/**
+ * uclass_table_reset() - Forget all uclasses in the uclass table
+ *
+ * This is called when driver model starts up, since any uclasses found
+ * before that belong to a previous instance (e.g. before relocation).
+ */
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+void uclass_table_reset(void);
+#else
+static inline void uclass_table_reset(void) {}
+#endif
+
 /**
  * uclass_find() - Find uclass by its id
  *
@@ -30,12 +30,17 @@
  * @dev_head: List of devices in this uclass (devices are attached to their
  * uclass when their bind method is called)
  * @sibling_node: Next uclass in the linked list of uclasses
+ * @idx_: Arrays of the devices in this uclass, built on first use (do not
+ * access outside driver model)
  */
 struct uclass {
 	void *priv_;
 	struct uclass_driver *uc_drv;
 	struct list_head dev_head;
 	struct list_head sibling_node;
+#if CONFIG_IS_ENABLED(DM_UCLASS_INDEX)
+	struct uclass_index *idx_;
+#endif
 };
 
 struct driver;
@@ -59,6 +59,14 @@ void dm_dump_driver_compat(void);
 /* Dump out a list of drivers with static platform data */
 void dm_dump_static_driver_info(void);
 
+/**
+ * dm_dump_probe_times() - Dump the time taken to probe each device
+ *
+ * This lists the probed devices, slowest first, along with their level in
+ * the dependency graph if CONFIG_DM_DEPS is enabled. See dev_get_dep_level().
+ */
+void dm_dump_probe_times(void);
+
 /**
  * dm_dump_mem() - Dump stats on memory usage in driver model
  *
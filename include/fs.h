@@ -5,6 +5,7 @@
 #ifndef _FS_H
 #define _FS_H
 
+#include <part.h>
 #include <rtc.h>
 
 struct cmd_tbl;
@@ -150,6 +151,87 @@ int fs_size(const char *filename, loff_t *size);
 int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	    loff_t *actread);
 
+/**
+ * struct fs_file - handle of a file opened with fs_file_open()
+ *
+ * The handle records where the file lives, so that it can be read with
+ * fs_file_pread() at any time, even after other filesystem operations.
+ *
+ * @desc:	block device holding the filesystem, only used after checking
+ *		that the device is still there
+ * @uclass_id:	uclass of the block device, used to find it again
+ * @devnum:	device number of the block device, used to find it again
+ * @part:	partition holding the filesystem
+ * @dev_part:	partition number
+ * @fstype:	filesystem type (FS_TYPE_...)
+ * @mount:	sequence number of the mount kept for this file. The filesystem
+ *		is still mounted for it if no other mount was kept since.
+ * @size:	size of the file, or -1 if not known yet
+ * @name:	full path of the file
+ */
+struct fs_file {
+	struct blk_desc *desc;
+	enum uclass_id uclass_id;
+	int devnum;
+	struct disk_partition part;
+	int dev_part;
+	int fstype;
+	uint mount;
+	loff_t size;
+	char name[];
+};
+
+/**
+ * fs_file_open() - open a file on the partition previously set by
+ *		    fs_set_blk_dev()
+ *
+ * The filesystem is kept mounted and, where the filesystem driver supports
+ * it, the resolved inode is kept, so that reading the file in chunks with
+ * fs_file_pread() neither mounts the filesystem nor looks up the path again.
+ * If another filesystem operation happens in between, including opening
+ * another file, the next fs_file_pread() mounts the filesystem and opens the
+ * file again. If the block device has been removed since, it fails instead.
+ *
+ * On error the filesystem is closed, as with the other fs_...() functions.
+ *
+ * @filename:	full path of the file to open
+ * @filep:	returns the file handle, to be released with fs_file_close()
+ * Return:	0 if OK, -ve on error
+ */
+int fs_file_open(const char *filename, struct fs_file **filep);
+
+/**
+ * fs_file_pread() - read from a file opened with fs_file_open()
+ *
+ * @file:	file to read from
+ * @buf:	buffer to read into
+ * @offset:	offset in the file from where to start reading
+ * @len:	the number of bytes to read. Use 0 to read entire file.
+ * @actread:	returns the actual number of bytes read
+ * Return:	0 if OK with valid *actread, -ENODEV if the block device or
+ *		partition has gone, other -ve value on error
+ */
+int fs_file_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+		  loff_t *actread);
+
+/**
+ * fs_file_size() - get the size of a file opened with fs_file_open()
+ *
+ * @file:	file to check
+ * @size:	returns the size of the file
+ * Return:	0 if OK with valid *size, -ve on error
+ */
+int fs_file_size(struct fs_file *file, loff_t *size);
+
+/**
+ * fs_file_close() - close a file opened with fs_file_open()
+ *
+ * This also closes the filesystem if it is still mounted for this file.
+ *
+ * @file:	file to close, may be NULL
+ */
+void fs_file_close(struct fs_file *file);
+
 /**
  * fs_write() - write file to the partition previously set by fs_set_blk_dev()
  *
@@ -120,6 +120,25 @@ int hash_command(const char *algo_name, int flags, struct cmd_tbl *cmdtp,
 int hash_block(const char *algo_name, const void *data, unsigned int len,
 	       uint8_t *output, int *output_size);
 
+/**
+ * hash_bench() - Measure the throughput of a hash algorithm
+ *
+ * This hashes the same buffer repeatedly until at least @min_us microseconds
+ * have passed, so that the result does not depend on the timer resolution.
+ *
+ * @algo:	Hash algorithm to measure
+ * @buf:	Data to hash; any alignment is permitted
+ * @len:	Number of bytes hashed in each pass
+ * @chunk:	0 to hash each pass with a single call to algo->hash_func_ws,
+ *		else feed it to the progressive interface @chunk bytes at a time
+ * @min_us:	Minimum time to spend hashing, in microseconds
+ * @kbpsp:	Returns the throughput in KB/s (1000 bytes per second)
+ * Return: 0 if ok, -EINVAL if @len is 0, -ENOSYS if @chunk is non-zero and
+ * the algorithm has no progressive interface, other -ve on error
+ */
+int hash_bench(struct hash_algo *algo, const void *buf, unsigned int len,
+	       unsigned int chunk, ulong min_us, ulong *kbpsp);
+
 #endif /* !USE_HOSTCC */
 
 /**
@@ -149,6 +168,14 @@ int hash_lookup_algo(const char *algo_name, struct hash_algo **algop);
 int hash_progressive_lookup_algo(const char *algo_name,
 				 struct hash_algo **algop);
 
+/**
+ * hash_next_algo() - Iterate through the available hash algorithms
+ *
+ * @algo: Previous algorithm, or NULL to get the first one
+ * Return: the next algorithm, or NULL if there are no more
+ */
+struct hash_algo *hash_next_algo(struct hash_algo *algo);
+
 /**
  * hash_parse_string() - Parse hash string into a binary array
  *
@@ -1347,6 +1347,108 @@ static inline int fit_config_verify(const void *fit, int conf_noffset)
 	return 0;
 }
 #endif
+
+/* Limits for entries in the FIT verification cache */
+#define FIT_CACHE_ENTRIES	8
+#define FIT_CACHE_NAME_LEN	16
+#define FIT_CACHE_VALUE_LEN	32
+
+#if !defined(USE_HOSTCC) && CONFIG_IS_ENABLED(FIT_VERIFY_CACHE)
+/**
+ * fit_cache_check() - Check if a configuration signature is already verified
+ *
+ * @fit:	Pointer to the FIT
+ * @name:	Hash algorithm used for @value
+ * @value:	Digest of the key node and the signed regions of the FIT
+ * @value_len:	Length of @value in bytes
+ * Return: true if the same check has already passed
+ */
+bool fit_cache_check(const void *fit, const char *name, const uint8_t *value,
+		     int value_len);
+
+/**
+ * fit_cache_add() - Record a successful verification
+ *
+ * The record is kept in a bloblist, so it is passed from SPL to U-Boot proper.
+ * Entries whose name or value is too long are silently not recorded.
+ *
+ * Arguments are as for fit_cache_check()
+ */
+void fit_cache_add(const void *fit, const char *name, const uint8_t *value,
+		   int value_len);
+
+/**
+ * fit_cache_clear() - Forget all recorded verifications
+ */
+void fit_cache_clear(void);
+#else
+static inline bool fit_cache_check(const void *fit, const char *name,
+				   const uint8_t *value, int value_len)
+{
+	return false;
+}
+
+static inline void fit_cache_add(const void *fit, const char *name,
+				 const uint8_t *value, int value_len)
+{
+}
+
+static inline void fit_cache_clear(void)
+{
+}
+#endif
+
+/**
+ * struct fit_load_stats - how fit_image_load() handled the data of an image
+ *
+ * @passes:	Number of passes made over the image data, counting the hash
+ *		check and the copy or decompression
+ * @time_us:	Time taken for those passes, in microseconds
+ */
+struct fit_load_stats {
+	uint passes;
+	ulong time_us;
+};
+
+/**
+ * fit_get_load_stats() - Get statistics for the last image loaded
+ *
+ * Return: statistics from the last call to fit_image_load()
+ */
+const struct fit_load_stats *fit_get_load_stats(void);
+
+#if !defined(USE_HOSTCC) && CONFIG_IS_ENABLED(FIT_SINGLE_PASS)
+/**
+ * fit_image_load_stream() - Verify and load an image in a single pass
+ *
+ * This reads the image data once, in chunks, updating the hash of each hash
+ * node and then copying or decompressing the chunk to @dst. The hashes are
+ * checked at the end, so on failure @dst may hold some unverified data.
+ *
+ * @fit:	FIT containing the image
+ * @noffset:	Offset of the image node
+ * @comp:	Compression type of the image (IH_COMP_...)
+ * @src:	Image data
+ * @len:	Size of image data in bytes
+ * @dst:	Place to put the (decompressed) image
+ * @dst_size:	Size of @dst in bytes
+ * @out_lenp:	Returns the number of bytes written to @dst
+ * Return: 0 if OK, -ENOSYS if the image cannot be handled in one pass, so the
+ *	hash must be checked separately first, -EACCES if a hash does not match,
+ *	other -ve value if the image could not be decompressed
+ */
+int fit_image_load_stream(const void *fit, int noffset, int comp,
+			  const void *src, ulong len, void *dst,
+			  ulong dst_size, ulong *out_lenp);
+#else
+static inline int fit_image_load_stream(const void *fit, int noffset, int comp,
+					const void *src, ulong len, void *dst,
+					ulong dst_size, ulong *out_lenp)
+{
+	return -ENOSYS;
+}
+#endif
+
 int fit_all_image_verify(const void *fit);
 int fit_config_decrypt(const void *fit, int conf_noffset);
 int fit_image_check_os(const void *fit, int noffset, uint8_t os);
@@ -1790,6 +1892,7 @@ struct cipher_algo {
 	const char *name;		/* Name of algorithm */
 	int key_len;			/* Length of the key */
 	int iv_len;			/* Length of the IV */
+	bool unique_iv;			/* IV must not be reused with a key */
 
 #if IMAGE_ENABLE_ENCRYPT
 	const EVP_CIPHER * (*calculate_type)(void);
@@ -455,4 +455,70 @@ struct abuf;
  */
 int zstd_decompress(struct abuf *in, struct abuf *out);
 
+/**
+ * struct zstd_stream - state for chunk-wise Zstandard decompression
+ *
+ * @dstream: zstd streaming context, placed inside @workspace
+ * @workspace: Workspace allocated by zstd_stream_init()
+ * @flat: true if the output buffer holds the whole frame (see
+ *	zstd_stream_init())
+ * @done: true once the end of the frame has been decoded
+ */
+struct zstd_stream {
+	zstd_dstream *dstream;
+	void *workspace;
+	bool flat;
+	bool done;
+};
+
+/**
+ * zstd_stream_init() - Set up chunk-wise decompression of one zstd frame
+ *
+ * In flat mode the caller passes the same output buffer to every call to
+ * zstd_stream_feed() and it must be large enough for the whole frame. The
+ * decoder then references earlier output directly, so the workspace is only
+ * the decoder context plus room for one compressed block (128KB), whatever
+ * the window size of the frame.
+ *
+ * Otherwise the output buffer may change between calls and the decoder keeps
+ * its own copy of the window, so the workspace grows with @max_window.
+ *
+ * @strm: Stream to set up
+ * @max_window: Largest window size to accept, or 0 to use
+ *	1 << CONFIG_ZSTD_MAX_WINDOW_LOG. Frames needing a larger window are
+ *	rejected.
+ * @flat: true to use flat mode, as above
+ * Return: 0 if OK, -ENOMEM if the workspace cannot be allocated, -EPERM if
+ *	the decoder cannot be set up
+ */
+int zstd_stream_init(struct zstd_stream *strm, ulong max_window, bool flat);
+
+/**
+ * zstd_stream_feed() - Decompress some more input
+ *
+ * This consumes as much of @in as possible, stopping early only when @out is
+ * full or the frame ends. Both buffers have their @pos member updated.
+ *
+ * @strm: Stream to use
+ * @in: Next chunk of compressed data
+ * @out: Output buffer
+ * Return: 1 if the end of the frame was reached, 0 if more input (or, if not
+ *	flat, more output space) is needed, -E2BIG if the output buffer is too
+ *	small (flat mode), -EFBIG if the frame needs a window larger than
+ *	allowed, -EINVAL if the data is corrupt
+ */
+int zstd_stream_feed(struct zstd_stream *strm, zstd_in_buffer *in,
+		     zstd_out_buffer *out);
+
+/**
+ * zstd_stream_finish() - Finish decompression and free the workspace
+ *
+ * This must be called once for each successful zstd_stream_init(), even if
+ * zstd_stream_feed() failed.
+ *
+ * @strm: Stream to finish
+ * Return: 0 if the whole frame was decoded, -EINVAL if it was truncated
+ */
+int zstd_stream_finish(struct zstd_stream *strm);
+
 #endif  /* LINUX_ZSTD_H */
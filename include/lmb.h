@@ -5,6 +5,7 @@
 
 #include <asm/types.h>
 #include <asm/u-boot.h>
+#include <linux/types.h>
 
 /*
  * Logical memory blocks.
@@ -41,33 +42,43 @@ struct lmb_property {
  *
  * case 1. CONFIG_LMB_USE_MAX_REGIONS is defined (legacy mode)
  *         => CONFIG_LMB_MAX_REGIONS is used to configure the region size,
- *         directly in the array lmb_region.region[], with the same
- *         configuration for memory and reserved regions.
+ *         with the same configuration for memory and reserved regions.
  *
  * case 2. CONFIG_LMB_USE_MAX_REGIONS is not defined, the size of each
  *         region is configurated *independently* with
  *         => CONFIG_LMB_MEMORY_REGIONS: struct lmb.memory_regions
  *         => CONFIG_LMB_RESERVED_REGIONS: struct lmb.reserved_regions
- *         lmb_region.region is only a pointer to the correct buffer,
- *         initialized in lmb_init(). This configuration is useful to manage
- *         more reserved memory regions with CONFIG_LMB_RESERVED_REGIONS.
+ *         This configuration is useful to manage more reserved memory
+ *         regions with CONFIG_LMB_RESERVED_REGIONS.
+ *
+ * In both cases lmb_region.region points to the array in struct lmb,
+ * initialized in lmb_init(). With CONFIG_LMB_DYNAMIC_REGIONS a full array is
+ * moved to a larger one allocated with malloc(), so the configured size is
+ * only the initial one; lmb_uninit() frees it again.
  */
+#if IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
+#define LMB_MEMORY_REGIONS	CONFIG_LMB_MAX_REGIONS
+#define LMB_RESERVED_REGIONS	CONFIG_LMB_MAX_REGIONS
+#else
+#define LMB_MEMORY_REGIONS	CONFIG_LMB_MEMORY_REGIONS
+#define LMB_RESERVED_REGIONS	CONFIG_LMB_RESERVED_REGIONS
+#endif
 
 /**
  * struct lmb_region - Description of a set of region.
  *
+ * The regions are sorted by base address and do not overlap.
+ *
  * @cnt: Number of regions.
  * @max: Size of the region array, max value of cnt.
  * @region: Array of the region properties
+ * @alloced: true if @region was allocated with malloc()
  */
 struct lmb_region {
 	unsigned long cnt;
 	unsigned long max;
-#if IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
-	struct lmb_property region[CONFIG_LMB_MAX_REGIONS];
-#else
 	struct lmb_property *region;
-#endif
+	bool alloced;
 };
 
 /**
@@ -86,13 +97,21 @@ struct lmb_region {
 struct lmb {
 	struct lmb_region memory;
 	struct lmb_region reserved;
-#if !IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
-	struct lmb_property memory_regions[CONFIG_LMB_MEMORY_REGIONS];
-	struct lmb_property reserved_regions[CONFIG_LMB_RESERVED_REGIONS];
-#endif
+	struct lmb_property memory_regions[LMB_MEMORY_REGIONS];
+	struct lmb_property reserved_regions[LMB_RESERVED_REGIONS];
 };
 
 void lmb_init(struct lmb *lmb);
+
+/**
+ * lmb_uninit() - free the region arrays allocated for an lmb
+ *
+ * This is only needed with CONFIG_LMB_DYNAMIC_REGIONS, when more regions were
+ * added than fit in struct lmb. The lmb is left empty, as after lmb_init().
+ *
+ * @lmb:	the logical memory block struct
+ */
+void lmb_uninit(struct lmb *lmb);
 void lmb_init_and_reserve(struct lmb *lmb, struct bd_info *bd, void *fdt_blob);
 void lmb_init_and_reserve_range(struct lmb *lmb, phys_addr_t base,
 				phys_size_t size, void *fdt_blob);
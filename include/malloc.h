@@ -999,6 +999,211 @@ extern ulong mem_malloc_brk;
 
 void mem_malloc_init(ulong start, ulong size);
 
+/* Number of slab size classes, and the largest size served by the slab */
+#define MALLOC_SLAB_CLASSES	6
+#define MALLOC_SLAB_MAX		512
+
+/**
+ * struct malloc_slab_stats - statistics for a slab size class
+ *
+ * @size: Size of the objects in this class, in bytes
+ * @allocs: Number of objects allocated since malloc() was set up
+ * @frees: Number of objects freed since malloc() was set up
+ * @inuse: Number of objects currently allocated
+ * @objs: Number of objects which fit in the pages currently held
+ * @pages: Number of pages currently held
+ * @max_pages: Largest number of pages held at once
+ */
+struct malloc_slab_stats {
+	uint size;
+	ulong allocs;
+	ulong frees;
+	ulong inuse;
+	ulong objs;
+	uint pages;
+	uint max_pages;
+};
+
+/**
+ * malloc_slab_alloc() - Allocate an object from the slab
+ *
+ * This is called by malloc() for small allocations, once the full malloc()
+ * pool is available
+ *
+ * @bytes: Number of bytes required
+ * Return: pointer to the object, or NULL if @bytes is larger than
+ *	MALLOC_SLAB_MAX or there is no memory for a new page
+ */
+void *malloc_slab_alloc(size_t bytes);
+
+/**
+ * malloc_slab_free() - Free an object if it belongs to the slab
+ *
+ * A pointer into a slab page which is not the start of an object is reported
+ * and otherwise ignored.
+ *
+ * @ptr: Pointer to check
+ * Return: true if @ptr points into the slab, false if it is not a slab object
+ */
+bool malloc_slab_free(void *ptr);
+
+/**
+ * malloc_slab_usable_size() - Get the usable size of a slab object
+ *
+ * @ptr: Pointer to check
+ * Return: size of the object's class, or 0 if @ptr is not a slab object
+ */
+size_t malloc_slab_usable_size(const void *ptr);
+
+/**
+ * malloc_slab_unused() - Get the unused space held by the slab
+ *
+ * Return: number of bytes of the malloc() pool held by the slab but not
+ *	allocated to any object, including its own bookkeeping
+ */
+ulong malloc_slab_unused(void);
+
+/**
+ * malloc_slab_get_stats() - Get the statistics for a size class
+ *
+ * @cls: Class index, 0 for the smallest class
+ * @stats: Returns the statistics
+ * Return: 0 if OK, -ENOENT if @cls is out of range
+ */
+int malloc_slab_get_stats(uint cls, struct malloc_slab_stats *stats);
+
+/* Reset the slab, called when the malloc() pool is set up */
+void malloc_slab_init(void);
+
+/* Pass to malloc_prof_get_stats() for the totals of all categories */
+#define MALLOC_PROF_ALL		-1
+
+/**
+ * struct malloc_prof_stats - malloc() usage recorded by the profiler
+ *
+ * @cur: Bytes currently allocated
+ * @peak: Largest value of @cur seen
+ * @count: Number of blocks currently allocated
+ * @allocs: Number of blocks allocated
+ * @frees: Number of blocks freed
+ * @dropped: Number of blocks not recorded, since the table was full
+ */
+struct malloc_prof_stats {
+	ulong cur;
+	ulong peak;
+	ulong count;
+	ulong allocs;
+	ulong frees;
+	ulong dropped;
+};
+
+/**
+ * struct malloc_prof_block - a block recorded by the profiler
+ *
+ * @ptr: Address of the block
+ * @caller: Address which the allocation function returned to
+ * @size: Size requested, in bytes
+ * @time_ms: Value of get_timer(0) when the block was allocated, or 0 if the
+ *	timer was not running yet
+ * @cat: Log category in effect when the block was allocated
+ */
+struct malloc_prof_block {
+	void *ptr;
+	ulong caller;
+	ulong size;
+	ulong time_ms;
+	int cat;
+};
+
+/**
+ * malloc_prof_get_stats() - Get the usage recorded for a category
+ *
+ * @cat: Log category, or MALLOC_PROF_ALL for the totals
+ * @stats: Returns the usage
+ * Return: 0 if OK, -ENOENT if @cat is out of range
+ */
+int malloc_prof_get_stats(int cat, struct malloc_prof_stats *stats);
+
+/**
+ * malloc_prof_find() - Look up the record for a block
+ *
+ * @ptr: Address of the block
+ * @blk: Returns the record
+ * Return: 0 if OK, -ENOENT if the block is not recorded
+ */
+int malloc_prof_find(const void *ptr, struct malloc_prof_block *blk);
+
+/**
+ * malloc_prof_show() - Show the usage by category, call site and block
+ *
+ * Caller addresses are shown before relocation, so they can be looked up in
+ * System.map
+ */
+void malloc_prof_show(void);
+
+/* Drop all records, called when the malloc() pool is set up */
+void malloc_prof_init(void);
+
+#if CONFIG_IS_ENABLED(MALLOC_PROFILE)
+/**
+ * malloc_prof_alloc() - Record a block returned by an allocation function
+ *
+ * If the block is recorded already, e.g. by malloc() called from calloc(),
+ * its size and caller are updated
+ *
+ * @ptr: Block allocated, or NULL if the allocation failed
+ * @size: Size requested, in bytes
+ * @caller: Address which the allocation function returns to
+ */
+void malloc_prof_alloc(void *ptr, size_t size, void *caller);
+
+/**
+ * malloc_prof_free() - Drop the record of a block which is being freed
+ *
+ * @ptr: Block being freed; nothing happens if it was not recorded
+ */
+void malloc_prof_free(void *ptr);
+
+/**
+ * malloc_prof_set_cat() - Select the category for later allocations
+ *
+ * Blocks allocated after this call are charged to @cat. Callers should
+ * restore the previous category when they are done.
+ *
+ * @cat: Log category (enum log_category_t), e.g. a uclass ID
+ * Return: previous category
+ */
+int malloc_prof_set_cat(int cat);
+
+/**
+ * memalign_unrecorded() - Allocate aligned memory without recording it
+ *
+ * This is memalign() without the profiler, for the slab's pages: only the
+ * objects carved out of them are recorded, so that a new page does not
+ * count twice towards the peak.
+ *
+ * @alignment: Alignment required, in bytes
+ * @bytes: Number of bytes required
+ * Return: pointer to the memory, or NULL if there is not enough
+ */
+void *memalign_unrecorded(size_t alignment, size_t bytes);
+#else
+#define memalign_unrecorded	memalign
+
+static inline void malloc_prof_alloc(void *ptr, size_t size, void *caller)
+{
+}
+
+static inline void malloc_prof_free(void *ptr)
+{
+}
+
+static inline int malloc_prof_set_cat(int cat)
+{
+	return 0;
+}
+#endif
+
 #ifdef __cplusplus
 };  /* end of extern "C" */
 #endif
@@ -153,6 +153,13 @@ SPL_TEST(func##_##type, flags)
 /* More than a couple blocks, and will not be aligned to anything */
 #define SPL_TEST_DATA_SIZE	4099
 
+/*
+ * Configuration-signature result which spl_test_fit_cache() records for U-Boot
+ * proper. The digest is 32 bytes of SPL_TEST_FIT_CACHE_BYTE.
+ */
+#define SPL_TEST_FIT_CACHE_ADDR	0x10000
+#define SPL_TEST_FIT_CACHE_BYTE	0xa5
+
 /* Flags necessary for accessing DM devices */
 #define DM_FLAGS (UT_TESTF_DM | UT_TESTF_SCAN_FDT)
 
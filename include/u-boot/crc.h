@@ -98,12 +98,19 @@ void crc32_wd_buf(const uint8_t *input, uint ilen, uint8_t *output,
 
 /* lib/crc32c.c */
 
+/* Number of entries in the table used by crc32c_init() and crc32c_cal() */
+#ifdef CONFIG_CRC32C_SLICE_BY_8
+#define CRC32C_TABLE_SIZE	(8 * 256)
+#else
+#define CRC32C_TABLE_SIZE	256
+#endif
+
 /**
  * crc32c_init() - Set up a the CRC32 table
  *
- * This sets up 256-item table to aid in CRC32 calculation
+ * This sets up a CRC32C_TABLE_SIZE-item table to aid in CRC32 calculation
  *
- * @crc32c_table: Place to put table
+ * @crc32c_table: Place to put table (CRC32C_TABLE_SIZE entries)
  * @pol: polynomial to use
  */
 void crc32c_init(uint32_t *crc32c_table, uint32_t pol);
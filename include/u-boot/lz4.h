@@ -6,18 +6,78 @@
 #ifndef __LZ4_H
 #define __LZ4_H
 
+#include <linux/types.h>
+#include <linux/xxhash.h>
+
+/**
+ * struct ulz4_stream - state for decompressing an LZ4 frame piece by piece
+ *
+ * @dst: Output buffer, which holds the whole decompressed frame
+ * @dst_size: Size of @dst
+ * @out: Number of bytes written to @dst so far
+ * @content_size: Content size from the frame header, if present
+ * @block_max: Maximum decompressed size of a block, from the frame header
+ * @flags: FLG byte of the frame header
+ * @header_done: true once the frame header has been parsed
+ * @done: true once the end mark (and content checksum) has been processed
+ * @xxh: Running content checksum, if enabled
+ */
+struct ulz4_stream {
+	void *dst;
+	size_t dst_size;
+	size_t out;
+	u64 content_size;
+	u32 block_max;
+	u8 flags;
+	bool header_done;
+	bool done;
+	struct xxh32_state xxh;
+};
+
+/**
+ * ulz4_stream_init() - Set up decompression of an LZ4 frame
+ *
+ * @strm: Stream to set up
+ * @dst: Destination for uncompressed data
+ * @dst_size: Size of @dst
+ */
+void ulz4_stream_init(struct ulz4_stream *strm, void *dst, size_t dst_size);
+
+/**
+ * ulz4_stream_feed() - Decompress the next part of an LZ4 frame
+ *
+ * This decodes the frame header and then as many complete blocks as are
+ * available at @src. Data which does not make up a whole block is left
+ * alone; the caller should pass it again, followed by more input, on the
+ * next call. So the caller needs room for at least @strm->block_max plus 8
+ * bytes of input once the header has been parsed.
+ *
+ * @strm: Stream to use
+ * @src: Next part of the frame
+ * @len: Number of bytes available at @src
+ * @usedp: Returns the number of bytes consumed from @src
+ * Return: 1 if the frame is complete, 0 if more input is needed, or an error
+ *	as for ulz4fn()
+ */
+int ulz4_stream_feed(struct ulz4_stream *strm, const void *src, size_t len,
+		     size_t *usedp);
+
 /**
  * ulz4fn() - Decompress LZ4 data
  *
+ * Both independent and linked blocks are supported. If CONFIG_LZ4_CHECKSUM
+ * is enabled the header, block and content checksums are checked, when
+ * present in the frame.
+ *
  * @src: Source data to decompress
  * @srcn: Length of source data
  * @dst: Destination for uncompressed data
  * @dstn: Returns length of uncompressed data
  * Return: 0 if OK, -EPROTONOSUPPORT if the magic number or version number are
- *	not recognised or independent blocks are used, -EINVAL if the reserved
- *	fields are non-zero, or input is overrun, -EENOBUFS if the destination
- *	buffer is overrun, -EEPROTO if the compressed data causes an error in
- *	the decompression algorithm
+ *	not recognised, -EINVAL if the reserved fields are non-zero, or input
+ *	is overrun, -ENOBUFS if the destination buffer is overrun, -EPROTO if
+ *	the compressed data causes an error in the decompression algorithm,
+ *	-EBADMSG if a checksum or the content size does not match
  */
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
@@ -18,6 +18,22 @@ typedef struct {
 
 extern const uint8_t sha512_der_prefix[];
 
+/**
+ * sha512_process() - hash a number of whole blocks into the state
+ *
+ * This is weak so that an architecture can supply an accelerated version.
+ * sha512_process_generic() is the portable C implementation, which such a
+ * version can fall back to.
+ *
+ * @ctx: SHA-512/SHA-384 context
+ * @data: input data, @blocks * SHA512_BLOCK_SIZE bytes
+ * @blocks: number of blocks to process
+ */
+void sha512_process(sha512_context *ctx, const unsigned char *data,
+		    unsigned int blocks);
+void sha512_process_generic(sha512_context *ctx, const unsigned char *data,
+			    unsigned int blocks);
+
 void sha512_starts(sha512_context * ctx);
 void sha512_update(sha512_context *ctx, const uint8_t *input, uint32_t length);
 void sha512_finish(sha512_context * ctx, uint8_t digest[SHA512_SUM_LEN]);
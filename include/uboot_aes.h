@@ -107,4 +107,54 @@ void aes_cbc_encrypt_blocks(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 void aes_cbc_decrypt_blocks(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 			    u32 num_aes_blocks);
 
+/**
+ * aes_ctr_crypt() - Encrypt or decrypt data with AES CTR
+ *
+ * The counter block is incremented as a 128-bit big-endian number for each
+ * block, and is left ready for the next call. Only the last call for a
+ * stream may have a length which is not a multiple of AES_BLOCK_LENGTH.
+ *
+ * @key_size		Size of the aes key (in bits)
+ * @key_exp		Expanded key to use
+ * @iv			Initial counter block, which is updated
+ * @src			Source data
+ * @dst			Destination buffer, which may be the same as @src
+ * @num_bytes		Number of bytes to process
+ */
+void aes_ctr_crypt(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		   u32 num_bytes);
+
+/**
+ * aes_ctr_inc() - Increment an AES CTR counter block
+ *
+ * @ctr			Counter block, AES_BLOCK_LENGTH bytes
+ */
+void aes_ctr_inc(u8 *ctr);
+
+/*
+ * Portable implementations of the block operations above, for use by
+ * accelerated versions when the hardware support is missing
+ */
+void aes_cbc_encrypt_blocks_generic(u32 key_size, u8 *key_exp, u8 *iv,
+				    u8 *src, u8 *dst, u32 num_aes_blocks);
+void aes_cbc_decrypt_blocks_generic(u32 key_size, u8 *key_exp, u8 *iv,
+				    u8 *src, u8 *dst, u32 num_aes_blocks);
+void aes_ctr_crypt_generic(u32 key_size, u8 *key_exp, u8 *iv, u8 *src,
+			   u8 *dst, u32 num_bytes);
+
+/*
+ * Constant-time bitsliced implementation (CONFIG_AES_CT), used by the
+ * portable code when enabled. The key schedule is still the one from
+ * aes_expand_key().
+ */
+u32 aes_ct_sub_word(u32 word);
+void aes_ct_encrypt_block(u32 key_size, u8 *in, u8 *key_exp, u8 *out);
+void aes_ct_decrypt_block(u32 key_size, u8 *in, u8 *key_exp, u8 *out);
+void aes_ct_cbc_encrypt(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			u32 num_aes_blocks);
+void aes_ct_cbc_decrypt(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			u32 num_aes_blocks);
+void aes_ct_ctr_crypt(u32 key_size, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		      u32 num_bytes);
+
 #endif /* _AES_REF_H_ */
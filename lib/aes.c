@@ -30,6 +30,13 @@
 #endif
 #include "uboot_aes.h"
 
+/* Use the constant-time code in lib/aes/aes-ct.c instead of the tables */
+#if !defined(USE_HOSTCC) && defined(CONFIG_AES_CT)
+#define aes_use_ct()	1
+#else
+#define aes_use_ct()	0
+#endif
+
 /* forward s-box */
 static const u8 sbox[256] = {
 	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
@@ -534,10 +541,29 @@ static u32 aes_get_keycols(u32 key_len)
 	return keycols;
 }
 
+/* apply the s-box to four bytes of the key schedule */
+static void aes_sub_word(u8 *word)
+{
+	u32 val;
+	int i;
+
+	if (aes_use_ct()) {
+		val = word[0] | word[1] << 8 | word[2] << 16 |
+			(u32)word[3] << 24;
+		val = aes_ct_sub_word(val);
+		for (i = 0; i < 4; i++)
+			word[i] = val >> (8 * i);
+		return;
+	}
+
+	for (i = 0; i < 4; i++)
+		word[i] = sbox[word[i]];
+}
+
 /* produce AES_STATECOLS bytes for each round */
 void aes_expand_key(u8 *key, u32 key_len, u8 *expkey)
 {
-	u8 tmp0, tmp1, tmp2, tmp3, tmp4;
+	u8 tmp[4];
 	u32 idx, aes_rounds, aes_keycols;
 
 	aes_rounds = aes_get_rounds(key_len);
@@ -546,27 +572,23 @@ void aes_expand_key(u8 *key, u32 key_len, u8 *expkey)
 	memcpy(expkey, key, key_len);
 
 	for (idx = aes_keycols; idx < AES_STATECOLS * (aes_rounds + 1); idx++) {
-		tmp0 = expkey[4*idx - 4];
-		tmp1 = expkey[4*idx - 3];
-		tmp2 = expkey[4*idx - 2];
-		tmp3 = expkey[4*idx - 1];
 		if (!(idx % aes_keycols)) {
-			tmp4 = tmp3;
-			tmp3 = sbox[tmp0];
-			tmp0 = sbox[tmp1] ^ rcon[idx / aes_keycols];
-			tmp1 = sbox[tmp2];
-			tmp2 = sbox[tmp4];
-		} else if ((aes_keycols > 6) && (idx % aes_keycols == 4)) {
-			tmp0 = sbox[tmp0];
-			tmp1 = sbox[tmp1];
-			tmp2 = sbox[tmp2];
-			tmp3 = sbox[tmp3];
+			tmp[0] = expkey[4*idx - 3];
+			tmp[1] = expkey[4*idx - 2];
+			tmp[2] = expkey[4*idx - 1];
+			tmp[3] = expkey[4*idx - 4];
+			aes_sub_word(tmp);
+			tmp[0] ^= rcon[idx / aes_keycols];
+		} else {
+			memcpy(tmp, &expkey[4*idx - 4], sizeof(tmp));
+			if ((aes_keycols > 6) && (idx % aes_keycols == 4))
+				aes_sub_word(tmp);
 		}
 
-		expkey[4*idx+0] = expkey[4*idx - 4*aes_keycols + 0] ^ tmp0;
-		expkey[4*idx+1] = expkey[4*idx - 4*aes_keycols + 1] ^ tmp1;
-		expkey[4*idx+2] = expkey[4*idx - 4*aes_keycols + 2] ^ tmp2;
-		expkey[4*idx+3] = expkey[4*idx - 4*aes_keycols + 3] ^ tmp3;
+		expkey[4*idx+0] = expkey[4*idx - 4*aes_keycols + 0] ^ tmp[0];
+		expkey[4*idx+1] = expkey[4*idx - 4*aes_keycols + 1] ^ tmp[1];
+		expkey[4*idx+2] = expkey[4*idx - 4*aes_keycols + 2] ^ tmp[2];
+		expkey[4*idx+3] = expkey[4*idx - 4*aes_keycols + 3] ^ tmp[3];
 	}
 }
 
@@ -576,6 +598,11 @@ void aes_encrypt(u32 key_len, u8 *in, u8 *expkey, u8 *out)
 	u8 state[AES_STATECOLS * 4];
 	u32 round, aes_rounds;
 
+	if (aes_use_ct()) {
+		aes_ct_encrypt_block(key_len, in, expkey, out);
+		return;
+	}
+
 	aes_rounds = aes_get_rounds(key_len);
 
 	memcpy(state, in, AES_STATECOLS * 4);
@@ -599,6 +626,11 @@ void aes_decrypt(u32 key_len, u8 *in, u8 *expkey, u8 *out)
 	u8 state[AES_STATECOLS * 4];
 	int round, aes_rounds;
 
+	if (aes_use_ct()) {
+		aes_ct_decrypt_block(key_len, in, expkey, out);
+		return;
+	}
+
 	aes_rounds = aes_get_rounds(key_len);
 
 	memcpy(state, in, sizeof(state));
@@ -633,13 +665,30 @@ void aes_apply_cbc_chain_data(u8 *cbc_chain_data, u8 *src, u8 *dst)
 		*dst++ = *src++ ^ *cbc_chain_data++;
 }
 
-void aes_cbc_encrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
-			    u32 num_aes_blocks)
+void aes_ctr_inc(u8 *ctr)
+{
+	int i;
+
+	/* the whole block is a big-endian counter, as in NIST SP 800-38A */
+	for (i = AES_BLOCK_LENGTH - 1; i >= 0; i--) {
+		if (++ctr[i])
+			break;
+	}
+}
+
+void aes_cbc_encrypt_blocks_generic(u32 key_len, u8 *key_exp, u8 *iv, u8 *src,
+				    u8 *dst, u32 num_aes_blocks)
 {
 	u8 tmp_data[AES_BLOCK_LENGTH];
 	u8 *cbc_chain_data = iv;
 	u32 i;
 
+	if (aes_use_ct()) {
+		aes_ct_cbc_encrypt(key_len, key_exp, iv, src, dst,
+				   num_aes_blocks);
+		return;
+	}
+
 	for (i = 0; i < num_aes_blocks; i++) {
 		debug("encrypt_object: block %d of %d\n", i, num_aes_blocks);
 		debug_print_vector("AES Src", AES_BLOCK_LENGTH, src);
@@ -659,14 +708,20 @@ void aes_cbc_encrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 	}
 }
 
-void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
-			    u32 num_aes_blocks)
+void aes_cbc_decrypt_blocks_generic(u32 key_len, u8 *key_exp, u8 *iv, u8 *src,
+				    u8 *dst, u32 num_aes_blocks)
 {
 	u8 tmp_data[AES_BLOCK_LENGTH], tmp_block[AES_BLOCK_LENGTH];
 	/* Convenient array of 0's for IV */
 	u8 cbc_chain_data[AES_BLOCK_LENGTH];
 	u32 i;
 
+	if (aes_use_ct()) {
+		aes_ct_cbc_decrypt(key_len, key_exp, iv, src, dst,
+				   num_aes_blocks);
+		return;
+	}
+
 	memcpy(cbc_chain_data, iv, AES_BLOCK_LENGTH);
 	for (i = 0; i < num_aes_blocks; i++) {
 		debug("encrypt_object: block %d of %d\n", i, num_aes_blocks);
@@ -688,3 +743,51 @@ void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
 		dst += AES_BLOCK_LENGTH;
 	}
 }
+
+void aes_ctr_crypt_generic(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			   u32 num_bytes)
+{
+	u8 tmp_data[AES_BLOCK_LENGTH];
+	u32 i, len;
+
+	if (aes_use_ct()) {
+		aes_ct_ctr_crypt(key_len, key_exp, iv, src, dst, num_bytes);
+		return;
+	}
+
+	while (num_bytes) {
+		len = num_bytes < AES_BLOCK_LENGTH ? num_bytes :
+			AES_BLOCK_LENGTH;
+		aes_encrypt(key_len, iv, key_exp, tmp_data);
+		aes_ctr_inc(iv);
+		for (i = 0; i < len; i++)
+			dst[i] = src[i] ^ tmp_data[i];
+		src += len;
+		dst += len;
+		num_bytes -= len;
+	}
+}
+
+/*
+ * These may be replaced by an accelerated implementation, which can fall back
+ * to the generic functions above
+ */
+__weak void aes_cbc_encrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src,
+				   u8 *dst, u32 num_aes_blocks)
+{
+	aes_cbc_encrypt_blocks_generic(key_len, key_exp, iv, src, dst,
+				       num_aes_blocks);
+}
+
+__weak void aes_cbc_decrypt_blocks(u32 key_len, u8 *key_exp, u8 *iv, u8 *src,
+				   u8 *dst, u32 num_aes_blocks)
+{
+	aes_cbc_decrypt_blocks_generic(key_len, key_exp, iv, src, dst,
+				       num_aes_blocks);
+}
+
+__weak void aes_ctr_crypt(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			  u32 num_bytes)
+{
+	aes_ctr_crypt_generic(key_len, key_exp, iv, src, dst, num_bytes);
+}
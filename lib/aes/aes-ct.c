@@ -0,0 +1,628 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Constant-time bitsliced AES
+ *
+ * The table-driven code in lib/aes.c indexes its tables with secret data, so
+ * its timing depends on the key and on the data going through the cache. This
+ * implementation instead works on four blocks at once in a bitsliced form,
+ * with the S-box computed as a boolean circuit, so that it does no
+ * data-dependent memory access or branch at all.
+ *
+ * It follows the 64-bit 'ct64' implementation in BearSSL by Thomas Pornin
+ * (MIT licence), including the Boyar-Peralta S-box circuit.
+ */
+
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <linux/types.h>
+#include <asm/unaligned.h>
+#include <uboot_aes.h>
+
+/* Number of blocks processed together */
+#define AES_CT_LANES	4
+
+/**
+ * struct aes_ct_key - bitsliced key schedule
+ *
+ * @sk:		Eight 64-bit words per round key
+ * @rounds:	Number of rounds
+ */
+struct aes_ct_key {
+	u64 sk[8 * (AES256_ROUNDS + 1)];
+	u32 rounds;
+};
+
+/*
+ * Boyar-Peralta S-box circuit, applied to the eight bit planes in q[]
+ */
+static void aes_ct_sbox(u64 *q)
+{
+	u64 x0, x1, x2, x3, x4, x5, x6, x7;
+	u64 y1, y2, y3, y4, y5, y6, y7, y8, y9;
+	u64 y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+	u64 y20, y21;
+	u64 z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+	u64 z10, z11, z12, z13, z14, z15, z16, z17;
+	u64 t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+	u64 t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+	u64 t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+	u64 t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+	u64 t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+	u64 t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+	u64 t60, t61, t62, t63, t64, t65, t66, t67;
+	u64 s0, s1, s2, s3, s4, s5, s6, s7;
+
+	x0 = q[7];
+	x1 = q[6];
+	x2 = q[5];
+	x3 = q[4];
+	x4 = q[3];
+	x5 = q[2];
+	x6 = q[1];
+	x7 = q[0];
+
+	/* Top linear transformation */
+	y14 = x3 ^ x5;
+	y13 = x0 ^ x6;
+	y9 = x0 ^ x3;
+	y8 = x0 ^ x5;
+	t0 = x1 ^ x2;
+	y1 = t0 ^ x7;
+	y4 = y1 ^ x3;
+	y12 = y13 ^ y14;
+	y2 = y1 ^ x0;
+	y5 = y1 ^ x6;
+	y3 = y5 ^ y8;
+	t1 = x4 ^ y12;
+	y15 = t1 ^ x5;
+	y20 = t1 ^ x1;
+	y6 = y15 ^ x7;
+	y10 = y15 ^ t0;
+	y11 = y20 ^ y9;
+	y7 = x7 ^ y11;
+	y17 = y10 ^ y11;
+	y19 = y10 ^ y8;
+	y16 = t0 ^ y11;
+	y21 = y13 ^ y16;
+	y18 = x0 ^ y16;
+
+	/* Non-linear section */
+	t2 = y12 & y15;
+	t3 = y3 & y6;
+	t4 = t3 ^ t2;
+	t5 = y4 & x7;
+	t6 = t5 ^ t2;
+	t7 = y13 & y16;
+	t8 = y5 & y1;
+	t9 = t8 ^ t7;
+	t10 = y2 & y7;
+	t11 = t10 ^ t7;
+	t12 = y9 & y11;
+	t13 = y14 & y17;
+	t14 = t13 ^ t12;
+	t15 = y8 & y10;
+	t16 = t15 ^ t12;
+	t17 = t4 ^ t14;
+	t18 = t6 ^ t16;
+	t19 = t9 ^ t14;
+	t20 = t11 ^ t16;
+	t21 = t17 ^ y20;
+	t22 = t18 ^ y19;
+	t23 = t19 ^ y21;
+	t24 = t20 ^ y18;
+
+	t25 = t21 ^ t22;
+	t26 = t21 & t23;
+	t27 = t24 ^ t26;
+	t28 = t25 & t27;
+	t29 = t28 ^ t22;
+	t30 = t23 ^ t24;
+	t31 = t22 ^ t26;
+	t32 = t31 & t30;
+	t33 = t32 ^ t24;
+	t34 = t23 ^ t33;
+	t35 = t27 ^ t33;
+	t36 = t24 & t35;
+	t37 = t36 ^ t34;
+	t38 = t27 ^ t36;
+	t39 = t29 & t38;
+	t40 = t25 ^ t39;
+
+	t41 = t40 ^ t37;
+	t42 = t29 ^ t33;
+	t43 = t29 ^ t40;
+	t44 = t33 ^ t37;
+	t45 = t42 ^ t41;
+	z0 = t44 & y15;
+	z1 = t37 & y6;
+	z2 = t33 & x7;
+	z3 = t43 & y16;
+	z4 = t40 & y1;
+	z5 = t29 & y7;
+	z6 = t42 & y11;
+	z7 = t45 & y17;
+	z8 = t41 & y10;
+	z9 = t44 & y12;
+	z10 = t37 & y3;
+	z11 = t33 & y4;
+	z12 = t43 & y13;
+	z13 = t40 & y5;
+	z14 = t29 & y2;
+	z15 = t42 & y9;
+	z16 = t45 & y14;
+	z17 = t41 & y8;
+
+	/* Bottom linear transformation */
+	t46 = z15 ^ z16;
+	t47 = z10 ^ z11;
+	t48 = z5 ^ z13;
+	t49 = z9 ^ z10;
+	t50 = z2 ^ z12;
+	t51 = z2 ^ z5;
+	t52 = z7 ^ z8;
+	t53 = z0 ^ z3;
+	t54 = z6 ^ z7;
+	t55 = z16 ^ z17;
+	t56 = z12 ^ t48;
+	t57 = t50 ^ t53;
+	t58 = z4 ^ t46;
+	t59 = z3 ^ t54;
+	t60 = t46 ^ t57;
+	t61 = z14 ^ t57;
+	t62 = t52 ^ t58;
+	t63 = t49 ^ t58;
+	t64 = z4 ^ t59;
+	t65 = t61 ^ t62;
+	t66 = z1 ^ t63;
+	s0 = t59 ^ t63;
+	s6 = t56 ^ ~t62;
+	s7 = t48 ^ ~t60;
+	t67 = t64 ^ t65;
+	s3 = t53 ^ t66;
+	s4 = t51 ^ t66;
+	s5 = t47 ^ t65;
+	s1 = t64 ^ ~s3;
+	s2 = t55 ^ ~t67;
+
+	q[7] = s0;
+	q[6] = s1;
+	q[5] = s2;
+	q[4] = s3;
+	q[3] = s4;
+	q[2] = s5;
+	q[1] = s6;
+	q[0] = s7;
+}
+
+/* Inverse of the affine transform in the S-box, on bit planes */
+static void aes_ct_inv_affine(u64 *q)
+{
+	u64 q0, q1, q2, q3, q4, q5, q6, q7;
+
+	q0 = ~q[0];
+	q1 = ~q[1];
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = ~q[5];
+	q6 = ~q[6];
+	q7 = q[7];
+	q[7] = q1 ^ q4 ^ q6;
+	q[6] = q0 ^ q3 ^ q5;
+	q[5] = q7 ^ q2 ^ q4;
+	q[4] = q6 ^ q1 ^ q3;
+	q[3] = q5 ^ q0 ^ q2;
+	q[2] = q4 ^ q7 ^ q1;
+	q[1] = q3 ^ q6 ^ q0;
+	q[0] = q2 ^ q5 ^ q7;
+}
+
+/*
+ * The inverse S-box reuses the forward circuit: the inversion in GF(2^8) is
+ * its own inverse, so only the affine transform around it has to be undone
+ */
+static void aes_ct_inv_sbox(u64 *q)
+{
+	aes_ct_inv_affine(q);
+	aes_ct_sbox(q);
+	aes_ct_inv_affine(q);
+}
+
+#define AES_CT_SWAP(cl, ch, s, x, y)	do { \
+		u64 a = (x), b = (y); \
+		(x) = (a & (cl)) | ((b & (cl)) << (s)); \
+		(y) = ((a & (ch)) >> (s)) | (b & (ch)); \
+	} while (0)
+
+#define AES_CT_SWAP2(x, y)	AES_CT_SWAP(0x5555555555555555ULL, \
+					    0xaaaaaaaaaaaaaaaaULL, 1, x, y)
+#define AES_CT_SWAP4(x, y)	AES_CT_SWAP(0x3333333333333333ULL, \
+					    0xccccccccccccccccULL, 2, x, y)
+#define AES_CT_SWAP8(x, y)	AES_CT_SWAP(0x0f0f0f0f0f0f0f0fULL, \
+					    0xf0f0f0f0f0f0f0f0ULL, 4, x, y)
+
+/* Move between interleaved words and bit planes; this is an involution */
+static void aes_ct_ortho(u64 *q)
+{
+	AES_CT_SWAP2(q[0], q[1]);
+	AES_CT_SWAP2(q[2], q[3]);
+	AES_CT_SWAP2(q[4], q[5]);
+	AES_CT_SWAP2(q[6], q[7]);
+
+	AES_CT_SWAP4(q[0], q[2]);
+	AES_CT_SWAP4(q[1], q[3]);
+	AES_CT_SWAP4(q[4], q[6]);
+	AES_CT_SWAP4(q[5], q[7]);
+
+	AES_CT_SWAP8(q[0], q[4]);
+	AES_CT_SWAP8(q[1], q[5]);
+	AES_CT_SWAP8(q[2], q[6]);
+	AES_CT_SWAP8(q[3], q[7]);
+}
+
+/* Spread a block (as four little-endian words) over two 64-bit words */
+static void aes_ct_interleave_in(u64 *q0, u64 *q1, const u32 *w)
+{
+	u64 x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+
+	x0 |= x0 << 16;
+	x1 |= x1 << 16;
+	x2 |= x2 << 16;
+	x3 |= x3 << 16;
+	x0 &= 0x0000ffff0000ffffULL;
+	x1 &= 0x0000ffff0000ffffULL;
+	x2 &= 0x0000ffff0000ffffULL;
+	x3 &= 0x0000ffff0000ffffULL;
+	x0 |= x0 << 8;
+	x1 |= x1 << 8;
+	x2 |= x2 << 8;
+	x3 |= x3 << 8;
+	x0 &= 0x00ff00ff00ff00ffULL;
+	x1 &= 0x00ff00ff00ff00ffULL;
+	x2 &= 0x00ff00ff00ff00ffULL;
+	x3 &= 0x00ff00ff00ff00ffULL;
+	*q0 = x0 | (x2 << 8);
+	*q1 = x1 | (x3 << 8);
+}
+
+static void aes_ct_interleave_out(u32 *w, u64 q0, u64 q1)
+{
+	u64 x0, x1, x2, x3;
+
+	x0 = q0 & 0x00ff00ff00ff00ffULL;
+	x1 = q1 & 0x00ff00ff00ff00ffULL;
+	x2 = (q0 >> 8) & 0x00ff00ff00ff00ffULL;
+	x3 = (q1 >> 8) & 0x00ff00ff00ff00ffULL;
+	x0 |= x0 >> 8;
+	x1 |= x1 >> 8;
+	x2 |= x2 >> 8;
+	x3 |= x3 >> 8;
+	x0 &= 0x0000ffff0000ffffULL;
+	x1 &= 0x0000ffff0000ffffULL;
+	x2 &= 0x0000ffff0000ffffULL;
+	x3 &= 0x0000ffff0000ffffULL;
+	w[0] = (u32)x0 | (u32)(x0 >> 16);
+	w[1] = (u32)x1 | (u32)(x1 >> 16);
+	w[2] = (u32)x2 | (u32)(x2 >> 16);
+	w[3] = (u32)x3 | (u32)(x3 >> 16);
+}
+
+/* Load up to AES_CT_LANES blocks into bit planes; missing blocks are zero */
+static void aes_ct_load(u64 *q, const u8 *src, uint blocks)
+{
+	u32 w[4 * AES_CT_LANES];
+	uint i;
+
+	memset(w, '\0', sizeof(w));
+	for (i = 0; i < 4 * blocks; i++)
+		w[i] = get_unaligned_le32(src + 4 * i);
+	for (i = 0; i < AES_CT_LANES; i++)
+		aes_ct_interleave_in(&q[i], &q[i + 4], &w[4 * i]);
+	aes_ct_ortho(q);
+}
+
+static void aes_ct_store(u8 *dst, u64 *q, uint blocks)
+{
+	u32 w[4 * AES_CT_LANES];
+	uint i;
+
+	aes_ct_ortho(q);
+	for (i = 0; i < AES_CT_LANES; i++)
+		aes_ct_interleave_out(&w[4 * i], q[i], q[i + 4]);
+	for (i = 0; i < 4 * blocks; i++)
+		put_unaligned_le32(w[i], dst + 4 * i);
+}
+
+/* Convert a key schedule from aes_expand_key() to bitsliced form */
+static void aes_ct_setup(struct aes_ct_key *key, u32 key_len,
+			 const u8 *key_exp)
+{
+	u32 w[4];
+	u64 *q;
+	uint r, i;
+
+	key->rounds = AES128_ROUNDS;
+	if (key_len == AES192_KEY_LENGTH)
+		key->rounds = AES192_ROUNDS;
+	else if (key_len == AES256_KEY_LENGTH)
+		key->rounds = AES256_ROUNDS;
+
+	/* Each round key is the same in all lanes */
+	for (r = 0; r <= key->rounds; r++) {
+		q = &key->sk[8 * r];
+		for (i = 0; i < 4; i++)
+			w[i] = get_unaligned_le32(key_exp + 16 * r + 4 * i);
+		aes_ct_interleave_in(&q[0], &q[4], w);
+		for (i = 1; i < 4; i++) {
+			q[i] = q[0];
+			q[i + 4] = q[4];
+		}
+		aes_ct_ortho(q);
+	}
+}
+
+static void aes_ct_add_round_key(u64 *q, const u64 *sk)
+{
+	uint i;
+
+	for (i = 0; i < 8; i++)
+		q[i] ^= sk[i];
+}
+
+static void aes_ct_shift_rows(u64 *q)
+{
+	uint i;
+
+	for (i = 0; i < 8; i++) {
+		u64 x = q[i];
+
+		q[i] = (x & 0x000000000000ffffULL) |
+			((x & 0x00000000fff00000ULL) >> 4) |
+			((x & 0x00000000000f0000ULL) << 12) |
+			((x & 0x0000ff0000000000ULL) >> 8) |
+			((x & 0x000000ff00000000ULL) << 8) |
+			((x & 0xf000000000000000ULL) >> 12) |
+			((x & 0x0fff000000000000ULL) << 4);
+	}
+}
+
+static void aes_ct_inv_shift_rows(u64 *q)
+{
+	uint i;
+
+	for (i = 0; i < 8; i++) {
+		u64 x = q[i];
+
+		q[i] = (x & 0x000000000000ffffULL) |
+			((x & 0x000000000fff0000ULL) << 4) |
+			((x & 0x00000000f0000000ULL) >> 12) |
+			((x & 0x000000ff00000000ULL) << 8) |
+			((x & 0x0000ff0000000000ULL) >> 8) |
+			((x & 0x000f000000000000ULL) << 12) |
+			((x & 0xfff0000000000000ULL) >> 4);
+	}
+}
+
+static inline u64 aes_ct_rotr32(u64 x)
+{
+	return (x << 32) | (x >> 32);
+}
+
+static void aes_ct_mix_columns(u64 *q)
+{
+	u64 q0, q1, q2, q3, q4, q5, q6, q7;
+	u64 r0, r1, r2, r3, r4, r5, r6, r7;
+
+	q0 = q[0];
+	q1 = q[1];
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = q[5];
+	q6 = q[6];
+	q7 = q[7];
+	r0 = (q0 >> 16) | (q0 << 48);
+	r1 = (q1 >> 16) | (q1 << 48);
+	r2 = (q2 >> 16) | (q2 << 48);
+	r3 = (q3 >> 16) | (q3 << 48);
+	r4 = (q4 >> 16) | (q4 << 48);
+	r5 = (q5 >> 16) | (q5 << 48);
+	r6 = (q6 >> 16) | (q6 << 48);
+	r7 = (q7 >> 16) | (q7 << 48);
+
+	q[0] = q7 ^ r7 ^ r0 ^ aes_ct_rotr32(q0 ^ r0);
+	q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ aes_ct_rotr32(q1 ^ r1);
+	q[2] = q1 ^ r1 ^ r2 ^ aes_ct_rotr32(q2 ^ r2);
+	q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ aes_ct_rotr32(q3 ^ r3);
+	q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ aes_ct_rotr32(q4 ^ r4);
+	q[5] = q4 ^ r4 ^ r5 ^ aes_ct_rotr32(q5 ^ r5);
+	q[6] = q5 ^ r5 ^ r6 ^ aes_ct_rotr32(q6 ^ r6);
+	q[7] = q6 ^ r6 ^ r7 ^ aes_ct_rotr32(q7 ^ r7);
+}
+
+static void aes_ct_inv_mix_columns(u64 *q)
+{
+	u64 q0, q1, q2, q3, q4, q5, q6, q7;
+	u64 r0, r1, r2, r3, r4, r5, r6, r7;
+
+	q0 = q[0];
+	q1 = q[1];
+	q2 = q[2];
+	q3 = q[3];
+	q4 = q[4];
+	q5 = q[5];
+	q6 = q[6];
+	q7 = q[7];
+	r0 = (q0 >> 16) | (q0 << 48);
+	r1 = (q1 >> 16) | (q1 << 48);
+	r2 = (q2 >> 16) | (q2 << 48);
+	r3 = (q3 >> 16) | (q3 << 48);
+	r4 = (q4 >> 16) | (q4 << 48);
+	r5 = (q5 >> 16) | (q5 << 48);
+	r6 = (q6 >> 16) | (q6 << 48);
+	r7 = (q7 >> 16) | (q7 << 48);
+
+	q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^
+		aes_ct_rotr32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+	q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+	q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+	q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^
+		aes_ct_rotr32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+	q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+	q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+	q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+	q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^
+		aes_ct_rotr32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+static void aes_ct_encrypt(const struct aes_ct_key *key, u64 *q)
+{
+	uint r;
+
+	aes_ct_add_round_key(q, key->sk);
+	for (r = 1; r < key->rounds; r++) {
+		aes_ct_sbox(q);
+		aes_ct_shift_rows(q);
+		aes_ct_mix_columns(q);
+		aes_ct_add_round_key(q, &key->sk[8 * r]);
+	}
+	aes_ct_sbox(q);
+	aes_ct_shift_rows(q);
+	aes_ct_add_round_key(q, &key->sk[8 * key->rounds]);
+}
+
+static void aes_ct_decrypt(const struct aes_ct_key *key, u64 *q)
+{
+	uint r;
+
+	aes_ct_add_round_key(q, &key->sk[8 * key->rounds]);
+	for (r = key->rounds - 1; r > 0; r--) {
+		aes_ct_inv_shift_rows(q);
+		aes_ct_inv_sbox(q);
+		aes_ct_add_round_key(q, &key->sk[8 * r]);
+		aes_ct_inv_mix_columns(q);
+	}
+	aes_ct_inv_shift_rows(q);
+	aes_ct_inv_sbox(q);
+	aes_ct_add_round_key(q, key->sk);
+}
+
+u32 aes_ct_sub_word(u32 x)
+{
+	u64 q[8];
+
+	memset(q, '\0', sizeof(q));
+	q[0] = x;
+	aes_ct_ortho(q);
+	aes_ct_sbox(q);
+	aes_ct_ortho(q);
+
+	return q[0];
+}
+
+void aes_ct_encrypt_block(u32 key_len, u8 *in, u8 *key_exp, u8 *out)
+{
+	struct aes_ct_key key;
+	u64 q[8];
+
+	aes_ct_setup(&key, key_len, key_exp);
+	aes_ct_load(q, in, 1);
+	aes_ct_encrypt(&key, q);
+	aes_ct_store(out, q, 1);
+}
+
+void aes_ct_decrypt_block(u32 key_len, u8 *in, u8 *key_exp, u8 *out)
+{
+	struct aes_ct_key key;
+	u64 q[8];
+
+	aes_ct_setup(&key, key_len, key_exp);
+	aes_ct_load(q, in, 1);
+	aes_ct_decrypt(&key, q);
+	aes_ct_store(out, q, 1);
+}
+
+void aes_ct_cbc_encrypt(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			u32 num_aes_blocks)
+{
+	u8 chain[AES_BLOCK_LENGTH];
+	struct aes_ct_key key;
+	u64 q[8];
+	u32 i;
+
+	/* Each block depends on the last, so only one lane is used */
+	aes_ct_setup(&key, key_len, key_exp);
+	memcpy(chain, iv, AES_BLOCK_LENGTH);
+	for (i = 0; i < num_aes_blocks; i++) {
+		aes_apply_cbc_chain_data(chain, src, chain);
+		aes_ct_load(q, chain, 1);
+		aes_ct_encrypt(&key, q);
+		aes_ct_store(chain, q, 1);
+		memcpy(dst, chain, AES_BLOCK_LENGTH);
+		src += AES_BLOCK_LENGTH;
+		dst += AES_BLOCK_LENGTH;
+	}
+}
+
+void aes_ct_cbc_decrypt(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+			u32 num_aes_blocks)
+{
+	u8 chain[(AES_CT_LANES + 1) * AES_BLOCK_LENGTH];
+	u8 buf[AES_CT_LANES * AES_BLOCK_LENGTH];
+	struct aes_ct_key key;
+	uint n, i;
+	u64 q[8];
+
+	aes_ct_setup(&key, key_len, key_exp);
+	memcpy(chain, iv, AES_BLOCK_LENGTH);
+	while (num_aes_blocks) {
+		n = min_t(u32, num_aes_blocks, AES_CT_LANES);
+
+		/* Keep the ciphertext, since @dst may be the same as @src */
+		memcpy(chain + AES_BLOCK_LENGTH, src, n * AES_BLOCK_LENGTH);
+		aes_ct_load(q, src, n);
+		aes_ct_decrypt(&key, q);
+		aes_ct_store(buf, q, n);
+		for (i = 0; i < n; i++)
+			aes_apply_cbc_chain_data(chain + i * AES_BLOCK_LENGTH,
+						 buf + i * AES_BLOCK_LENGTH,
+						 dst + i * AES_BLOCK_LENGTH);
+		memcpy(chain, chain + n * AES_BLOCK_LENGTH, AES_BLOCK_LENGTH);
+		src += n * AES_BLOCK_LENGTH;
+		dst += n * AES_BLOCK_LENGTH;
+		num_aes_blocks -= n;
+	}
+}
+
+void aes_ct_ctr_crypt(u32 key_len, u8 *key_exp, u8 *iv, u8 *src, u8 *dst,
+		      u32 num_bytes)
+{
+	u8 ctr[AES_CT_LANES * AES_BLOCK_LENGTH];
+	struct aes_ct_key key;
+	uint n, i, len;
+	u64 q[8];
+
+	aes_ct_setup(&key, key_len, key_exp);
+	while (num_bytes) {
+		len = min_t(u32, num_bytes, sizeof(ctr));
+		n = DIV_ROUND_UP(len, AES_BLOCK_LENGTH);
+		for (i = 0; i < n; i++) {
+			memcpy(ctr + i * AES_BLOCK_LENGTH, iv,
+			       AES_BLOCK_LENGTH);
+			aes_ctr_inc(iv);
+		}
+		aes_ct_load(q, ctr, n);
+		aes_ct_encrypt(&key, q);
+		aes_ct_store(ctr, q, n);
+		for (i = 0; i < len; i++)
+			dst[i] = src[i] ^ ctr[i];
+		src += len;
+		dst += len;
+		num_bytes -= len;
+	}
+}
@@ -5,10 +5,20 @@
 
 #ifndef USE_HOSTCC
 #include <malloc.h>
+#include <linux/compiler.h>
 #endif
 #include <image.h>
 #include <uboot_aes.h>
 
+#ifndef USE_HOSTCC
+/* Clear the expanded key, so that it is not left on the stack */
+static void aes_wipe_key(u8 *key_exp)
+{
+	memset(key_exp, '\0', AES256_EXPAND_KEY_LENGTH);
+	barrier_data(key_exp);
+}
+#endif
+
 int image_aes_decrypt(struct image_cipher_info *info,
 		      const void *cipher, size_t cipher_len,
 		      void **data, size_t *size)
@@ -34,6 +44,34 @@ int image_aes_decrypt(struct image_cipher_info *info,
 
 	aes_cbc_decrypt_blocks(key_len, key_exp, (u8 *)info->iv,
 			       (u8 *)cipher, *data, aes_blocks);
+	aes_wipe_key(key_exp);
+#endif
+
+	return 0;
+}
+
+int image_aes_ctr_decrypt(struct image_cipher_info *info,
+			  const void *cipher, size_t cipher_len,
+			  void **data, size_t *size)
+{
+#ifndef USE_HOSTCC
+	unsigned char key_exp[AES256_EXPAND_KEY_LENGTH];
+	unsigned char ctr[AES_BLOCK_LENGTH];
+	unsigned int key_len = info->cipher->key_len;
+
+	*data = malloc(cipher_len);
+	if (!*data) {
+		printf("Can't allocate memory to decrypt\n");
+		return -ENOMEM;
+	}
+	*size = info->size_unciphered;
+
+	aes_expand_key((u8 *)info->key, key_len, key_exp);
+
+	/* The counter is updated as we go, so work on a copy */
+	memcpy(ctr, info->iv, AES_BLOCK_LENGTH);
+	aes_ctr_crypt(key_len, key_exp, ctr, (u8 *)cipher, *data, cipher_len);
+	aes_wipe_key(key_exp);
 #endif
 
 	return 0;
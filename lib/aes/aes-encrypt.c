@@ -128,14 +128,11 @@ int image_aes_add_cipher_data(struct image_cipher_info *info, void *keydest,
 	if (ret)
 		goto done;
 
+	/* A generated IV is stored in the FIT by fit_image_process_cipher() */
 	if (info->ivname)
 		/* Store the IV in the u-boot device tree */
 		ret = fdt_setprop(keydest, node, "iv",
 				  info->iv, info->cipher->iv_len);
-	else
-		/* Store the IV in the FIT image */
-		ret = fdt_setprop(fit, node_noffset, "iv",
-				  info->iv, info->cipher->iv_len);
 
 	if (!ret)
 		ret = fdt_setprop(keydest, node, "key",
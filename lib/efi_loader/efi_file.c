@@ -34,6 +34,9 @@ struct file_handle {
 	int isdir;
 	u64 open_mode;
 
+	/* for reading a file: */
+	struct fs_file *file;
+
 	/* for reading a directory: */
 	struct fs_dir_stream *dirs;
 	struct fs_dirent *dent;
@@ -365,6 +368,7 @@ out:
 
 static efi_status_t file_close(struct file_handle *fh)
 {
+	fs_file_close(fh->file);
 	fs_closedir(fh->dirs);
 	free(fh);
 	return EFI_SUCCESS;
@@ -397,6 +401,43 @@ static efi_status_t EFIAPI efi_file_delete(struct efi_file_handle *file)
 	return EFI_EXIT(ret);
 }
 
+/**
+ * efi_file_get() - open the file system file for an EFI file handle
+ *
+ * The file is opened once and then kept open until the EFI file handle is
+ * closed or written to, so that reading the file in chunks does not mount
+ * the file system and look up the path again for each chunk.
+ *
+ * @fh:		file handle
+ * Return:	status code
+ */
+static efi_status_t efi_file_get(struct file_handle *fh)
+{
+	if (fh->file)
+		return EFI_SUCCESS;
+
+	if (set_blk_dev(fh))
+		return EFI_DEVICE_ERROR;
+	if (fs_file_open(fh->path, &fh->file))
+		return EFI_DEVICE_ERROR;
+
+	return EFI_SUCCESS;
+}
+
+/**
+ * efi_file_put() - close the file system file for an EFI file handle
+ *
+ * This must be called when the file is modified, as the file system file
+ * caches its size.
+ *
+ * @fh:		file handle
+ */
+static void efi_file_put(struct file_handle *fh)
+{
+	fs_file_close(fh->file);
+	fh->file = NULL;
+}
+
 /**
  * efi_get_file_size() - determine the size of a file
  *
@@ -407,6 +448,14 @@ static efi_status_t EFIAPI efi_file_delete(struct efi_file_handle *file)
 static efi_status_t efi_get_file_size(struct file_handle *fh,
 				      loff_t *file_size)
 {
+	if (!fh->isdir) {
+		if (efi_file_get(fh) != EFI_SUCCESS ||
+		    fs_file_size(fh->file, file_size))
+			return EFI_DEVICE_ERROR;
+
+		return EFI_SUCCESS;
+	}
+
 	if (set_blk_dev(fh))
 		return EFI_DEVICE_ERROR;
 
@@ -475,10 +524,8 @@ static efi_status_t file_read(struct file_handle *fh, u64 *buffer_size,
 		return ret;
 	}
 
-	if (set_blk_dev(fh))
-		return EFI_DEVICE_ERROR;
-	if (fs_read(fh->path, map_to_sysmem(buffer), fh->offset,
-		    *buffer_size, &actread))
+	if (fs_file_pread(fh->file, buffer, fh->offset, *buffer_size,
+			  &actread))
 		return EFI_DEVICE_ERROR;
 
 	*buffer_size = actread;
@@ -675,6 +722,7 @@ static efi_status_t efi_file_write_int(struct efi_file_handle *this,
 	if (!*buffer_size)
 		goto out;
 
+	efi_file_put(fh);
 	if (set_blk_dev(fh)) {
 		ret = EFI_DEVICE_ERROR;
 		goto out;
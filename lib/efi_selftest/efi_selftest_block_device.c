@@ -305,7 +305,7 @@ static int execute(void)
 	struct efi_device_path *dp_partition;
 	struct efi_block_io *block_io_protocol;
 	struct efi_simple_file_system_protocol *file_system;
-	struct efi_file_handle *root, *file;
+	struct efi_file_handle *root, *file, *file2;
 	struct {
 		struct efi_file_system_info info;
 		u16 label[12];
@@ -476,6 +476,48 @@ static int execute(void)
 		return EFI_ST_FAILURE;
 	}
 
+	/* Read file through two handles at once */
+	ret = root->open(root, &file, u"hello.txt", EFI_FILE_MODE_READ,
+			 0);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open file\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = root->open(root, &file2, u"hello.txt", EFI_FILE_MODE_READ,
+			 0);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open file twice\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = file2->setpos(file2, 6);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("SetPosition failed\n");
+		return EFI_ST_FAILURE;
+	}
+	buf_size = 5;
+	ret = file->read(file, &buf_size, buf);
+	if (ret != EFI_SUCCESS || buf_size != 5 || memcmp(buf, "Hello", 5)) {
+		efi_st_error("Failed to read file through first handle\n");
+		return EFI_ST_FAILURE;
+	}
+	buf_size = 5;
+	ret = file2->read(file2, &buf_size, buf);
+	if (ret != EFI_SUCCESS || buf_size != 5 || memcmp(buf, "world", 5)) {
+		efi_st_error("Failed to read file through second handle\n");
+		return EFI_ST_FAILURE;
+	}
+	buf_size = 6;
+	ret = file->read(file, &buf_size, buf);
+	if (ret != EFI_SUCCESS || buf_size != 6 || memcmp(buf, " world", 6)) {
+		efi_st_error("Failed to read file through first handle\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = file->close(file);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close file\n");
+		return EFI_ST_FAILURE;
+	}
+
 #ifdef CONFIG_FAT_WRITE
 	/* Write file */
 	ret = root->open(root, &file, u"u-boot.txt", EFI_FILE_MODE_READ |
@@ -540,6 +582,19 @@ static int execute(void)
 	efi_st_todo("CONFIG_FAT_WRITE is not set\n");
 #endif /* CONFIG_FAT_WRITE */
 
+	/* The second handle must still read after other file accesses */
+	buf_size = sizeof(buf) - 1;
+	ret = file2->read(file2, &buf_size, buf);
+	if (ret != EFI_SUCCESS || buf_size != 2 || buf[0] != '!') {
+		efi_st_error("Failed to read file through second handle\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = file2->close(file2);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close file\n");
+		return EFI_ST_FAILURE;
+	}
+
 	/* Close volume */
 	ret = root->close(root);
 	if (ret != EFI_SUCCESS) {
@@ -646,7 +646,7 @@ int fdtdec_lookup_phandle(const void *blob, int node, const char *prop_name)
 	if (!phandle)
 		return -FDT_ERR_NOTFOUND;
 
-	lookup = fdt_node_offset_by_phandle(blob, fdt32_to_cpu(*phandle));
+	lookup = ofnode_fdt_phandle_offset(blob, fdt32_to_cpu(*phandle));
 	return lookup;
 }
 
@@ -777,8 +777,8 @@ int fdtdec_parse_phandle_with_args(const void *blob, int src_node,
 			 * below.
 			 */
 			if (cells_name || cur_index == index) {
-				node = fdt_node_offset_by_phandle(blob,
-								  phandle);
+				node = ofnode_fdt_phandle_offset(blob,
+								 phandle);
 				if (node < 0) {
 					debug("%s: could not find phandle\n",
 					      fdt_get_name(blob, src_node,
@@ -1288,6 +1288,7 @@ int fdtdec_set_ethernet_mac_address(void *fdt, const u8 *mac, size_t size)
 		return -ENOENT;
 	}
 
+	ofnode_cache_invalidate(fdt);
 	err = fdt_setprop_inplace(fdt, offset, "local-mac-address", mac, size);
 	if (err < 0)
 		return err;
@@ -1340,6 +1341,8 @@ int fdtdec_add_reserved_memory(void *blob, const char *basename,
 	fdt_size_t size;
 	char name[64];
 
+	ofnode_cache_invalidate(blob);
+
 	/* create an empty /reserved-memory node if one doesn't exist */
 	parent = fdt_path_offset(blob, "/reserved-memory");
 	if (parent < 0) {
@@ -1500,7 +1503,7 @@ int fdtdec_get_carveout(const void *blob, const char *node,
 
 	phandle = fdt32_to_cpu(prop[index]);
 
-	offset = fdt_node_offset_by_phandle(blob, phandle);
+	offset = ofnode_fdt_phandle_offset(blob, phandle);
 	if (offset < 0) {
 		debug("failed to find node for phandle %u\n", phandle);
 		return offset;
@@ -3,6 +3,7 @@
  * Copyright (c) 2013 The Chromium OS Authors.
  */
 
+#include <bootstage.h>
 #include <efi.h>
 #include <initcall.h>
 #include <log.h>
@@ -42,6 +43,20 @@ static int initcall_is_event(init_fnc_t func)
 	return 0;
 }
 
+/**
+ * initcall_timed() - Check whether to time the next initcall
+ *
+ * Return: true if initcalls are being recorded and bootstage is set up
+ */
+static bool initcall_timed(void)
+{
+#if CONFIG_IS_ENABLED(BOOTSTAGE_INITCALLS)
+	return gd->bootstage;
+#else
+	return false;
+#endif
+}
+
 /*
  * To enable debugging. add #define DEBUG at the top of the including file.
  *
@@ -53,6 +68,8 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 	const init_fnc_t *ptr;
 	enum event_t type;
 	init_fnc_t func;
+	ulong start = 0;
+	bool timed;
 	int ret = 0;
 
 	for (ptr = init_sequence; func = *ptr, !ret && func; ptr++) {
@@ -70,7 +87,15 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 			debug("initcall: %p\n", (char *)func - reloc_ofs);
 		}
 
+		timed = initcall_timed();
+		if (timed)
+			start = timer_get_boot_us();
 		ret = type ? event_notify_null(type) : func();
+		if (timed) {
+			bootstage_add_initcall(type ? (ulong)func :
+					       (ulong)func - reloc_ofs,
+					       timer_get_boot_us() - start);
+		}
 	}
 
 	if (ret) {
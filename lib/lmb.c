@@ -6,6 +6,7 @@
  * Copyright (C) 2001 Peter Bergner.
  */
 
+#include <errno.h>
 #include <efi_loader.h>
 #include <image.h>
 #include <mapmem.h>
@@ -95,14 +96,74 @@ static long lmb_regions_adjacent(struct lmb_region *rgn, unsigned long r1,
 
 static void lmb_remove_region(struct lmb_region *rgn, unsigned long r)
 {
-	unsigned long i;
+	memmove(&rgn->region[r], &rgn->region[r + 1],
+		(rgn->cnt - r - 1) * sizeof(*rgn->region));
+	rgn->cnt--;
+}
+
+/*
+ * Find the first region which ends at or above @addr. Since the regions are
+ * sorted and do not overlap, this is the only one which can contain @addr and
+ * the first one which can overlap a block starting at @addr.
+ *
+ * Return: index of the region, or rgn->cnt if there is none
+ */
+static unsigned long lmb_first_above(struct lmb_region *rgn, phys_addr_t addr)
+{
+	unsigned long lo = 0, hi = rgn->cnt;
+
+	while (lo < hi) {
+		unsigned long mid = lo + (hi - lo) / 2;
+		struct lmb_property *r = &rgn->region[mid];
 
-	for (i = r; i < rgn->cnt - 1; i++) {
-		rgn->region[i].base = rgn->region[i + 1].base;
-		rgn->region[i].size = rgn->region[i + 1].size;
-		rgn->region[i].flags = rgn->region[i + 1].flags;
+		if (r->base + r->size - 1 < addr)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
-	rgn->cnt--;
+
+	return lo;
+}
+
+/*
+ * Check whether a block to be merged into the end of region @r overlaps the
+ * next region in a way which merging that one too cannot fix
+ */
+static bool lmb_overlaps_next(struct lmb_region *rgn, unsigned long r,
+			      phys_addr_t base, phys_size_t size,
+			      enum lmb_flags flags)
+{
+	struct lmb_property *next = &rgn->region[r + 1];
+
+	if (r + 1 >= rgn->cnt ||
+	    !lmb_addrs_overlap(base, size, next->base, next->size))
+		return false;
+
+	return flags != next->flags || base + size > next->base + next->size;
+}
+
+/* Move the regions to an array of twice the size, allocated with malloc() */
+static int lmb_grow_region(struct lmb_region *rgn)
+{
+	unsigned long max = rgn->max * 2;
+	struct lmb_property *region;
+
+	/* the pre-relocation malloc() pool is dropped later */
+	if (!IS_ENABLED(CONFIG_LMB_DYNAMIC_REGIONS) ||
+	    !(gd->flags & GD_FLG_FULL_MALLOC_INIT))
+		return -ENOSPC;
+
+	region = malloc(max * sizeof(*region));
+	if (!region)
+		return -ENOMEM;
+	memcpy(region, rgn->region, rgn->cnt * sizeof(*region));
+	if (rgn->alloced)
+		free(rgn->region);
+	rgn->region = region;
+	rgn->max = max;
+	rgn->alloced = true;
+
+	return 0;
 }
 
 /* Assumption: base addr of region 1 < base addr of region 2 */
@@ -132,19 +193,25 @@ static void lmb_fix_over_lap_regions(struct lmb_region *rgn, unsigned long r1,
 
 void lmb_init(struct lmb *lmb)
 {
-#if IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
-	lmb->memory.max = CONFIG_LMB_MAX_REGIONS;
-	lmb->reserved.max = CONFIG_LMB_MAX_REGIONS;
-#else
-	lmb->memory.max = CONFIG_LMB_MEMORY_REGIONS;
-	lmb->reserved.max = CONFIG_LMB_RESERVED_REGIONS;
+	lmb->memory.max = LMB_MEMORY_REGIONS;
+	lmb->reserved.max = LMB_RESERVED_REGIONS;
 	lmb->memory.region = lmb->memory_regions;
 	lmb->reserved.region = lmb->reserved_regions;
-#endif
+	lmb->memory.alloced = false;
+	lmb->reserved.alloced = false;
 	lmb->memory.cnt = 0;
 	lmb->reserved.cnt = 0;
 }
 
+void lmb_uninit(struct lmb *lmb)
+{
+	if (lmb->memory.alloced)
+		free(lmb->memory.region);
+	if (lmb->reserved.alloced)
+		free(lmb->reserved.region);
+	lmb_init(lmb);
+}
+
 void arch_lmb_reserve_generic(struct lmb *lmb, ulong sp, ulong end, ulong align)
 {
 	ulong bank_end;
@@ -256,24 +323,23 @@ void lmb_init_and_reserve_range(struct lmb *lmb, phys_addr_t base,
 static long lmb_add_region_flags(struct lmb_region *rgn, phys_addr_t base,
 				 phys_size_t size, enum lmb_flags flags)
 {
+	phys_addr_t end = base + size - 1;
 	unsigned long coalesced = 0;
-	long adjacent, i;
-
-	if (rgn->cnt == 0) {
-		rgn->region[0].base = base;
-		rgn->region[0].size = size;
-		rgn->region[0].flags = flags;
-		rgn->cnt = 1;
-		return 0;
-	}
+	unsigned long i;
+	long adjacent;
 
-	/* First try and coalesce this LMB with another. */
-	for (i = 0; i < rgn->cnt; i++) {
+	/*
+	 * First try and coalesce this LMB with another. Only the regions from
+	 * the one just below @base to the one just above @end can touch it.
+	 */
+	for (i = lmb_first_above(rgn, base ? base - 1 : 0); i < rgn->cnt; i++) {
 		phys_addr_t rgnbase = rgn->region[i].base;
 		phys_size_t rgnsize = rgn->region[i].size;
 		phys_size_t rgnflags = rgn->region[i].flags;
-		phys_addr_t end = base + size - 1;
 		phys_addr_t rgnend = rgnbase + rgnsize - 1;
+
+		if (rgnbase > end && rgnbase != base + size)
+			break;
 		if (rgnbase <= base && end <= rgnend) {
 			if (flags == rgnflags)
 				/* Already have this region, so we're done */
@@ -285,14 +351,17 @@ static long lmb_add_region_flags(struct lmb_region *rgn, phys_addr_t base,
 		adjacent = lmb_addrs_adjacent(base, size, rgnbase, rgnsize);
 		if (adjacent > 0) {
 			if (flags != rgnflags)
-				break;
+				continue;
 			rgn->region[i].base -= size;
 			rgn->region[i].size += size;
 			coalesced++;
 			break;
 		} else if (adjacent < 0) {
+			/* the next region may still match, or overlap */
 			if (flags != rgnflags)
-				break;
+				continue;
+			if (lmb_overlaps_next(rgn, i, base, size, flags))
+				return -1;
 			rgn->region[i].size += size;
 			coalesced++;
 			break;
@@ -302,7 +371,8 @@ static long lmb_add_region_flags(struct lmb_region *rgn, phys_addr_t base,
 		}
 	}
 
-	if (i < rgn->cnt - 1 && rgn->region[i].flags == rgn->region[i + 1].flags)  {
+	if (coalesced && i < rgn->cnt - 1 &&
+	    rgn->region[i].flags == rgn->region[i + 1].flags) {
 		if (lmb_regions_adjacent(rgn, i, i + 1)) {
 			lmb_coalesce_regions(rgn, i, i + 1);
 			coalesced++;
@@ -315,29 +385,16 @@ static long lmb_add_region_flags(struct lmb_region *rgn, phys_addr_t base,
 
 	if (coalesced)
 		return coalesced;
-	if (rgn->cnt >= rgn->max)
+	if (rgn->cnt >= rgn->max && lmb_grow_region(rgn))
 		return -1;
 
 	/* Couldn't coalesce the LMB, so add it to the sorted table. */
-	for (i = rgn->cnt-1; i >= 0; i--) {
-		if (base < rgn->region[i].base) {
-			rgn->region[i + 1].base = rgn->region[i].base;
-			rgn->region[i + 1].size = rgn->region[i].size;
-			rgn->region[i + 1].flags = rgn->region[i].flags;
-		} else {
-			rgn->region[i + 1].base = base;
-			rgn->region[i + 1].size = size;
-			rgn->region[i + 1].flags = flags;
-			break;
-		}
-	}
-
-	if (base < rgn->region[0].base) {
-		rgn->region[0].base = base;
-		rgn->region[0].size = size;
-		rgn->region[0].flags = flags;
-	}
-
+	i = lmb_first_above(rgn, base);
+	memmove(&rgn->region[i + 1], &rgn->region[i],
+		(rgn->cnt - i) * sizeof(*rgn->region));
+	rgn->region[i].base = base;
+	rgn->region[i].size = size;
+	rgn->region[i].flags = flags;
 	rgn->cnt++;
 
 	return 0;
@@ -362,22 +419,18 @@ long lmb_free(struct lmb *lmb, phys_addr_t base, phys_size_t size)
 	struct lmb_region *rgn = &(lmb->reserved);
 	phys_addr_t rgnbegin, rgnend;
 	phys_addr_t end = base + size - 1;
-	int i;
-
-	rgnbegin = rgnend = 0; /* supress gcc warnings */
+	unsigned long i;
 
 	/* Find the region where (base, size) belongs to */
-	for (i = 0; i < rgn->cnt; i++) {
-		rgnbegin = rgn->region[i].base;
-		rgnend = rgnbegin + rgn->region[i].size - 1;
-
-		if ((rgnbegin <= base) && (end <= rgnend))
-			break;
-	}
+	i = lmb_first_above(rgn, base);
 
 	/* Didn't find the region */
 	if (i == rgn->cnt)
 		return -1;
+	rgnbegin = rgn->region[i].base;
+	rgnend = rgnbegin + rgn->region[i].size - 1;
+	if (rgnbegin > base || end > rgnend)
+		return -1;
 
 	/* Check to see if we are removing entire region */
 	if ((rgnbegin == base) && (rgnend == end)) {
@@ -423,16 +476,13 @@ long lmb_reserve(struct lmb *lmb, phys_addr_t base, phys_size_t size)
 static long lmb_overlaps_region(struct lmb_region *rgn, phys_addr_t base,
 				phys_size_t size)
 {
-	unsigned long i;
+	unsigned long i = lmb_first_above(rgn, base);
 
-	for (i = 0; i < rgn->cnt; i++) {
-		phys_addr_t rgnbase = rgn->region[i].base;
-		phys_size_t rgnsize = rgn->region[i].size;
-		if (lmb_addrs_overlap(base, size, rgnbase, rgnsize))
-			break;
-	}
+	if (i < rgn->cnt && lmb_addrs_overlap(base, size, rgn->region[i].base,
+					      rgn->region[i].size))
+		return i;
 
-	return (i < rgn->cnt) ? i : -1;
+	return -1;
 }
 
 phys_addr_t lmb_alloc(struct lmb *lmb, phys_size_t size, ulong align)
@@ -528,22 +578,20 @@ phys_addr_t lmb_alloc_addr(struct lmb *lmb, phys_addr_t base, phys_size_t size)
 /* Return number of bytes from a given address that are free */
 phys_size_t lmb_get_free_size(struct lmb *lmb, phys_addr_t addr)
 {
-	int i;
+	unsigned long i;
 	long rgn;
 
 	/* check if the requested address is in the memory regions */
 	rgn = lmb_overlaps_region(&lmb->memory, addr, 1);
 	if (rgn >= 0) {
-		for (i = 0; i < lmb->reserved.cnt; i++) {
+		i = lmb_first_above(&lmb->reserved, addr);
+		if (i < lmb->reserved.cnt) {
 			if (addr < lmb->reserved.region[i].base) {
 				/* first reserved range > requested address */
 				return lmb->reserved.region[i].base - addr;
 			}
-			if (lmb->reserved.region[i].base +
-			    lmb->reserved.region[i].size > addr) {
-				/* requested addr is in this reserved range */
-				return 0;
-			}
+			/* requested addr is in this reserved range */
+			return 0;
 		}
 		/* if we come here: no reserved ranges above requested addr */
 		return lmb->memory.region[lmb->memory.cnt - 1].base +
@@ -554,14 +602,12 @@ phys_size_t lmb_get_free_size(struct lmb *lmb, phys_addr_t addr)
 
 int lmb_is_reserved_flags(struct lmb *lmb, phys_addr_t addr, int flags)
 {
-	int i;
+	struct lmb_region *rgn = &lmb->reserved;
+	unsigned long i = lmb_first_above(rgn, addr);
+
+	if (i < rgn->cnt && addr >= rgn->region[i].base)
+		return (rgn->region[i].flags & flags) == flags;
 
-	for (i = 0; i < lmb->reserved.cnt; i++) {
-		phys_addr_t upper = lmb->reserved.region[i].base +
-			lmb->reserved.region[i].size - 1;
-		if ((addr >= lmb->reserved.region[i].base) && (addr <= upper))
-			return (lmb->reserved.region[i].flags & flags) == flags;
-	}
 	return 0;
 }
 
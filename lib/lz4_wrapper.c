@@ -5,8 +5,11 @@
 
 #include <compiler.h>
 #include <image.h>
+#include <linux/bitops.h>
 #include <linux/kernel.h>
+#include <linux/sizes.h>
 #include <linux/types.h>
+#include <linux/xxhash.h>
 #include <asm/unaligned.h>
 #include <u-boot/lz4.h>
 
@@ -15,94 +18,240 @@
 
 #define LZ4F_BLOCKUNCOMPRESSED_FLAG 0x80000000U
 
-int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+/* Frame descriptor: FLG byte */
+#define LZ4F_FLG_VERSION_SHIFT		6
+#define LZ4F_FLG_INDEPENDENT		BIT(5)
+#define LZ4F_FLG_BLOCK_CHECKSUM		BIT(4)
+#define LZ4F_FLG_CONTENT_SIZE		BIT(3)
+#define LZ4F_FLG_CONTENT_CHECKSUM	BIT(2)
+#define LZ4F_FLG_RESERVED		0x03
+
+/* Frame descriptor: BD byte */
+#define LZ4F_BD_MAX_SIZE_SHIFT		4
+#define LZ4F_BD_RESERVED		0x8f
+
+/* Magic, FLG, BD and header checksum, without the optional content size */
+#define LZ4F_HEADER_MIN			(sizeof(u32) + 3 * sizeof(u8))
+
+static bool ulz4_checksums(void)
 {
-	const void *end = dst + *dstn;
-	const void *in = src;
-	void *out = dst;
-	int has_block_checksum;
+	return CONFIG_IS_ENABLED(LZ4_CHECKSUM);
+}
+
+/**
+ * ulz4_parse_header() - Parse the frame header
+ *
+ * @strm: Stream to update
+ * @in: Input data
+ * @len: Number of bytes available at @in
+ * Return: size of header, 0 if more input is needed, or -ve on error
+ */
+static int ulz4_parse_header(struct ulz4_stream *strm, const u8 *in,
+			     size_t len)
+{
+	u8 flags, block_desc, max_size;
+	size_t size = LZ4F_HEADER_MIN;
+
+	if (len < LZ4F_HEADER_MIN)
+		return 0;
+
+	flags = in[4];
+	block_desc = in[5];
+
+	/* We assume there's always only a single, standard frame. */
+	if (get_unaligned_le32(in) != LZ4F_MAGIC ||
+	    flags >> LZ4F_FLG_VERSION_SHIFT != 1)
+		return -EPROTONOSUPPORT;	/* unknown format */
+	if ((flags & LZ4F_FLG_RESERVED) || (block_desc & LZ4F_BD_RESERVED))
+		return -EINVAL;	/* reserved bits must be zero */
+	max_size = block_desc >> LZ4F_BD_MAX_SIZE_SHIFT;
+	if (max_size < 4)
+		return -EINVAL;	/* 64KB, 256KB, 1MB and 4MB are defined */
+
+	if (flags & LZ4F_FLG_CONTENT_SIZE) {
+		size += sizeof(u64);
+		if (len < size)
+			return 0;
+		strm->content_size = get_unaligned_le64(in + 6);
+		if (strm->content_size > strm->dst_size)
+			return -ENOBUFS;	/* output overrun */
+	}
+
+	/* The header checksum covers FLG up to the end of the descriptor */
+	if (ulz4_checksums() &&
+	    in[size - 1] != ((xxh32(in + 4, size - 5, 0) >> 8) & 0xff))
+		return -EBADMSG;
+
+	strm->flags = flags;
+	strm->block_max = 1U << (8 + 2 * max_size);
+	strm->header_done = true;
+	if (ulz4_checksums() && (flags & LZ4F_FLG_CONTENT_CHECKSUM))
+		xxh32_reset(&strm->xxh, 0);
+
+	return size;
+}
+
+/**
+ * ulz4_decode_block() - Decode one data block into the output buffer
+ *
+ * @strm: Stream to update
+ * @in: Block data, just after the block header
+ * @block_header: Block header
+ * Return: 0 if OK, or -ve on error
+ */
+static int ulz4_decode_block(struct ulz4_stream *strm, const void *in,
+			     u32 block_header)
+{
+	u32 block_size = block_header & ~LZ4F_BLOCKUNCOMPRESSED_FLAG;
+	size_t room = strm->dst_size - strm->out;
+	void *out = strm->dst + strm->out;
+	const void *prefix;
 	int ret;
-	*dstn = 0;
-
-	{ /* With in-place decompression the header may become invalid later. */
-		u32 magic;
-		u8 flags, version, independent_blocks, has_content_size;
-		u8 block_desc;
-
-		if (srcn < sizeof(u32) + 3*sizeof(u8))
-			return -EINVAL;	/* input overrun */
-
-		magic = get_unaligned_le32(in);
-		in += sizeof(u32);
-		flags = *(u8 *)in;
-		in += sizeof(u8);
-		block_desc = *(u8 *)in;
-		in += sizeof(u8);
-
-		version = (flags >> 6) & 0x3;
-		independent_blocks = (flags >> 5) & 0x1;
-		has_block_checksum = (flags >> 4) & 0x1;
-		has_content_size = (flags >> 3) & 0x1;
-
-		/* We assume there's always only a single, standard frame. */
-		if (magic != LZ4F_MAGIC || version != 1)
-			return -EPROTONOSUPPORT;	/* unknown format */
-		if ((flags & 0x03) || (block_desc & 0x8f))
-			return -EINVAL;	/* reserved bits must be zero */
-		if (!independent_blocks)
-			return -EPROTONOSUPPORT; /* we can't support this yet */
-
-		if (has_content_size) {
-			if (srcn < sizeof(u32) + 3*sizeof(u8) + sizeof(u64))
-				return -EINVAL;	/* input overrun */
-			in += sizeof(u64);
+
+	if (ulz4_checksums() && (strm->flags & LZ4F_FLG_BLOCK_CHECKSUM) &&
+	    xxh32(in, block_size, 0) != get_unaligned_le32(in + block_size))
+		return -EBADMSG;
+
+	if (block_header & LZ4F_BLOCKUNCOMPRESSED_FLAG) {
+		ret = min((size_t)block_size, room);
+		memmove(out, in, ret);
+		if (ret < (int)block_size) {
+			strm->out += ret;
+			return -ENOBUFS;	/* output overrun */
 		}
-		/* Header checksum byte */
-		in += sizeof(u8);
+	} else {
+		/*
+		 * Linked blocks may refer back up to 64KB into the previous
+		 * blocks' output, which is still in place just before @out
+		 */
+		prefix = out;
+		if (!(strm->flags & LZ4F_FLG_INDEPENDENT))
+			prefix = strm->out > SZ_64K ? out - SZ_64K : strm->dst;
+
+		/* constant folding essential, do not touch params! */
+		ret = LZ4_decompress_generic(in, out, block_size, room,
+				endOnInputSize, decode_full_block, noDict,
+				prefix, NULL, 0);
+		if (ret < 0)
+			return -EPROTO;	/* decompression error */
 	}
 
-	while (1) {
-		u32 block_header, block_size;
+	if (ulz4_checksums() && (strm->flags & LZ4F_FLG_CONTENT_CHECKSUM))
+		xxh32_update(&strm->xxh, out, ret);
+	strm->out += ret;
 
-		block_header = get_unaligned_le32(in);
-		in += sizeof(u32);
-		block_size = block_header & ~LZ4F_BLOCKUNCOMPRESSED_FLAG;
+	return 0;
+}
 
-		if (in - src + block_size > srcn) {
-			ret = -EINVAL;		/* input overrun */
-			break;
+/**
+ * ulz4_check_end() - Check the content size and checksum at the end mark
+ *
+ * @strm: Stream to check
+ * @in: Input data just after the end mark
+ * Return: 0 if OK, -EBADMSG if the size or checksum does not match
+ */
+static int ulz4_check_end(struct ulz4_stream *strm, const void *in)
+{
+	if ((strm->flags & LZ4F_FLG_CONTENT_SIZE) &&
+	    strm->out != strm->content_size)
+		return -EBADMSG;
+	if (ulz4_checksums() && (strm->flags & LZ4F_FLG_CONTENT_CHECKSUM) &&
+	    xxh32_digest(&strm->xxh) != get_unaligned_le32(in))
+		return -EBADMSG;
+
+	return 0;
+}
+
+void ulz4_stream_init(struct ulz4_stream *strm, void *dst, size_t dst_size)
+{
+	memset(strm, '\0', sizeof(*strm));
+	strm->dst = dst;
+	strm->dst_size = dst_size;
+}
+
+int ulz4_stream_feed(struct ulz4_stream *strm, const void *src, size_t len,
+		     size_t *usedp)
+{
+	const void *in = src;
+	u32 block_header, block_size;
+	size_t left, need;
+	int ret = 0;
+
+	while (!strm->done) {
+		/* @len may be ~0 if the caller does not know the input size */
+		left = len - (in - src);
+		if (!strm->header_done) {
+			ret = ulz4_parse_header(strm, in, left);
+			if (ret <= 0)
+				break;
+			in += ret;
+			continue;
 		}
 
-		if (!block_size) {
-			ret = 0;	/* decompression successful */
+		if (left < sizeof(u32)) {
+			ret = 0;
 			break;
 		}
+		block_header = get_unaligned_le32(in);
+		block_size = block_header & ~LZ4F_BLOCKUNCOMPRESSED_FLAG;
 
-		if (block_header & LZ4F_BLOCKUNCOMPRESSED_FLAG) {
-			size_t size = min((ptrdiff_t)block_size, (ptrdiff_t)(end - out));
-			memcpy(out, in, size);
-			out += size;
-			if (size < block_size) {
-				ret = -ENOBUFS;	/* output overrun */
+		if (!block_size) {
+			need = sizeof(u32);
+			if (strm->flags & LZ4F_FLG_CONTENT_CHECKSUM)
+				need += sizeof(u32);
+			if (left < need) {
+				ret = 0;
 				break;
 			}
-		} else {
-			/* constant folding essential, do not touch params! */
-			ret = LZ4_decompress_generic(in, out, block_size,
-					end - out, endOnInputSize,
-					decode_full_block, noDict, out, NULL, 0);
-			if (ret < 0) {
-				ret = -EPROTO;	/* decompression error */
+			ret = ulz4_check_end(strm, in + sizeof(u32));
+			if (ret)
 				break;
-			}
-			out += ret;
+			in += need;
+			strm->done = true;
+			break;
+		}
+		if (block_size > strm->block_max) {
+			ret = -EINVAL;	/* corrupt block header */
+			break;
 		}
 
-		in += block_size;
-		if (has_block_checksum)
-			in += sizeof(u32);
+		need = sizeof(u32) + block_size;
+		if (strm->flags & LZ4F_FLG_BLOCK_CHECKSUM)
+			need += sizeof(u32);
+		if (left < need) {
+			ret = 0;
+			break;
+		}
+		ret = ulz4_decode_block(strm, in + sizeof(u32), block_header);
+		if (ret)
+			break;
+		in += need;
 	}
 
-	*dstn = out - dst;
+	*usedp = in - src;
+	if (ret < 0)
+		return ret;
+
+	return strm->done;
+}
+
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	struct ulz4_stream strm;
+	size_t used;
+	int ret;
+
+	/*
+	 * Everything is decoded in one call, so with in-place decompression
+	 * the header is never read again after the output overwrites it
+	 */
+	ulz4_stream_init(&strm, dst, *dstn);
+	ret = ulz4_stream_feed(&strm, src, srcn, &used);
+	if (!ret)
+		ret = -EINVAL;	/* input overrun */
+	else if (ret > 0)
+		ret = 0;	/* decompression successful */
+
+	*dstn = strm.out;
 	return ret;
 }
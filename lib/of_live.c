@@ -55,6 +55,7 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 	struct device_node *np;
 	struct property *pp, **prev_pp = NULL;
 	const char *pathp;
+	unsigned long dad_len = fpsize ? fpsize - 1 : 0;
 	int l;
 	unsigned int allocl;
 	static int depth;
@@ -112,15 +113,16 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		if (new_format) {
 			/* rebuild full path for new format */
 			if (dad && dad->parent) {
-				strcpy(fn, dad->full_name);
+				/* fpsize tells us the length of the parent path */
+				memcpy(fn, dad->full_name, dad_len);
 #ifdef DEBUG
-				if ((strlen(fn) + l + 1) != allocl) {
+				if ((dad_len + l + 1) != allocl) {
 					debug("%s: p: %d, l: %d, a: %d\n",
-					      pathp, (int)strlen(fn), l,
+					      pathp, (int)dad_len, l,
 					      allocl);
 				}
 #endif
-				fn += strlen(fn);
+				fn += dad_len;
 			}
 			*(fn++) = '/';
 		}
@@ -140,6 +142,16 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		const char *pname;
 		int sz;
 
+		/*
+		 * When sizing, the property itself only matters if it may be
+		 * the "name" property, which version 0x10 does not need
+		 */
+		if (dryrun && new_format) {
+			unflatten_dt_alloc(&mem, sizeof(struct property),
+					   __alignof__(struct property));
+			continue;
+		}
+
 		p = fdt_getprop_by_offset(blob, offset, &pname, &sz);
 		if (!p) {
 			offset = -FDT_ERR_INTERNAL;
@@ -313,6 +325,10 @@ int unflatten_device_tree(const void *blob, struct device_node **mynodes)
 		return -ENOSPC;
 	}
 
+	/* Without the index, phandles are found by searching the tree */
+	if (of_phandle_index_add(*mynodes))
+		debug("No memory for phandle index\n");
+
 	debug(" <- unflatten_device_tree()\n");
 
 	return 0;
@@ -340,6 +356,7 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp)
 
 void of_live_free(struct device_node *root)
 {
+	of_phandle_index_remove(root);
 	/* the tree is stored as a contiguous block of memory */
 	free(root);
 }
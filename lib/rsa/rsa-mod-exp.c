@@ -6,6 +6,8 @@
 #ifndef USE_HOSTCC
 #include <fdtdec.h>
 #include <log.h>
+#include <malloc.h>
+#include <asm/global_data.h>
 #include <asm/types.h>
 #include <asm/byteorder.h>
 #include <linux/errno.h>
@@ -19,6 +21,10 @@
 #include <u-boot/rsa.h>
 #include <u-boot/rsa-mod-exp.h>
 
+#ifndef USE_HOSTCC
+DECLARE_GLOBAL_DATA_PTR;
+#endif
+
 #define UINT64_MULT32(v, multby)  (((uint64_t)(v)) * ((uint32_t)(multby)))
 
 #define get_unaligned_be32(a) fdt32_to_cpu(*(uint32_t *)a)
@@ -35,33 +41,76 @@ static inline uint64_t fdt64_to_cpup(const void *p)
 /* Default public exponent for backward compatibility */
 #define RSA_DEFAULT_PUBEXP	65537
 
+/*
+ * Limbs are 64 bits wide when the compiler can multiply two of them into a
+ * 128-bit result, which quarters the number of multiply steps on 64-bit CPUs
+ */
+#ifdef __SIZEOF_INT128__
+typedef uint64_t rsa_limb;
+typedef unsigned __int128 rsa_dlimb;
+#else
+typedef uint32_t rsa_limb;
+typedef uint64_t rsa_dlimb;
+#endif
+
+#define RSA_LIMB_BITS		(sizeof(rsa_limb) * 8)
+#define RSA_MAX_LIMBS		(RSA_MAX_KEY_BITS / RSA_LIMB_BITS)
+
+/* Window size for exponents longer than e=65537; the table has 2^(w-1) */
+#define RSA_WINDOW_BITS		4
+#define RSA_WINDOW_MIN_EXP_BITS	24
+
 /**
- * subtract_modulus() - subtract modulus from the given value
+ * struct rsa_mont_key - key in the form used for Montgomery multiplication
+ *
+ * @len:	Number of limbs in the modulus
+ * @num_bits:	Key length in bits
+ * @n0inv:	-1 / modulus[0] mod 2^RSA_LIMB_BITS
+ * @modulus:	Modulus as little endian limb array
+ * @rr:		R^2 mod modulus, where R = 2^(len * RSA_LIMB_BITS)
+ * @modulus_be:	Modulus as passed in, to check if a cached key matches
+ */
+struct rsa_mont_key {
+	uint len;
+	int num_bits;
+	rsa_limb n0inv;
+	rsa_limb modulus[RSA_MAX_LIMBS];
+	rsa_limb rr[RSA_MAX_LIMBS];
+	uint8_t modulus_be[RSA_MAX_KEY_BITS / 8];
+};
+
+/* Most recently used key, to avoid setting it up again for each image */
+static struct rsa_mont_key *rsa_key_cache;
+
+/**
+ * rsa_sub_modulus() - subtract modulus from the given value
  *
  * @key:	Key containing modulus to subtract
- * @num:	Number to subtract modulus from, as little endian word array
+ * @num:	Number to subtract modulus from, as little endian limb array
  */
-static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
+static void rsa_sub_modulus(const struct rsa_mont_key *key, rsa_limb num[])
 {
-	int64_t acc = 0;
+	rsa_limb borrow = 0, n, d;
 	uint i;
 
 	for (i = 0; i < key->len; i++) {
-		acc += (uint64_t)num[i] - key->modulus[i];
-		num[i] = (uint32_t)acc;
-		acc >>= 32;
+		n = key->modulus[i] + borrow;
+		borrow = n < borrow;
+		d = num[i] - n;
+		borrow |= d > num[i];
+		num[i] = d;
 	}
 }
 
 /**
- * greater_equal_modulus() - check if a value is >= modulus
+ * rsa_ge_modulus() - check if a value is >= modulus
  *
  * @key:	Key containing modulus to check
- * @num:	Number to check against modulus, as little endian word array
+ * @num:	Number to check against modulus, as little endian limb array
  * Return: 0 if num < modulus, 1 if num >= modulus
  */
-static int greater_equal_modulus(const struct rsa_public_key *key,
-				 uint32_t num[])
+static int rsa_ge_modulus(const struct rsa_mont_key *key,
+			  const rsa_limb num[])
 {
 	int i;
 
@@ -76,239 +125,426 @@ static int greater_equal_modulus(const struct rsa_public_key *key,
 }
 
 /**
- * montgomery_mul_add_step() - Perform montgomery multiply-add step
+ * rsa_mont_mul() - Perform montgomery multiply
  *
- * Operation: montgomery result[] += a * b[] / n0inv % modulus
+ * Operation: result[] = a[] * b[] / R % modulus
+ *
+ * The result is less than 2^(len * RSA_LIMB_BITS) but may be up to one
+ * modulus too large, which does not matter for further multiplications.
  *
  * @key:	RSA key
- * @result:	Place to put result, as little endian word array
- * @a:		Multiplier
- * @b:		Multiplicand, as little endian word array
+ * @result:	Place to put result, as little endian limb array. This must
+ *		not overlap @a or @b
+ * @a:		Multiplier, as little endian limb array
+ * @b:		Multiplicand, as little endian limb array
  */
-static void montgomery_mul_add_step(const struct rsa_public_key *key,
-		uint32_t result[], const uint32_t a, const uint32_t b[])
+static void rsa_mont_mul(const struct rsa_mont_key *key, rsa_limb result[],
+			 const rsa_limb a[], const rsa_limb b[])
 {
-	uint64_t acc_a, acc_b;
-	uint32_t d0;
-	uint i;
+	const rsa_limb *mod = key->modulus;
+	rsa_dlimb acc_a, acc_b;
+	rsa_limb ai, d0;
+	uint i, j;
 
-	acc_a = (uint64_t)a * b[0] + result[0];
-	d0 = (uint32_t)acc_a * key->n0inv;
-	acc_b = (uint64_t)d0 * key->modulus[0] + (uint32_t)acc_a;
-	for (i = 1; i < key->len; i++) {
-		acc_a = (acc_a >> 32) + (uint64_t)a * b[i] + result[i];
-		acc_b = (acc_b >> 32) + (uint64_t)d0 * key->modulus[i] +
-				(uint32_t)acc_a;
-		result[i - 1] = (uint32_t)acc_b;
-	}
+	memset(result, '\0', key->len * sizeof(rsa_limb));
+	for (i = 0; i < key->len; i++) {
+		ai = a[i];
+		acc_a = (rsa_dlimb)ai * b[0] + result[0];
+		d0 = (rsa_limb)acc_a * key->n0inv;
+		acc_b = (rsa_dlimb)d0 * mod[0] + (rsa_limb)acc_a;
+		for (j = 1; j < key->len; j++) {
+			acc_a = (acc_a >> RSA_LIMB_BITS) +
+				(rsa_dlimb)ai * b[j] + result[j];
+			acc_b = (acc_b >> RSA_LIMB_BITS) +
+				(rsa_dlimb)d0 * mod[j] + (rsa_limb)acc_a;
+			result[j - 1] = (rsa_limb)acc_b;
+		}
+		acc_a = (acc_a >> RSA_LIMB_BITS) + (acc_b >> RSA_LIMB_BITS);
+		result[j - 1] = (rsa_limb)acc_a;
 
-	acc_a = (acc_a >> 32) + (acc_b >> 32);
+		if (acc_a >> RSA_LIMB_BITS)
+			rsa_sub_modulus(key, result);
+	}
+}
 
-	result[i - 1] = (uint32_t)acc_a;
+/**
+ * rsa_from_be() - Convert a big endian byte array to a limb array
+ *
+ * @dst:	Little endian limb array of @len limbs
+ * @len:	Number of limbs in @dst
+ * @src:	Big endian number
+ * @size:	Number of bytes in @src, at most @len * sizeof(rsa_limb)
+ */
+static void rsa_from_be(rsa_limb *dst, uint len, const uint8_t *src,
+			uint size)
+{
+	uint i;
 
-	if (acc_a >> 32)
-		subtract_modulus(key, result);
+	memset(dst, '\0', len * sizeof(rsa_limb));
+	for (i = 0; i < size; i++)
+		dst[i / sizeof(rsa_limb)] |= (rsa_limb)src[size - 1 - i] <<
+					     (8 * (i % sizeof(rsa_limb)));
 }
 
 /**
- * montgomery_mul() - Perform montgomery mutitply
- *
- * Operation: montgomery result[] = a[] * b[] / n0inv % modulus
+ * rsa_to_be() - Convert a limb array to a big endian byte array
  *
- * @key:	RSA key
- * @result:	Place to put result, as little endian word array
- * @a:		Multiplier, as little endian word array
- * @b:		Multiplicand, as little endian word array
+ * @dst:	Big endian number
+ * @size:	Number of bytes in @dst
+ * @src:	Little endian limb array, at least @size bytes long
  */
-static void montgomery_mul(const struct rsa_public_key *key,
-		uint32_t result[], uint32_t a[], const uint32_t b[])
+static void rsa_to_be(uint8_t *dst, uint size, const rsa_limb *src)
 {
 	uint i;
 
-	for (i = 0; i < key->len; ++i)
-		result[i] = 0;
-	for (i = 0; i < key->len; ++i)
-		montgomery_mul_add_step(key, result, a[i], b);
+	for (i = 0; i < size; i++)
+		dst[size - 1 - i] = src[i / sizeof(rsa_limb)] >>
+				    (8 * (i % sizeof(rsa_limb)));
 }
 
 /**
- * num_pub_exponent_bits() - Number of bits in the public exponent
+ * rsa_setup_key() - Convert key properties to the form used for exponentiation
  *
- * @key:	RSA key
- * @num_bits:	Storage for the number of public exponent bits
+ * @key:	Key to set up
+ * @prop:	Key properties, with modulus and R^2 for R = 2^num_bits
  */
-static int num_public_exponent_bits(const struct rsa_public_key *key,
-		int *num_bits)
+static void rsa_setup_key(struct rsa_mont_key *key,
+			  const struct key_prop *prop)
 {
-	uint64_t exponent;
-	int exponent_bits;
-	const uint max_bits = (sizeof(exponent) * 8);
+	uint size = prop->num_bits / 8;
+	rsa_limb n0, inv, carry;
+	uint i, j;
+
+	key->num_bits = prop->num_bits;
+	key->len = (prop->num_bits + RSA_LIMB_BITS - 1) / RSA_LIMB_BITS;
+	memcpy(key->modulus_be, prop->modulus, size);
+	rsa_from_be(key->modulus, key->len, prop->modulus, size);
+	rsa_from_be(key->rr, key->len, prop->rr, size);
+
+	/*
+	 * The modulus is odd, so it is its own inverse mod 8; each Newton step
+	 * doubles the number of correct low bits
+	 */
+	n0 = key->modulus[0];
+	for (inv = n0, i = 3; i < RSA_LIMB_BITS; i *= 2)
+		inv *= 2 - n0 * inv;
+	key->n0inv = -inv;
+
+	/*
+	 * If the key length is not a whole number of limbs, R is larger than
+	 * 2^num_bits, so double R^2 into place
+	 */
+	for (i = 2 * (key->len * RSA_LIMB_BITS - prop->num_bits); i; i--) {
+		carry = key->rr[key->len - 1] >> (RSA_LIMB_BITS - 1);
+		for (j = key->len - 1; j; j--)
+			key->rr[j] = key->rr[j] << 1 |
+				     key->rr[j - 1] >> (RSA_LIMB_BITS - 1);
+		key->rr[0] <<= 1;
+		if (carry || rsa_ge_modulus(key, key->rr))
+			rsa_sub_modulus(key, key->rr);
+	}
+}
 
-	exponent = key->exponent;
-	exponent_bits = 0;
+/**
+ * rsa_get_key() - Get a key ready for exponentiation, using the cache
+ *
+ * @prop:	Key properties
+ * @keyp:	Returns the key. If this is not the cached key, the caller
+ *		must free() it
+ * Return: 1 if the key is the cached one, 0 if not, -ENOMEM if out of memory
+ */
+static int rsa_get_key(const struct key_prop *prop,
+		       struct rsa_mont_key **keyp)
+{
+	struct rsa_mont_key *key = rsa_key_cache;
+	bool can_cache = true;
 
-	if (!exponent) {
-		*num_bits = exponent_bits;
-		return 0;
+#ifndef USE_HOSTCC
+	/* Before relocation there is nowhere to keep the cache */
+	if (!IS_ENABLED(CONFIG_SPL_BUILD) && !(gd->flags & GD_FLG_RELOC))
+		can_cache = false;
+#endif
+	if (can_cache && key && key->num_bits == prop->num_bits &&
+	    !memcmp(key->modulus_be, prop->modulus, prop->num_bits / 8)) {
+		*keyp = key;
+		return true;
 	}
 
-	for (exponent_bits = 1; exponent_bits < max_bits + 1; ++exponent_bits)
-		if (!(exponent >>= 1)) {
-			*num_bits = exponent_bits;
-			return 0;
-		}
+	if (!can_cache || !key) {
+		key = malloc(sizeof(*key));
+		if (!key)
+			return -ENOMEM;
+	}
+	rsa_setup_key(key, prop);
+	if (can_cache)
+		rsa_key_cache = key;
+	*keyp = key;
 
-	return -EINVAL;
+	return can_cache;
 }
 
 /**
- * is_public_exponent_bit_set() - Check if a bit in the public exponent is set
+ * rsa_window() - Get the next exponent window, for sliding-window
  *
- * @key:	RSA key
- * @pos:	The bit position to check
+ * @exponent:	Exponent
+ * @pos:	Position of the (set) top bit of the window
+ * @max_bits:	Maximum window size in bits
+ * @widthp:	Returns the width of the window in bits
+ * Return: value of the window, which is odd
  */
-static int is_public_exponent_bit_set(const struct rsa_public_key *key,
-		int pos)
+static uint rsa_window(uint64_t exponent, int pos, int max_bits, int *widthp)
 {
-	return key->exponent & (1ULL << pos);
+	int low = pos >= max_bits ? pos - max_bits + 1 : 0;
+
+	while (!(exponent & (1ULL << low)))
+		low++;
+	*widthp = pos - low + 1;
+
+	return (exponent >> low) & ((1U << *widthp) - 1);
 }
 
 /**
- * pow_mod() - in-place public exponentiation
+ * rsa_pow_mod() - public exponentiation
+ *
+ * This uses left-to-right sliding-window exponentiation. For short
+ * exponents like 65537 a window of one bit (plain square-and-multiply) is
+ * quickest, since the exponent has few bits set.
  *
  * @key:	RSA key
- * @inout:	Big-endian word array containing value and result
+ * @exponent:	Public exponent, which must be odd
+ * @val:	Value, as little endian limb array; replaced with the result
  */
-static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
+static void rsa_pow_mod(const struct rsa_mont_key *key, uint64_t exponent,
+		       rsa_limb *val)
 {
-	uint32_t *result, *ptr;
-	uint i;
-	int j, k;
-
-	/* Sanity check for stack size - key->len is in 32-bit words */
-	if (key->len > RSA_MAX_KEY_BITS / 32) {
-		debug("RSA key words %u exceeds maximum %d\n", key->len,
-		      RSA_MAX_KEY_BITS / 32);
-		return -EINVAL;
-	}
-
-	uint32_t val[key->len], acc[key->len], tmp[key->len];
-	uint32_t a_scaled[key->len];
-	result = tmp;  /* Re-use location. */
-
-	/* Convert from big endian byte array to little endian word array. */
-	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
-		val[i] = get_unaligned_be32(ptr);
-
-	if (0 != num_public_exponent_bits(key, &k))
-		return -EINVAL;
-
-	if (k < 2) {
-		debug("Public exponent is too short (%d bits, minimum 2)\n",
-		      k);
-		return -EINVAL;
+	rsa_limb bufs[3][RSA_MAX_LIMBS];
+	rsa_limb *acc = bufs[0], *tmp = bufs[1], *swap;
+	rsa_limb *table = bufs[2];
+	int pos, width, bits, window, i;
+	uint win;
+
+	bits = 64 - __builtin_clzll(exponent);
+	window = 1;
+	if (bits > RSA_WINDOW_MIN_EXP_BITS) {
+		/* Fall back to square-and-multiply if there is no memory */
+		table = malloc(sizeof(rsa_limb) * key->len << (RSA_WINDOW_BITS - 1));
+		if (table)
+			window = RSA_WINDOW_BITS;
+		else
+			table = bufs[2];
 	}
 
-	if (!is_public_exponent_bit_set(key, 0)) {
-		debug("LSB of RSA public exponent must be set.\n");
-		return -EINVAL;
+	/* table[i] = val^(2i + 1) * R mod n, the odd powers in the window */
+	rsa_mont_mul(key, table, val, key->rr);
+	if (window > 1) {
+		rsa_mont_mul(key, tmp, table, table);
+		for (i = 1; i < 1 << (window - 1); i++)
+			rsa_mont_mul(key, table + i * key->len,
+				     table + (i - 1) * key->len, tmp);
 	}
 
-	/* the bit at e[k-1] is 1 by definition, so start with: C := M */
-	montgomery_mul(key, acc, val, key->rr); /* acc = a * RR / R mod n */
-	/* retain scaled version for intermediate use */
-	memcpy(a_scaled, acc, key->len * sizeof(a_scaled[0]));
-
-	for (j = k - 2; j > 0; --j) {
-		montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
-
-		if (is_public_exponent_bit_set(key, j)) {
-			/* acc = tmp * val / R mod n */
-			montgomery_mul(key, acc, tmp, a_scaled);
-		} else {
-			/* e[j] == 0, copy tmp back to acc for next operation */
-			memcpy(acc, tmp, key->len * sizeof(acc[0]));
+	/* The top bit is set, so start with its window */
+	win = rsa_window(exponent, bits - 1, window, &width);
+	memcpy(acc, table + (win >> 1) * key->len,
+	       key->len * sizeof(rsa_limb));
+	for (pos = bits - 1 - width; pos >= 0; pos -= width) {
+		width = 1;
+		win = 0;
+		if (exponent & (1ULL << pos))
+			win = rsa_window(exponent, pos, window, &width);
+		for (i = 0; i < width; i++) {
+			rsa_mont_mul(key, tmp, acc, acc);
+			swap = acc;
+			acc = tmp;
+			tmp = swap;
 		}
+		if (!win)
+			continue;
+
+		/*
+		 * Multiplying by the unscaled value leaves the domain, so is
+		 * only done for a final window of one bit, to save converting
+		 * the result back
+		 */
+		if (!pos && win == 1) {
+			rsa_mont_mul(key, tmp, acc, val);
+			goto done;
+		}
+		rsa_mont_mul(key, tmp, acc, table + (win >> 1) * key->len);
+		swap = acc;
+		acc = tmp;
+		tmp = swap;
 	}
 
-	/* the bit at e[0] is always 1 */
-	montgomery_mul(key, tmp, acc, acc); /* tmp = acc^2 / R mod n */
-	montgomery_mul(key, acc, tmp, val); /* acc = tmp * a / R mod M */
-	memcpy(result, acc, key->len * sizeof(result[0]));
-
+	/* Convert out of the Montgomery domain by multiplying by 1 */
+	memset(val, '\0', key->len * sizeof(rsa_limb));
+	val[0] = 1;
+	rsa_mont_mul(key, tmp, acc, val);
+done:
 	/* Make sure result < mod; result is at most 1x mod too large. */
-	if (greater_equal_modulus(key, result))
-		subtract_modulus(key, result);
-
-	/* Convert to bigendian byte array */
-	for (i = key->len - 1, ptr = inout; (int)i >= 0; i--, ptr++)
-		put_unaligned_be32(result[i], ptr);
-	return 0;
-}
-
-static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
-{
-	int i;
-
-	for (i = 0; i < len; i++)
-		dst[i] = fdt32_to_cpu(src[len - 1 - i]);
+	if (rsa_ge_modulus(key, tmp))
+		rsa_sub_modulus(key, tmp);
+	memcpy(val, tmp, key->len * sizeof(rsa_limb));
+	if (window > 1)
+		free(table);
 }
 
 int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 		struct key_prop *prop, uint8_t *out)
 {
-	struct rsa_public_key key;
-	int ret;
+	rsa_limb val[RSA_MAX_LIMBS];
+	struct rsa_mont_key *key;
+	uint64_t exponent;
+	int cached;
 
 	if (!prop) {
 		debug("%s: Skipping invalid prop", __func__);
 		return -EBADF;
 	}
-	key.n0inv = prop->n0inv;
-	key.len = prop->num_bits;
 
 	if (!prop->public_exponent)
-		key.exponent = RSA_DEFAULT_PUBEXP;
+		exponent = RSA_DEFAULT_PUBEXP;
 	else
-		key.exponent = fdt64_to_cpup(prop->public_exponent);
+		exponent = fdt64_to_cpup(prop->public_exponent);
 
-	if (!key.len || !prop->modulus || !prop->rr) {
+	if (!prop->num_bits || !prop->modulus || !prop->rr) {
 		debug("%s: Missing RSA key info", __func__);
 		return -EFAULT;
 	}
 
 	/* Sanity check for stack size */
-	if (key.len > RSA_MAX_KEY_BITS || key.len < RSA_MIN_KEY_BITS) {
+	if (prop->num_bits > RSA_MAX_KEY_BITS ||
+	    prop->num_bits < RSA_MIN_KEY_BITS) {
 		debug("RSA key bits %u outside allowed range %d..%d\n",
-		      key.len, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
+		      prop->num_bits, RSA_MIN_KEY_BITS, RSA_MAX_KEY_BITS);
 		return -EFAULT;
 	}
-	key.len /= sizeof(uint32_t) * 8;
-	uint32_t key1[key.len], key2[key.len];
-
-	key.modulus = key1;
-	key.rr = key2;
-	rsa_convert_big_endian(key.modulus, (uint32_t *)prop->modulus, key.len);
-	rsa_convert_big_endian(key.rr, (uint32_t *)prop->rr, key.len);
-	if (!key.modulus || !key.rr) {
+	if (sig_len != prop->num_bits / 8) {
+		debug("Signature length %u does not match key\n", sig_len);
+		return -EINVAL;
+	}
+
+	if (exponent < 3) {
+		debug("Public exponent is too short (minimum 2 bits)\n");
+		return -EINVAL;
+	}
+	if (!(exponent & 1)) {
+		debug("LSB of RSA public exponent must be set.\n");
+		return -EINVAL;
+	}
+
+	cached = rsa_get_key(prop, &key);
+	if (cached < 0) {
 		debug("%s: Out of memory", __func__);
 		return -ENOMEM;
 	}
 
-	uint32_t buf[sig_len / sizeof(uint32_t)];
+	rsa_from_be(val, key->len, sig, sig_len);
+	rsa_pow_mod(key, exponent, val);
+	rsa_to_be(out, sig_len, val);
+	if (!cached)
+		free(key);
 
-	memcpy(buf, sig, sig_len);
+	return 0;
+}
 
-	ret = pow_mod(&key, buf);
-	if (ret)
-		return ret;
+#if defined(CONFIG_CMD_ZYNQ_RSA)
+/**
+ * subtract_modulus() - subtract modulus from the given value
+ *
+ * @key:	Key containing modulus to subtract
+ * @num:	Number to subtract modulus from, as little endian word array
+ */
+static void subtract_modulus(const struct rsa_public_key *key, uint32_t num[])
+{
+	int64_t acc = 0;
+	uint i;
 
-	memcpy(out, buf, sig_len);
+	for (i = 0; i < key->len; i++) {
+		acc += (uint64_t)num[i] - key->modulus[i];
+		num[i] = (uint32_t)acc;
+		acc >>= 32;
+	}
+}
 
-	return 0;
+/**
+ * greater_equal_modulus() - check if a value is >= modulus
+ *
+ * @key:	Key containing modulus to check
+ * @num:	Number to check against modulus, as little endian word array
+ * Return: 0 if num < modulus, 1 if num >= modulus
+ */
+static int greater_equal_modulus(const struct rsa_public_key *key,
+				 uint32_t num[])
+{
+	int i;
+
+	for (i = (int)key->len - 1; i >= 0; i--) {
+		if (num[i] < key->modulus[i])
+			return 0;
+		if (num[i] > key->modulus[i])
+			return 1;
+	}
+
+	return 1;  /* equal */
+}
+
+/**
+ * montgomery_mul_add_step() - Perform montgomery multiply-add step
+ *
+ * Operation: montgomery result[] += a * b[] / n0inv % modulus
+ *
+ * @key:	RSA key
+ * @result:	Place to put result, as little endian word array
+ * @a:		Multiplier
+ * @b:		Multiplicand, as little endian word array
+ */
+static void montgomery_mul_add_step(const struct rsa_public_key *key,
+		uint32_t result[], const uint32_t a, const uint32_t b[])
+{
+	uint64_t acc_a, acc_b;
+	uint32_t d0;
+	uint i;
+
+	acc_a = (uint64_t)a * b[0] + result[0];
+	d0 = (uint32_t)acc_a * key->n0inv;
+	acc_b = (uint64_t)d0 * key->modulus[0] + (uint32_t)acc_a;
+	for (i = 1; i < key->len; i++) {
+		acc_a = (acc_a >> 32) + (uint64_t)a * b[i] + result[i];
+		acc_b = (acc_b >> 32) + (uint64_t)d0 * key->modulus[i] +
+				(uint32_t)acc_a;
+		result[i - 1] = (uint32_t)acc_b;
+	}
+
+	acc_a = (acc_a >> 32) + (acc_b >> 32);
+
+	result[i - 1] = (uint32_t)acc_a;
+
+	if (acc_a >> 32)
+		subtract_modulus(key, result);
+}
+
+/**
+ * montgomery_mul() - Perform montgomery mutitply
+ *
+ * Operation: montgomery result[] = a[] * b[] / n0inv % modulus
+ *
+ * @key:	RSA key
+ * @result:	Place to put result, as little endian word array
+ * @a:		Multiplier, as little endian word array
+ * @b:		Multiplicand, as little endian word array
+ */
+static void montgomery_mul(const struct rsa_public_key *key,
+		uint32_t result[], uint32_t a[], const uint32_t b[])
+{
+	uint i;
+
+	for (i = 0; i < key->len; ++i)
+		result[i] = 0;
+	for (i = 0; i < key->len; ++i)
+		montgomery_mul_add_step(key, result, a[i], b);
 }
 
-#if defined(CONFIG_CMD_ZYNQ_RSA)
 /**
  * zynq_pow_mod - in-place public exponentiation
  *
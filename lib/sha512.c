@@ -16,6 +16,8 @@
 #include <compiler.h>
 #include <u-boot/sha512.h>
 
+#include <linux/compiler_attributes.h>
+
 const uint8_t sha384_der_prefix[SHA384_DER_LEN] = {
 	0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86,
 	0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05,
@@ -187,15 +189,21 @@ sha512_transform(uint64_t *state, const uint8_t *input)
 	a = b = c = d = e = f = g = h = t1 = t2 = 0;
 }
 
-static void sha512_block_fn(sha512_context *sst, const uint8_t *src,
-				    int blocks)
+void sha512_process_generic(sha512_context *ctx, const unsigned char *data,
+			    unsigned int blocks)
 {
 	while (blocks--) {
-		sha512_transform(sst->state, src);
-		src += SHA512_BLOCK_SIZE;
+		sha512_transform(ctx->state, data);
+		data += SHA512_BLOCK_SIZE;
 	}
 }
 
+__weak void sha512_process(sha512_context *ctx, const unsigned char *data,
+			   unsigned int blocks)
+{
+	sha512_process_generic(ctx, data, blocks);
+}
+
 static void sha512_base_do_update(sha512_context *sctx,
 					const uint8_t *data,
 					unsigned int len)
@@ -216,14 +224,14 @@ static void sha512_base_do_update(sha512_context *sctx,
 			data += p;
 			len -= p;
 
-			sha512_block_fn(sctx, sctx->buf, 1);
+			sha512_process(sctx, sctx->buf, 1);
 		}
 
 		blocks = len / SHA512_BLOCK_SIZE;
 		len %= SHA512_BLOCK_SIZE;
 
 		if (blocks) {
-			sha512_block_fn(sctx, data, blocks);
+			sha512_process(sctx, data, blocks);
 			data += blocks * SHA512_BLOCK_SIZE;
 		}
 		partial = 0;
@@ -243,13 +251,13 @@ static void sha512_base_do_finalize(sha512_context *sctx)
 		memset(sctx->buf + partial, 0x0, SHA512_BLOCK_SIZE - partial);
 		partial = 0;
 
-		sha512_block_fn(sctx, sctx->buf, 1);
+		sha512_process(sctx, sctx->buf, 1);
 	}
 
 	memset(sctx->buf + partial, 0x0, bit_offset - partial);
 	bits[0] = cpu_to_be64(sctx->count[1] << 3 | sctx->count[0] >> 61);
 	bits[1] = cpu_to_be64(sctx->count[0] << 3);
-	sha512_block_fn(sctx, sctx->buf, 1);
+	sha512_process(sctx, sctx->buf, 1);
 }
 
 #if defined(CONFIG_SHA384)
@@ -31,6 +31,44 @@
 #  define PUP(a) *++(a)
 #endif
 
+#ifdef INFLATE_FAST_WIDE
+/*
+   Copy a match of len bytes from dist bytes back to out, a word at a time.
+   This may write up to sizeof(unsigned long) - 1 bytes beyond the end of
+   the match, which inflate() leaves room for.  Returns the end of the match.
+ */
+local unsigned char FAR *copy_match(unsigned char FAR *out, unsigned dist,
+                                    unsigned len)
+{
+    const unsigned int wsz = sizeof(unsigned long);
+    unsigned char FAR *end = out + len;
+    unsigned char FAR *from = out - dist;
+    unsigned i;
+
+    if (dist < wsz) {
+        /*
+         * Overlapping copy: the output repeats every dist bytes, so after
+         * writing one word bytewise, it can be copied from any multiple of
+         * dist back that is at least a word.
+         */
+        for (i = 0; i < wsz; i++)
+            out[i] = from[i];
+        out += wsz;
+        for (i = dist; i < wsz; i += dist)
+            ;
+        from = out - i;
+    }
+    while (out < end) {
+        put_unaligned(get_unaligned((unsigned long *)from),
+                      (unsigned long *)out);
+        out += wsz;
+        from += wsz;
+    }
+
+    return end;
+}
+#endif
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -47,6 +85,9 @@
         start >= strm->avail_out
         state->bits < 8
 
+   U-Boot: with INFLATE_FAST_WIDE the input and output requirements are
+   INFLATE_FAST_MIN_HAVE and INFLATE_FAST_MIN_LEFT instead, see inffast.h.
+
    On return, state->mode is one of:
 
         LEN -- ran out of enough output space or enough available input
@@ -98,18 +139,18 @@ void inflate_fast(z_streamp strm, unsigned start)
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
     in = strm->next_in - OFF;
-    last = in + (strm->avail_in - 5);
-    if (in > last && strm->avail_in > 5) {
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_HAVE - 1));
+    if (in > last && strm->avail_in > INFLATE_FAST_MIN_HAVE - 1) {
         /*
          * overflow detected, limit strm->avail_in to the
          * max. possible size and recalculate last
          */
 	strm->avail_in = 0xffffffff - (uintptr_t)in;
-        last = in + (strm->avail_in - 5);
+        last = in + (strm->avail_in - (INFLATE_FAST_MIN_HAVE - 1));
     }
     out = strm->next_out - OFF;
     beg = out - (start - strm->avail_out);
-    end = out + (strm->avail_out - 257);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_LEFT - 1));
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -127,12 +168,26 @@ void inflate_fast(z_streamp strm, unsigned start)
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
+#ifdef INFLATE_FAST_WIDE
+        /*
+         * Load eight bytes but only consume the whole bytes that fit,
+         * leaving at least 56 bits: enough for a literal or a complete
+         * length/distance pair (at most 48 bits), so the refills below
+         * are never needed.  Bits above 'bits' are not cleared, but they
+         * hold the next input bits anyway, so or-ing them in again at the
+         * next refill is harmless.
+         */
+        hold |= (unsigned long)get_unaligned_le64(in + OFF) << bits;
+        in += (63 - bits) >> 3;
+        bits |= 56;
+#else
         if (bits < 15) {
             hold += (unsigned long)(PUP(in)) << bits;
             bits += 8;
             hold += (unsigned long)(PUP(in)) << bits;
             bits += 8;
         }
+#endif
         this = lcode[hold & lmask];
       dolen:
         op = (unsigned)(this.bits);
@@ -253,6 +308,9 @@ void inflate_fast(z_streamp strm, unsigned start)
                     }
                 }
                 else {
+#ifdef INFLATE_FAST_WIDE
+                    out = copy_match(out + OFF, dist, len) - OFF;
+#else
 		    unsigned short *sout;
 		    unsigned long loops;
 
@@ -294,6 +352,7 @@ void inflate_fast(z_streamp strm, unsigned start)
 		    }
 		    if (len & 1)
 			PUP(out) = PUP(from);
+#endif
                 }
             }
             else if ((op & 64) == 0) {          /* 2nd level distance code */
@@ -326,14 +385,17 @@ void inflate_fast(z_streamp strm, unsigned start)
     len = bits >> 3;
     in -= len;
     bits -= len << 3;
-    hold &= (1U << bits) - 1;
+    hold &= (1UL << bits) - 1;
 
     /* update state and return */
     strm->next_in = in + OFF;
     strm->next_out = out + OFF;
-    strm->avail_in = (unsigned)(in < last ? 5 + (last - in) : 5 - (in - last));
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_HAVE - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_HAVE - 1) - (in - last));
     strm->avail_out = (unsigned)(out < end ?
-                                 257 + (end - out) : 257 - (out - end));
+                                 (INFLATE_FAST_MIN_LEFT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_LEFT - 1) - (out - end));
     state->hold = hold;
     state->bits = bits;
     return;
@@ -8,4 +8,19 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/*
+ * U-Boot: on 64-bit machines inflate_fast() refills its bit buffer with one
+ * 8-byte load and copies matches a word at a time. Both may touch a few
+ * bytes beyond what they consume or produce, so it needs a little more
+ * input and output space before it can be used.
+ */
+#if BITS_PER_LONG == 64
+#define INFLATE_FAST_WIDE
+#define INFLATE_FAST_MIN_HAVE	8
+#define INFLATE_FAST_MIN_LEFT	(258 + sizeof(unsigned long))
+#else
+#define INFLATE_FAST_MIN_HAVE	6
+#define INFLATE_FAST_MIN_LEFT	258
+#endif
+
 void inflate_fast OF((z_streamp strm, unsigned start));
@@ -702,7 +702,7 @@ int ZEXPORT inflate(z_streamp strm, int flush)
             /* build code tables */
             state->next = state->codes;
             state->lencode = (code const FAR *)(state->next);
-            state->lenbits = 9;
+            state->lenbits = 10;
             ret = inflate_table(LENS, state->lens, state->nlen, &(state->next),
                                 &(state->lenbits), state->work);
             if (ret) {
@@ -723,7 +723,8 @@ int ZEXPORT inflate(z_streamp strm, int flush)
             state->mode = LEN;
         case LEN:
 	    schedule();
-            if (have >= 6 && left >= 258) {
+            if (have >= INFLATE_FAST_MIN_HAVE &&
+                left >= INFLATE_FAST_MIN_LEFT) {
                 RESTORE();
                 inflate_fast(strm, out);
                 LOAD();
@@ -59,3 +59,111 @@ do_free:
 	free(workspace);
 	return ret;
 }
+
+int zstd_stream_init(struct zstd_stream *strm, ulong max_window, bool flat)
+{
+	size_t wsize, ret;
+
+	if (!max_window)
+		max_window = 1UL << CONFIG_ZSTD_MAX_WINDOW_LOG;
+
+	/*
+	 * With a flat output buffer only the input side needs buffering, so
+	 * the workspace does not depend on the window size
+	 */
+	if (flat)
+		wsize = zstd_dctx_workspace_bound() + ZSTD_BLOCKSIZE_MAX;
+	else
+		wsize = zstd_dstream_workspace_bound(max_window);
+
+	strm->dstream = NULL;
+	strm->flat = flat;
+	strm->done = false;
+	strm->workspace = malloc(wsize);
+	if (!strm->workspace) {
+		debug("%s: cannot allocate workspace of size %zu\n", __func__,
+		      wsize);
+		return -ENOMEM;
+	}
+
+	strm->dstream = zstd_init_dstream(max_window, strm->workspace, wsize);
+	if (!strm->dstream) {
+		log_err("%s: zstd_init_dstream() failed\n", __func__);
+		goto err;
+	}
+
+	ret = ZSTD_DCtx_setMaxWindowSize(strm->dstream, max_window);
+	if (!zstd_is_error(ret) && flat)
+		ret = ZSTD_DCtx_setParameter(strm->dstream,
+					     ZSTD_d_stableOutBuffer, 1);
+	if (zstd_is_error(ret)) {
+		log_err("%s: cannot set parameters: %d\n", __func__,
+			zstd_get_error_code(ret));
+		goto err;
+	}
+	log_debug("workspace %zx, max window %lx%s\n", wsize, max_window,
+		  flat ? ", flat" : "");
+
+	return 0;
+
+err:
+	free(strm->workspace);
+	strm->workspace = NULL;
+
+	return -EPERM;
+}
+
+int zstd_stream_feed(struct zstd_stream *strm, zstd_in_buffer *in,
+		     zstd_out_buffer *out)
+{
+	size_t in_pos, out_pos, ret;
+
+	if (strm->done)
+		return 1;
+
+	/*
+	 * Keep going while the decoder makes progress; it may still have
+	 * buffered output to flush after the input is used up
+	 */
+	do {
+		in_pos = in->pos;
+		out_pos = out->pos;
+		ret = zstd_decompress_stream(strm->dstream, out, in);
+		if (zstd_is_error(ret)) {
+			switch (zstd_get_error_code(ret)) {
+			case ZSTD_error_dstSize_tooSmall:
+				return -E2BIG;
+			case ZSTD_error_frameParameter_windowTooLarge:
+				log_err("%s: frame window too large\n",
+					__func__);
+				return -EFBIG;
+			default:
+				log_err("%s: failed to decompress: %d\n",
+					__func__, zstd_get_error_code(ret));
+				return -EINVAL;
+			}
+		}
+		if (!ret) {
+			strm->done = true;
+			return 1;
+		}
+	} while (in->pos != in_pos || out->pos != out_pos);
+
+	/*
+	 * In flat mode the output buffer is the whole destination, so running
+	 * out of it with input left over means the frame does not fit
+	 */
+	if (strm->flat && out->pos == out->size && in->pos < in->size)
+		return -E2BIG;
+
+	return 0;
+}
+
+int zstd_stream_finish(struct zstd_stream *strm)
+{
+	free(strm->workspace);
+	strm->workspace = NULL;
+	strm->dstream = NULL;
+
+	return strm->done ? 0 : -EINVAL;
+}
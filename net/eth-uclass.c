@@ -16,6 +16,7 @@
 #include <net.h>
 #include <nvmem.h>
 #include <asm/global_data.h>
+#include <dm/deps.h>
 #include <dm/device-internal.h>
 #include <dm/uclass-internal.h>
 #include <net/pcap.h>
@@ -125,7 +126,7 @@ struct udevice *eth_get_dev(void)
 void eth_set_dev(struct udevice *dev)
 {
 	if (dev && !device_active(dev)) {
-		eth_errno = device_probe(dev);
+		eth_errno = device_probe_boot(dev);
 		if (eth_errno)
 			dev = NULL;
 	}
@@ -163,7 +164,7 @@ struct udevice *eth_get_dev_by_name(const char *devname)
 		 * match an alias or it will match a literal name and we'll pick
 		 * up the error when we try to probe again in eth_set_dev().
 		 */
-		if (device_probe(it))
+		if (device_probe_boot(it))
 			continue;
 		/* Check for the name or the sequence number to match */
 		if (strcmp(it->name, devname) == 0 ||
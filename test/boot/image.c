@@ -7,7 +7,12 @@
  */
 
 #include <common.h>
+#include <bootstage.h>
+#include <gzip.h>
 #include <image.h>
+#include <mapmem.h>
+#include <spl.h>
+#include <test/spl.h>
 #include <test/suites.h>
 #include <test/ut.h>
 #include "bootstd_common.h"
@@ -34,3 +39,206 @@ static int test_image_phase(struct unit_test_state *uts)
 	return 0;
 }
 BOOTSTD_TEST(test_image_phase, 0);
+
+/* Addresses and sizes used for building and loading a test FIT */
+#define TEST_FIT_ADDR		0x100000
+#define TEST_FIT_SIZE		0x80000
+#define TEST_LOAD_ADDR		0x400000
+#define TEST_DATA_SIZE		(200 * 1024)
+
+/**
+ * build_test_fit() - Create a FIT holding one firmware image
+ *
+ * @fit:	Buffer for the FIT, TEST_FIT_SIZE bytes
+ * @data:	Image data
+ * @size:	Size of image data
+ * @comp:	Compression name for the image
+ * @hash:	SHA256 hash to put in the hash node
+ * Return: 0 if OK, -ve libfdt error
+ */
+static int build_test_fit(void *fit, const void *data, int size,
+			  const char *comp, const u8 *hash)
+{
+	int ret;
+
+	ret = fdt_create(fit, TEST_FIT_SIZE);
+	ret |= fdt_finish_reservemap(fit);
+	ret |= fdt_begin_node(fit, "");
+	ret |= fdt_property_string(fit, FIT_DESC_PROP, "test");
+	ret |= fdt_property_u32(fit, FIT_TIMESTAMP_PROP, 0);
+	ret |= fdt_begin_node(fit, "images");
+	ret |= fdt_begin_node(fit, "firmware-1");
+	ret |= fdt_property(fit, FIT_DATA_PROP, data, size);
+	ret |= fdt_property_string(fit, FIT_TYPE_PROP, "firmware");
+	ret |= fdt_property_string(fit, FIT_ARCH_PROP, "sandbox");
+	ret |= fdt_property_string(fit, FIT_OS_PROP, "u-boot");
+	ret |= fdt_property_string(fit, FIT_COMP_PROP, comp);
+	ret |= fdt_property_u32(fit, FIT_LOAD_PROP, TEST_LOAD_ADDR);
+	ret |= fdt_begin_node(fit, "hash-1");
+	ret |= fdt_property_string(fit, FIT_ALGO_PROP, "sha256");
+	ret |= fdt_property(fit, FIT_VALUE_PROP, hash, 32);
+	ret |= fdt_end_node(fit);
+	ret |= fdt_end_node(fit);
+	ret |= fdt_end_node(fit);
+	ret |= fdt_end_node(fit);
+	ret |= fdt_finish(fit);
+
+	return ret;
+}
+
+/* Load the test FIT's image, returning the result of fit_image_load() */
+static int load_test_fit(ulong *datap, ulong *lenp)
+{
+	struct bootm_headers images;
+	const char *uname = "firmware-1";
+
+	memset(&images, '\0', sizeof(images));
+	images.verify = 1;
+
+	return fit_image_load(&images, TEST_FIT_ADDR, &uname, NULL,
+			      IH_ARCH_DEFAULT, IH_TYPE_FIRMWARE,
+			      BOOTSTAGE_ID_FIT_LOADABLE_START,
+			      FIT_LOAD_REQUIRED, datap, lenp);
+}
+
+/* Test that image hashes are checked while loading, in a single pass */
+static int test_image_fit_single_pass(struct unit_test_state *uts)
+{
+	const struct fit_load_stats *stats = fit_get_load_stats();
+	u8 hash[32], *data, *comp_data, *fit, *out;
+	uint passes = CONFIG_IS_ENABLED(FIT_SINGLE_PASS) ? 1 : 2;
+	ulong load, len, comp_len;
+	int i, hash_len, node;
+	u8 *fdata;
+
+	data = malloc(TEST_DATA_SIZE);
+	ut_assertnonnull(data);
+	for (i = 0; i < TEST_DATA_SIZE; i++)
+		data[i] = i * 7 + (i >> 9);
+	ut_assertok(calculate_hash(data, TEST_DATA_SIZE, "sha256", hash,
+				   &hash_len));
+	fit = map_sysmem(TEST_FIT_ADDR, TEST_FIT_SIZE);
+	out = map_sysmem(TEST_LOAD_ADDR, TEST_DATA_SIZE);
+
+	/* Uncompressed image copied to its load address */
+	ut_assertok(build_test_fit(fit, data, TEST_DATA_SIZE, "none", hash));
+	memset(out, '\0', TEST_DATA_SIZE);
+	ut_assert(load_test_fit(&load, &len) >= 0);
+	ut_asserteq(TEST_LOAD_ADDR, load);
+	ut_asserteq(TEST_DATA_SIZE, len);
+	ut_asserteq_mem(data, out, TEST_DATA_SIZE);
+	ut_asserteq(passes, stats->passes);
+	printf("none: %u pass(es), %lu us\n", stats->passes, stats->time_us);
+
+	/* Data changed in memory after a good load must still be caught */
+	node = fdt_path_offset(fit, "/images/firmware-1");
+	ut_assert(node >= 0);
+	fdata = fdt_getprop_w(fit, node, FIT_DATA_PROP, NULL);
+	ut_assertnonnull(fdata);
+	fdata[100] ^= 1;
+	ut_asserteq(-EACCES, load_test_fit(&load, &len));
+
+	/* A bad hash must be caught, whichever path is used */
+	hash[0] ^= 1;
+	ut_assertok(build_test_fit(fit, data, TEST_DATA_SIZE, "none", hash));
+	ut_asserteq(-EACCES, load_test_fit(&load, &len));
+	hash[0] ^= 1;
+
+	/* Compressed image, decompressed as it is hashed */
+	if (CONFIG_IS_ENABLED(GZIP_COMPRESSED)) {
+		comp_len = TEST_DATA_SIZE;
+		comp_data = malloc(comp_len);
+		ut_assertnonnull(comp_data);
+		ut_assertok(gzip(comp_data, &comp_len, data, TEST_DATA_SIZE));
+		ut_assertok(calculate_hash(comp_data, comp_len, "sha256", hash,
+					   &hash_len));
+		ut_assertok(build_test_fit(fit, comp_data, comp_len, "gzip",
+					   hash));
+		memset(out, '\0', TEST_DATA_SIZE);
+		ut_assert(load_test_fit(&load, &len) >= 0);
+		ut_asserteq(TEST_DATA_SIZE, len);
+		ut_asserteq_mem(data, out, TEST_DATA_SIZE);
+		ut_asserteq(passes, stats->passes);
+		printf("gzip: %u pass(es), %lu us\n", stats->passes,
+		       stats->time_us);
+
+		hash[5] ^= 1;
+		ut_assertok(build_test_fit(fit, comp_data, comp_len, "gzip",
+					   hash));
+		ut_asserteq(-EACCES, load_test_fit(&load, &len));
+		free(comp_data);
+	}
+	unmap_sysmem(out);
+	unmap_sysmem(fit);
+	free(data);
+
+	return 0;
+}
+BOOTSTD_TEST(test_image_fit_single_pass, 0);
+
+#if CONFIG_IS_ENABLED(FIT_VERIFY_CACHE)
+/* Test of the FIT verification cache */
+static int test_image_fit_cache(struct unit_test_state *uts)
+{
+	u8 value[FIT_CACHE_VALUE_LEN], other[FIT_CACHE_VALUE_LEN];
+	char long_name[FIT_CACHE_NAME_LEN + 1];
+	static u8 fit[FIT_CACHE_ENTRIES + 8];
+	int i;
+
+	memset(value, 0x5a, sizeof(value));
+	memset(other, 0x5a, sizeof(other));
+	other[31] ^= 1;
+	memset(long_name, 'k', FIT_CACHE_NAME_LEN);
+	long_name[FIT_CACHE_NAME_LEN] = '\0';
+
+	fit_cache_clear();
+	ut_assert(!fit_cache_check(fit, "sha256", value, 32));
+	fit_cache_add(fit, "sha256", value, 32);
+	ut_assert(fit_cache_check(fit, "sha256", value, 32));
+
+	/* Any difference must miss */
+	ut_assert(!fit_cache_check(fit + 1, "sha256", value, 32));
+	ut_assert(!fit_cache_check(fit, "sha1", value, 32));
+	ut_assert(!fit_cache_check(fit, "sha256", other, 32));
+	ut_assert(!fit_cache_check(fit, "sha256", value, 20));
+
+	/* Names which are too long are not cached */
+	fit_cache_add(fit, long_name, value, 32);
+	ut_assert(!fit_cache_check(fit, long_name, value, 32));
+
+	/* The oldest entry is replaced when the cache is full */
+	for (i = 1; i < FIT_CACHE_ENTRIES; i++)
+		fit_cache_add(fit + i, "sha256", value, 32);
+	ut_assert(fit_cache_check(fit, "sha256", value, 32));
+	fit_cache_add(fit + FIT_CACHE_ENTRIES, "sha256", value, 32);
+	ut_assert(!fit_cache_check(fit, "sha256", value, 32));
+	ut_assert(fit_cache_check(fit + FIT_CACHE_ENTRIES, "sha256", value,
+				  32));
+
+	fit_cache_clear();
+	ut_assert(!fit_cache_check(fit + 1, "sha256", value, 32));
+
+	return 0;
+}
+BOOTSTD_TEST(test_image_fit_cache, 0);
+
+/*
+ * Check the result recorded by spl_test_fit_cache() before U-Boot proper
+ * started. This is run by test_handoff_fit_cache
+ */
+static int test_image_fit_cache_spl_norun(struct unit_test_state *uts)
+{
+	u8 value[32];
+	void *addr;
+
+	memset(value, SPL_TEST_FIT_CACHE_BYTE, sizeof(value));
+	addr = map_sysmem(SPL_TEST_FIT_CACHE_ADDR, 0);
+	ut_assert(fit_cache_check(addr, "sha256", value, sizeof(value)));
+	value[0] ^= 1;
+	ut_assert(!fit_cache_check(addr, "sha256", value, sizeof(value)));
+	unmap_sysmem(addr);
+
+	return 0;
+}
+BOOTSTD_TEST(test_image_fit_cache_spl_norun, UT_TESTF_MANUAL);
+#endif
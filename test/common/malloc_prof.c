@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the malloc() profiler
+ */
+
+#include <command.h>
+#include <console.h>
+#include <errno.h>
+#include <log.h>
+#include <malloc.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <linux/compiler.h>
+#include <linux/sizes.h>
+
+/* Allocate from a known function, so the caller can be checked */
+static noinline void *prof_test_alloc(size_t size)
+{
+	void *ptr = malloc(size);
+
+	/* stop the compiler turning the call into a jump */
+	barrier();
+
+	return ptr;
+}
+
+static bool prof_caller_ok(struct malloc_prof_block *blk)
+{
+	ulong func = (ulong)prof_test_alloc;
+
+	return blk->caller > func && blk->caller < func + 0x100;
+}
+
+/* Check that blocks are recorded with their size, caller and category */
+static int common_test_malloc_prof(struct unit_test_state *uts)
+{
+	struct malloc_prof_stats before, after, fs_before, fs_after;
+	struct malloc_prof_block blk;
+	void *ptr, *big;
+	int old_cat;
+
+	ut_assertok(malloc_prof_get_stats(MALLOC_PROF_ALL, &before));
+	ut_assertok(malloc_prof_get_stats(LOGC_FS, &fs_before));
+
+	ptr = prof_test_alloc(100);
+	ut_assertnonnull(ptr);
+	ut_assertok(malloc_prof_find(ptr, &blk));
+	ut_asserteq_ptr(ptr, blk.ptr);
+	ut_asserteq(100, blk.size);
+	ut_assert(prof_caller_ok(&blk));
+
+	old_cat = malloc_prof_set_cat(LOGC_FS);
+	big = calloc(4, 1000);
+	malloc_prof_set_cat(old_cat);
+	ut_assertnonnull(big);
+	ut_assertok(malloc_prof_find(big, &blk));
+	ut_asserteq(4000, blk.size);
+	ut_asserteq(LOGC_FS, blk.cat);
+
+	ut_assertok(malloc_prof_get_stats(LOGC_FS, &fs_after));
+	ut_asserteq(fs_before.cur + 4000, fs_after.cur);
+	ut_asserteq(fs_before.count + 1, fs_after.count);
+	ut_assert(fs_after.peak >= fs_after.cur);
+	ut_assertok(malloc_prof_get_stats(MALLOC_PROF_ALL, &after));
+	ut_asserteq(before.cur + 4100, after.cur);
+
+	/* a block which moves is recorded at its new address */
+	big = realloc(big, 10000);
+	ut_assertnonnull(big);
+	ut_assertok(malloc_prof_find(big, &blk));
+	ut_asserteq(10000, blk.size);
+	ut_asserteq(LOGC_FS, blk.cat);
+
+	free(big);
+	free(ptr);
+	ut_asserteq(-ENOENT, malloc_prof_find(ptr, &blk));
+	ut_assertok(malloc_prof_get_stats(LOGC_FS, &fs_after));
+	ut_asserteq(fs_before.cur, fs_after.cur);
+	ut_assert(fs_after.peak >= fs_before.cur + 10000);
+	ut_assertok(malloc_prof_get_stats(MALLOC_PROF_ALL, &after));
+	ut_asserteq(before.cur, after.cur);
+	ut_asserteq(before.count, after.count);
+
+	ut_asserteq(-ENOENT, malloc_prof_get_stats(LOGC_COUNT, &after));
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_prof, 0);
+
+#ifdef CONFIG_SYS_MALLOC_SLAB
+/* Check that a new slab page does not count towards the peak */
+static int common_test_malloc_prof_slab(struct unit_test_state *uts)
+{
+	struct malloc_slab_stats slab_before, slab_after;
+	struct malloc_prof_stats before, after;
+	const uint cls = MALLOC_SLAB_CLASSES - 1;
+	void *ptrs[SZ_16K / MALLOC_SLAB_MAX + 1];
+	ulong peak, allocs;
+	void *spacer = NULL;
+	int old_cat, i;
+
+	old_cat = malloc_prof_set_cat(LOGC_FASTBOOT);
+
+	/* bring the usage up to the peak, so any overshoot shows */
+	ut_assertok(malloc_prof_get_stats(LOGC_FASTBOOT, &before));
+	if (before.peak > before.cur) {
+		spacer = malloc(before.peak - before.cur);
+		ut_assertnonnull(spacer);
+	}
+	ut_assertok(malloc_prof_get_stats(MALLOC_PROF_ALL, &before));
+	allocs = before.allocs;
+	peak = before.peak;
+
+	/* fill the class until it takes a new page */
+	ut_assertok(malloc_slab_get_stats(cls, &slab_before));
+	for (i = 0; i < ARRAY_SIZE(ptrs); i++) {
+		ptrs[i] = malloc(MALLOC_SLAB_MAX);
+		ut_assertnonnull(ptrs[i]);
+		ut_assertok(malloc_prof_get_stats(MALLOC_PROF_ALL, &after));
+		peak = max(peak, after.cur);
+		ut_asserteq(peak, after.peak);
+		ut_asserteq(allocs + i + 1, after.allocs);
+		ut_asserteq(before.frees, after.frees);
+
+		ut_assertok(malloc_slab_get_stats(cls, &slab_after));
+		if (slab_after.pages > slab_before.pages)
+			break;
+	}
+	malloc_prof_set_cat(old_cat);
+	ut_assert(i < ARRAY_SIZE(ptrs));
+	ut_assertok(malloc_prof_get_stats(LOGC_FASTBOOT, &after));
+	ut_asserteq(after.cur, after.peak);
+
+	while (i >= 0)
+		free(ptrs[i--]);
+	free(spacer);
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_prof_slab, 0);
+#endif
+
+/* Check the output of 'meminfo alloc' */
+static int common_test_malloc_prof_cmd(struct unit_test_state *uts)
+{
+	void *ptr;
+	int old_cat;
+
+	old_cat = malloc_prof_set_cat(LOGC_FS);
+	ptr = malloc(SZ_4M);
+	malloc_prof_set_cat(old_cat);
+	ut_assertnonnull(ptr);
+
+	ut_assertok(console_record_reset_enable());
+	ut_assertok(run_command("meminfo alloc", 0));
+	ut_assert_nextlinen("Heap: ");
+	ut_assert_nextlinen("Allocs ");
+	ut_assert_skip_to_linen("Category ");
+	ut_assert_skip_to_linen("fs ");
+	ut_assert_skip_to_linen("Caller ");
+	ut_assert_skip_to_linen("Address ");
+	ut_assert_skip_to_linen("%16lx %10u", (ulong)ptr, SZ_4M);
+	free(ptr);
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_prof_cmd, UT_TESTF_CONSOLE_REC);
@@ -7,12 +7,15 @@
 #include <abuf.h>
 #include <bootm.h>
 #include <command.h>
+#include <div64.h>
 #include <gzip.h>
 #include <image.h>
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <rand.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include <u-boot/lz4.h>
 #include <u-boot/zlib.h>
@@ -23,6 +26,8 @@
 #include <lzma/LzmaTools.h>
 
 #include <linux/lzo.h>
+#include <linux/sizes.h>
+#include <linux/xxhash.h>
 #include <linux/zstd.h>
 #include <test/compression.h>
 #include <test/suites.h>
@@ -123,6 +128,29 @@ static const char lz4_compressed[] =
 	"\x9d\x12\x8c\x9d";
 static const unsigned long lz4_compressed_size = sizeof(lz4_compressed) - 1;
 
+/* lz4 -BD -BX --content-size -B4 /tmp/plain.txt > /tmp/plain_bx.lz4 */
+static const char lz4_bx_compressed[] =
+	"\x04\x22\x4d\x18\x7c\x40\x5e\x01\x00\x00\x00\x00\x00\x00\x8f\x01"
+	"\x01\x00\x00\xff\x19\x49\x20\x61\x6d\x20\x61\x20\x68\x69\x67\x68"
+	"\x6c\x79\x20\x63\x6f\x6d\x70\x72\x65\x73\x73\x61\x62\x6c\x65\x20"
+	"\x62\x69\x74\x20\x6f\x66\x20\x74\x65\x78\x74\x2e\x0a\x28\x00\x3d"
+	"\xf1\x25\x54\x68\x65\x72\x65\x20\x61\x72\x65\x20\x6d\x61\x6e\x79"
+	"\x20\x6c\x69\x6b\x65\x20\x6d\x65\x2c\x20\x62\x75\x74\x20\x74\x68"
+	"\x69\x73\x20\x6f\x6e\x65\x20\x69\x73\x20\x6d\x69\x6e\x65\x2e\x0a"
+	"\x49\x66\x20\x49\x20\x77\x32\x00\xd1\x6e\x79\x20\x73\x68\x6f\x72"
+	"\x74\x65\x72\x2c\x20\x74\x45\x00\xf4\x0b\x77\x6f\x75\x6c\x64\x6e"
+	"\x27\x74\x20\x62\x65\x20\x6d\x75\x63\x68\x20\x73\x65\x6e\x73\x65"
+	"\x20\x69\x6e\x0a\xcf\x00\x50\x69\x6e\x67\x20\x6d\x12\x00\x00\x32"
+	"\x00\xf0\x11\x20\x66\x69\x72\x73\x74\x20\x70\x6c\x61\x63\x65\x2e"
+	"\x20\x41\x74\x20\x6c\x65\x61\x73\x74\x20\x77\x69\x74\x68\x20\x6c"
+	"\x7a\x6f\x2c\x63\x00\xf5\x14\x77\x61\x79\x2c\x0a\x77\x68\x69\x63"
+	"\x68\x20\x61\x70\x70\x65\x61\x72\x73\x20\x74\x6f\x20\x62\x65\x68"
+	"\x61\x76\x65\x20\x70\x6f\x6f\x72\x6c\x79\x4e\x00\x30\x61\x63\x65"
+	"\x27\x01\x01\x95\x00\x01\x2d\x01\xb0\x0a\x6d\x65\x73\x73\x61\x67"
+	"\x65\x73\x2e\x0a\x2e\xe8\x4d\x18\x00\x00\x00\x00\x9d\x12\x8c\x9d";
+static const unsigned long lz4_bx_compressed_size =
+	sizeof(lz4_bx_compressed) - 1;
+
 /* zstd -19 -c /tmp/plain.txt > /tmp/plain.zst */
 static const char zstd_compressed[] =
 	"\x28\xb5\x2f\xfd\x64\x5e\x00\xbd\x05\x00\x02\x0e\x26\x1a\x70\x17"
@@ -501,6 +529,76 @@ static int compression_test_lz4(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_lz4, 0);
 
+static int compression_test_lz4_frame(struct unit_test_state *uts)
+{
+	ulong plain_size = strlen(plain);
+	struct ulz4_stream strm;
+	size_t pos, avail, used, size;
+	char *frame, *buf;
+	int ret;
+
+	frame = malloc(lz4_bx_compressed_size);
+	ut_assertnonnull(frame);
+	buf = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(buf);
+
+	/* Linked blocks, with block checksums and content size */
+	size = TEST_BUFFER_SIZE;
+	ut_assertok(ulz4fn(lz4_bx_compressed, lz4_bx_compressed_size, buf,
+			   &size));
+	ut_asserteq(plain_size, size);
+	ut_asserteq_mem(plain, buf, plain_size);
+
+	/* The same, one byte of input at a time */
+	memset(buf, '\0', TEST_BUFFER_SIZE);
+	ulz4_stream_init(&strm, buf, TEST_BUFFER_SIZE);
+	pos = 0;
+	avail = 0;
+	do {
+		ut_assert(pos + avail < lz4_bx_compressed_size);
+		avail++;
+		ret = ulz4_stream_feed(&strm, lz4_bx_compressed + pos, avail,
+				       &used);
+		pos += used;
+		avail -= used;
+	} while (!ret);
+	ut_asserteq(1, ret);
+	ut_asserteq(lz4_bx_compressed_size, pos);
+	ut_asserteq(plain_size, strm.out);
+	ut_asserteq_mem(plain, buf, plain_size);
+
+	/* The content size in the header shows that the buffer is too small */
+	size = plain_size - 1;
+	ut_asserteq(-ENOBUFS, ulz4fn(lz4_bx_compressed, lz4_bx_compressed_size,
+				     buf, &size));
+
+	/* A truncated frame */
+	size = TEST_BUFFER_SIZE;
+	ut_asserteq(-EINVAL, ulz4fn(lz4_bx_compressed,
+				    lz4_bx_compressed_size - 4, buf, &size));
+
+	if (IS_ENABLED(CONFIG_LZ4_CHECKSUM)) {
+		/* Damage the block data, then the content checksum */
+		memcpy(frame, lz4_bx_compressed, lz4_bx_compressed_size);
+		frame[0x20] ^= 1;
+		size = TEST_BUFFER_SIZE;
+		ut_asserteq(-EBADMSG, ulz4fn(frame, lz4_bx_compressed_size,
+					     buf, &size));
+
+		memcpy(frame, lz4_bx_compressed, lz4_bx_compressed_size);
+		frame[lz4_bx_compressed_size - 1] ^= 1;
+		size = TEST_BUFFER_SIZE;
+		ut_asserteq(-EBADMSG, ulz4fn(frame, lz4_bx_compressed_size,
+					     buf, &size));
+	}
+
+	free(buf);
+	free(frame);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_lz4_frame, 0);
+
 static int compression_test_zstd(struct unit_test_state *uts)
 {
 	return run_test(uts, "zstd", compress_using_zstd,
@@ -508,6 +606,303 @@ static int compression_test_zstd(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_zstd, 0);
 
+/*
+ * Feed zstd data to @strm in @in_chunk pieces. If @out_chunk is not 0 the
+ * output buffer is made available @out_chunk bytes at a time.
+ */
+static int zstd_stream_chunked(struct zstd_stream *strm, const void *src,
+			       ulong src_size, ulong in_chunk,
+			       zstd_out_buffer *out, ulong out_chunk)
+{
+	zstd_in_buffer in = { .src = src };
+	ulong limit = out->size;
+	int ret = 0;
+
+	if (out_chunk)
+		out->size = 0;
+	while (!ret && in.pos < src_size && out->pos < limit) {
+		in.size = min(in.pos + in_chunk, src_size);
+		do {
+			if (out_chunk && out->pos == out->size)
+				out->size = min(out->size + out_chunk, limit);
+			ret = zstd_stream_feed(strm, &in, out);
+		} while (!ret && out->pos == out->size && out->size < limit);
+	}
+
+	return ret;
+}
+
+static int compression_test_zstd_stream(struct unit_test_state *uts)
+{
+	ulong plain_size = strlen(plain);
+	struct zstd_stream strm;
+	zstd_out_buffer out;
+	char *buf;
+
+	buf = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(buf);
+
+	/* Flat output, input a few bytes at a time */
+	ut_assertok(zstd_stream_init(&strm, 0, true));
+	out = (zstd_out_buffer){ .dst = buf, .size = TEST_BUFFER_SIZE };
+	ut_asserteq(1, zstd_stream_chunked(&strm, zstd_compressed,
+					   zstd_compressed_size, 7, &out, 0));
+	ut_assertok(zstd_stream_finish(&strm));
+	ut_asserteq(plain_size, out.pos);
+	ut_asserteq_mem(plain, buf, plain_size);
+
+	/* Output delivered in small pieces, with the window kept internally */
+	memset(buf, '\0', TEST_BUFFER_SIZE);
+	ut_assertok(zstd_stream_init(&strm, SZ_64K, false));
+	out = (zstd_out_buffer){ .dst = buf, .size = TEST_BUFFER_SIZE };
+	ut_asserteq(1, zstd_stream_chunked(&strm, zstd_compressed,
+					   zstd_compressed_size, 32, &out, 16));
+	ut_assertok(zstd_stream_finish(&strm));
+	ut_asserteq(plain_size, out.pos);
+	ut_asserteq_mem(plain, buf, plain_size);
+
+	/* A truncated frame is reported by zstd_stream_finish() */
+	ut_assertok(zstd_stream_init(&strm, 0, true));
+	out = (zstd_out_buffer){ .dst = buf, .size = TEST_BUFFER_SIZE };
+	ut_assertok(zstd_stream_chunked(&strm, zstd_compressed,
+					zstd_compressed_size - 4, 16, &out, 0));
+	ut_asserteq(-EINVAL, zstd_stream_finish(&strm));
+
+	/* A flat buffer which is too small */
+	ut_assertok(zstd_stream_init(&strm, 0, true));
+	out = (zstd_out_buffer){ .dst = buf, .size = plain_size - 1 };
+	ut_asserteq(-E2BIG, zstd_stream_chunked(&strm, zstd_compressed,
+						zstd_compressed_size, 16, &out,
+						0));
+	ut_asserteq(-EINVAL, zstd_stream_finish(&strm));
+
+	free(buf);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_stream, 0);
+
+/* Decompression benchmarks, on data that compresses like typical text */
+#define BENCH_SIZE	SZ_1M
+#define BENCH_MIN_US	200000
+
+#define LZ4_BENCH_HASH_LOG		12
+#define LZ4_BENCH_HASH_SIZE		(1 << LZ4_BENCH_HASH_LOG)
+#define LZ4_BENCH_BLOCK_CHECKSUM	BIT(4)
+#define LZ4_BENCH_CONTENT_CHECKSUM	BIT(2)
+
+static void bench_fill(char *buf, ulong size)
+{
+	ulong plain_len = strlen(plain);
+	ulong pos, len, off;
+
+	for (pos = 0; pos < size; pos += len) {
+		off = rand() % plain_len;
+		len = min(1 + (ulong)rand() % 64, plain_len - off);
+		len = min(len, size - pos);
+		memcpy(buf + pos, plain + off, len);
+	}
+}
+
+static int run_bench(struct unit_test_state *uts, char *name,
+		     mutate_func compress, mutate_func uncompress)
+{
+	ulong comp_size = BENCH_SIZE, out_size = 0;
+	ulong start, elapsed;
+	char *orig, *comp, *out;
+	u64 total = 0;
+	int ret = 0;
+
+	orig = malloc(BENCH_SIZE);
+	comp = malloc(BENCH_SIZE);
+	out = malloc(BENCH_SIZE);
+	errcheck(orig && comp && out);
+
+	bench_fill(orig, BENCH_SIZE);
+	errcheck(!compress(uts, orig, BENCH_SIZE, comp, comp_size,
+			   &comp_size));
+
+	start = timer_get_us();
+	do {
+		out_size = BENCH_SIZE;
+		errcheck(!uncompress(uts, comp, comp_size, out, BENCH_SIZE,
+				     &out_size));
+		total += out_size;
+		elapsed = timer_get_us() - start;
+	} while (elapsed < BENCH_MIN_US);
+
+	errcheck(out_size == BENCH_SIZE);
+	errcheck(!memcmp(orig, out, BENCH_SIZE));
+	printf(" %s: %lu -> %lu bytes, %llu KB/s\n", name, comp_size,
+	       out_size, lldiv(total * 1000, max(elapsed, 1UL)));
+out:
+	free(out);
+	free(comp);
+	free(orig);
+
+	return ret;
+}
+
+static int compression_test_bench_gzip(struct unit_test_state *uts)
+{
+	return run_bench(uts, "gzip", compress_using_gzip,
+			 uncompress_using_gzip);
+}
+COMPRESSION_TEST(compression_test_bench_gzip, 0);
+
+/*
+ * There is no LZ4 compressor in U-Boot, so use a minimal greedy one to make
+ * benchmark data. It returns the compressed size, or 0 if the block does not
+ * fit in @dst_max bytes.
+ */
+static ulong lz4_compress_block(const u8 *src, ulong len, u8 *dst,
+				ulong dst_max, u32 *table)
+{
+	const u8 *ip = src, *anchor = src, *end = src + len, *ref;
+	u8 *op = dst, *oend = dst + dst_max;
+	ulong lit, mlen, n;
+	u32 seq, hash;
+
+	memset(table, '\0', LZ4_BENCH_HASH_SIZE * sizeof(u32));
+	/* The last match must start 12 bytes and end 5 bytes before the end */
+	while (len > 12 && ip < end - 12) {
+		seq = get_unaligned_le32(ip);
+		hash = (seq * 2654435761U) >> (32 - LZ4_BENCH_HASH_LOG);
+		ref = src + table[hash];
+		table[hash] = ip - src;
+		if (ref >= ip || ip - ref > 0xffff ||
+		    get_unaligned_le32(ref) != seq) {
+			ip++;
+			continue;
+		}
+		for (mlen = 4; ip + mlen < end - 5 && ip[mlen] == ref[mlen];)
+			mlen++;
+
+		lit = ip - anchor;
+		if (op + 1 + lit / 255 + 1 + lit + 2 + mlen / 255 + 1 > oend)
+			return 0;
+		*op++ = min(lit, 15UL) << 4 | min(mlen - 4, 15UL);
+		if (lit >= 15) {
+			for (n = lit - 15; n >= 255; n -= 255)
+				*op++ = 255;
+			*op++ = n;
+		}
+		memcpy(op, anchor, lit);
+		op += lit;
+		put_unaligned_le16(ip - ref, op);
+		op += 2;
+		if (mlen - 4 >= 15) {
+			for (n = mlen - 4 - 15; n >= 255; n -= 255)
+				*op++ = 255;
+			*op++ = n;
+		}
+		ip += mlen;
+		anchor = ip;
+	}
+
+	lit = end - anchor;
+	if (op + 1 + lit / 255 + 1 + lit > oend)
+		return 0;
+	*op++ = min(lit, 15UL) << 4;
+	if (lit >= 15) {
+		for (n = lit - 15; n >= 255; n -= 255)
+			*op++ = 255;
+		*op++ = n;
+	}
+	memcpy(op, anchor, lit);
+	op += lit;
+
+	return op - dst;
+}
+
+/* Make an LZ4 frame with independent 64KB blocks and the given FLG bits */
+static int compress_lz4_frame(void *in, ulong in_size, void *out,
+			      ulong out_max, ulong *out_size, u8 flags)
+{
+	u8 *op = out, *oend = out + out_max;
+	ulong pos, len, size;
+	u32 *table;
+
+	table = malloc(LZ4_BENCH_HASH_SIZE * sizeof(u32));
+	if (!table || out_max < 7)
+		return -ENOMEM;
+
+	put_unaligned_le32(LZ4F_MAGIC, op);
+	op[4] = 0x40 | 0x20 | flags;
+	op[5] = 0x40;
+	op[6] = (xxh32(op + 4, 2, 0) >> 8) & 0xff;
+	op += 7;
+
+	for (pos = 0; pos < in_size; pos += len) {
+		len = min(in_size - pos, (ulong)SZ_64K);
+		if (oend - op < 4 + len + 8)
+			goto err;
+		size = lz4_compress_block(in + pos, len, op + 4, len, table);
+		if (size) {
+			put_unaligned_le32(size, op);
+		} else {
+			size = len;
+			put_unaligned_le32(size | 0x80000000U, op);
+			memcpy(op + 4, in + pos, len);
+		}
+		op += 4 + size;
+		if (flags & LZ4_BENCH_BLOCK_CHECKSUM) {
+			put_unaligned_le32(xxh32(op - size, size, 0), op);
+			op += 4;
+		}
+	}
+
+	if (oend - op < 8)
+		goto err;
+	put_unaligned_le32(0, op);
+	op += 4;
+	if (flags & LZ4_BENCH_CONTENT_CHECKSUM) {
+		put_unaligned_le32(xxh32(in, in_size, 0), op);
+		op += 4;
+	}
+	*out_size = op - (u8 *)out;
+	free(table);
+
+	return 0;
+
+err:
+	free(table);
+	return -ENOSPC;
+}
+
+static int compress_using_lz4_frame(struct unit_test_state *uts,
+				    void *in, unsigned long in_size,
+				    void *out, unsigned long out_max,
+				    unsigned long *out_size)
+{
+	return compress_lz4_frame(in, in_size, out, out_max, out_size, 0);
+}
+
+static int compress_using_lz4_frame_checksums(struct unit_test_state *uts,
+					      void *in, unsigned long in_size,
+					      void *out, unsigned long out_max,
+					      unsigned long *out_size)
+{
+	return compress_lz4_frame(in, in_size, out, out_max, out_size,
+				  LZ4_BENCH_BLOCK_CHECKSUM |
+				  LZ4_BENCH_CONTENT_CHECKSUM);
+}
+
+static int compression_test_bench_lz4(struct unit_test_state *uts)
+{
+	return run_bench(uts, "lz4", compress_using_lz4_frame,
+			 uncompress_using_lz4);
+}
+COMPRESSION_TEST(compression_test_bench_lz4, 0);
+
+static int compression_test_bench_lz4_checksums(struct unit_test_state *uts)
+{
+	return run_bench(uts, "lz4 with checksums",
+			 compress_using_lz4_frame_checksums,
+			 uncompress_using_lz4);
+}
+COMPRESSION_TEST(compression_test_bench_lz4_checksums, 0);
+
 static int compress_using_none(struct unit_test_state *uts,
 			       void *in, unsigned long in_size,
 			       void *out, unsigned long out_max,
@@ -12,7 +12,9 @@
 #include <log.h>
 #include <malloc.h>
 #include <asm/global_data.h>
+#include <dm/deps.h>
 #include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/root.h>
 #include <dm/util.h>
 #include <dm/test.h>
@@ -1353,3 +1355,176 @@ static int dm_test_dev_get_mem(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_dev_get_mem, UT_TESTF_SCAN_FDT);
+
+/* Find a driver for a compatible string by searching every driver */
+static struct driver *find_compat_driver(const char *compat,
+					 const struct udevice_id **idp)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id;
+	struct driver *entry;
+
+	for (entry = drv; entry != drv + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			if (!strcmp(id->compatible, compat)) {
+				*idp = id;
+				return entry;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/* Test looking up drivers by compatible string */
+static int dm_test_lists_compat(struct unit_test_state *uts)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *id, *expect_id, *found_id;
+	struct driver *entry, *expect;
+	int count = 0;
+
+	/* Every compatible string gives the first driver which has it */
+	for (entry = drv; entry != drv + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++) {
+			const char *compat = id->compatible;
+
+			expect = find_compat_driver(compat, &expect_id);
+			ut_asserteq_ptr(expect,
+					lists_driver_lookup_compat(compat,
+								   &found_id));
+			ut_asserteq_ptr(expect_id, found_id);
+			count++;
+		}
+	}
+	ut_assert(count > 0);
+
+	ut_assertnull(lists_driver_lookup_compat("u-boot,no-such-device",
+						 &found_id));
+	ut_assertnull(found_id);
+
+	if (CONFIG_IS_ENABLED(DM_COMPAT_INDEX))
+		ut_assertnonnull(gd_dm_compat_index());
+
+	return 0;
+}
+DM_TEST(dm_test_lists_compat, UT_TESTF_SCAN_FDT);
+
+/* Test that repeated uclass and device lookups do not search the lists */
+static int dm_test_uclass_index(struct unit_test_state *uts)
+{
+	struct dm_uclass_table *tbl = gd_dm_uclass_table();
+	struct udevice *dev, *found;
+	struct uclass *uc;
+	ofnode node, other;
+	uint walks;
+	int i, seq;
+
+	if (!CONFIG_IS_ENABLED(DM_UCLASS_INDEX))
+		return -EAGAIN;
+	ut_assertnonnull(tbl);
+
+	/* The first lookup builds the index */
+	ut_assertok(uclass_find_device(UCLASS_TEST_FDT, 0, &dev));
+	walks = tbl->walks;
+
+	for (i = 0; i < 100; i++) {
+		ut_assertok(uclass_get(UCLASS_TEST_FDT, &uc));
+		seq = 0;
+		uclass_foreach_dev(dev, uc) {
+			ut_assertok(uclass_find_device(UCLASS_TEST_FDT, seq++,
+						       &found));
+			ut_asserteq_ptr(dev, found);
+			ut_assertok(uclass_find_device_by_seq(UCLASS_TEST_FDT,
+							      dev_seq(dev),
+							      &found));
+			ut_asserteq_ptr(dev, found);
+			node = dev_ofnode(dev);
+			if (!ofnode_valid(node))
+				continue;
+			ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT,
+								 node, &found));
+			ut_asserteq_ptr(dev, found);
+		}
+		ut_asserteq(-ENODEV, uclass_find_device(UCLASS_TEST_FDT, seq,
+							&found));
+	}
+	ut_asserteq(walks, tbl->walks);
+
+	/* Binding a device updates the index, with a single walk */
+	node = ofnode_path("/some-bus/c-test@1");
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+							  &found));
+	ut_assertok(device_bind(dm_root(), DM_DRIVER_GET(denx_u_boot_fdt_test),
+				"c-test@1", NULL, node, &dev));
+	walks = tbl->walks;
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+						 &found));
+	ut_asserteq_ptr(dev, found);
+	ut_assertok(uclass_find_device_by_seq(UCLASS_TEST_FDT, 12, &found));
+	ut_asserteq_ptr(dev, found);
+	ut_asserteq(walks + 1, tbl->walks);
+
+	/* Moving it to another node updates the index */
+	other = ofnode_path("/some-bus");
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT,
+							  other, &found));
+	dev_set_ofnode(dev, other);
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT, other,
+						 &found));
+	ut_asserteq_ptr(dev, found);
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+							  &found));
+	dev_set_ofnode(dev, node);
+
+	/* Unbinding it removes it */
+	ut_assertok(device_unbind(dev));
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node,
+							  &found));
+	ut_asserteq(-ENODEV, uclass_find_device_by_seq(UCLASS_TEST_FDT, 12,
+						       &found));
+
+	return 0;
+}
+DM_TEST(dm_test_uclass_index, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test that dependencies are found from the devicetree and probed first */
+static int dm_test_device_deps(struct unit_test_state *uts)
+{
+	struct udevice *dev, *fixed, *sbox, *ccf;
+	struct udevice *deps[8];
+
+	if (!CONFIG_IS_ENABLED(DM_DEPS))
+		return -EAGAIN;
+
+	ut_assertok(uclass_find_device_by_name(UCLASS_MISC, "clk-test", &dev));
+	ut_assertok(uclass_find_device_by_name(UCLASS_CLK, "clk-fixed",
+					       &fixed));
+	ut_assertok(uclass_find_device_by_name(UCLASS_CLK, "clk-sbox", &sbox));
+	ut_assertok(uclass_find_device_by_name(UCLASS_CLK, "clk-ccf", &ccf));
+
+	/* Each provider is listed once, in the order it is first used */
+	ut_asserteq(3, dev_get_deps(dev, deps, ARRAY_SIZE(deps)));
+	ut_asserteq_ptr(fixed, deps[0]);
+	ut_asserteq_ptr(sbox, deps[1]);
+	ut_asserteq_ptr(ccf, deps[2]);
+	ut_asserteq(-E2BIG, dev_get_deps(dev, deps, 1));
+	ut_asserteq_ptr(fixed, deps[0]);
+	ut_asserteq(0, dev_get_deps(fixed, deps, ARRAY_SIZE(deps)));
+
+	ut_asserteq(0, dev_get_dep_level(dm_root()));
+	ut_asserteq(0, dev_get_dep_level(fixed));
+	ut_asserteq(1, dev_get_dep_level(dev));
+
+	ut_assert(!(dev_get_flags(dev) & DM_FLAG_ACTIVATED));
+	ut_assertok(device_probe_deps(dev));
+	ut_assert(dev_get_flags(dev) & DM_FLAG_ACTIVATED);
+	ut_assert(dev_get_flags(fixed) & DM_FLAG_ACTIVATED);
+	ut_assert(dev_get_flags(sbox) & DM_FLAG_ACTIVATED);
+	ut_assert(dev_get_flags(ccf) & DM_FLAG_ACTIVATED);
+
+	return 0;
+}
+DM_TEST(dm_test_device_deps, UT_TESTF_SCAN_FDT);
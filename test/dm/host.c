@@ -8,6 +8,7 @@
 #include <blk.h>
 #include <dm.h>
 #include <fs.h>
+#include <mapmem.h>
 #include <os.h>
 #include <sandbox_host.h>
 #include <asm/test.h>
@@ -109,6 +110,92 @@ static int dm_test_host_dup(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_host_dup, UT_TESTF_SCAN_FDT);
 
+/* Address and size of the file written by dm_test_host_fs_file() */
+#define FS_FILE_ADDR	0x100000
+#define FS_FILE_SIZE	0x4000
+
+/* Test reading a file on a host device through fs_file_...() handles */
+static int dm_test_host_fs_file(struct unit_test_state *uts)
+{
+	static char label[] = "test";
+	struct fs_file *file1, *file2;
+	struct udevice *dev, *blk;
+	loff_t actwrite, actread, size;
+	struct blk_desc *desc;
+	char fname[256];
+	char buf[0x400];
+	ulong mem_start;
+	u8 *data;
+	int i;
+
+	mem_start = ut_check_delta(0);
+	ut_assertok(host_create_device(label, true, DEFAULT_BLKSZ, &dev));
+
+	/* Attach a file created in test_ut_dm_init */
+	ut_assertok(os_persistent_file(fname, sizeof(fname), "2MB.ext2.img"));
+	ut_assertok(host_attach_file(dev, fname));
+	ut_assertok(blk_get_from_parent(dev, &blk));
+	ut_assertok(device_probe(blk));
+	desc = dev_get_uclass_plat(blk);
+
+	/* Write a file spanning several blocks, with a pattern to check */
+	data = map_sysmem(FS_FILE_ADDR, FS_FILE_SIZE);
+	for (i = 0; i < FS_FILE_SIZE; i++)
+		data[i] = i * 7 + (i >> 8);
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_write("/handles", FS_FILE_ADDR, 0, FS_FILE_SIZE,
+			     &actwrite));
+	ut_asserteq(FS_FILE_SIZE, actwrite);
+
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_asserteq(-ENOENT, fs_file_open("/missing", &file1));
+
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_file_open("/handles", &file1));
+	ut_assertok(fs_file_size(file1, &size));
+	ut_asserteq(FS_FILE_SIZE, size);
+	ut_assertok(fs_file_pread(file1, buf, 0x123, 0x100, &actread));
+	ut_asserteq(0x100, actread);
+	ut_asserteq_mem(data + 0x123, buf, 0x100);
+
+	/* Each of two open handles must keep reading the right file */
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_file_open("/handles", &file2));
+	ut_assertok(fs_file_pread(file2, buf, 0x2345, sizeof(buf), &actread));
+	ut_asserteq(sizeof(buf), actread);
+	ut_asserteq_mem(data + 0x2345, buf, sizeof(buf));
+
+	ut_assertok(fs_file_pread(file1, buf, 0x3f00, sizeof(buf), &actread));
+	ut_asserteq(0x100, actread);
+	ut_asserteq_mem(data + 0x3f00, buf, 0x100);
+
+	ut_assertok(fs_file_pread(file2, buf, 0, sizeof(buf), &actread));
+	ut_asserteq(sizeof(buf), actread);
+	ut_asserteq_mem(data, buf, sizeof(buf));
+
+	/* Another filesystem operation unmounts the filesystem in between */
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_size("/handles", &size));
+	ut_assertok(fs_file_pread(file1, buf, 0x1001, 0x80, &actread));
+	ut_asserteq(0x80, actread);
+	ut_asserteq_mem(data + 0x1001, buf, 0x80);
+
+	/* Removing the device makes reads fail on both handles */
+	ut_assertok(host_detach_file(dev));
+	ut_asserteq(-ENODEV, fs_file_pread(file1, buf, 0, 0x100, &actread));
+	ut_asserteq(-ENODEV, fs_file_pread(file2, buf, 0, 0x100, &actread));
+	fs_file_close(file1);
+	fs_file_close(file2);
+	unmap_sysmem(data);
+	ut_assertok(device_unbind(dev));
+
+	/* check there were no memory leaks */
+	ut_asserteq(0, ut_check_delta(mem_start));
+
+	return 0;
+}
+DM_TEST(dm_test_host_fs_file, UT_TESTF_SCAN_FDT);
+
 /* Basic test of 'host' command */
 static int dm_test_cmd_host(struct unit_test_state *uts)
 {
@@ -1522,3 +1522,128 @@ static int dm_test_bool(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_bool, UT_TESTF_SCAN_FDT);
+
+/* Test the phandle and path lookup cache used with a flat tree */
+static int dm_test_ofnode_lookup_cache(struct unit_test_state *uts)
+{
+	const void *fdt = ofnode_to_fdt(ofnode_root());
+	ofnode node, subnode;
+	int offset, count = 0;
+	char path[256];
+	uint phandle;
+
+	if (!CONFIG_IS_ENABLED(OF_LOOKUP_CACHE))
+		return -EAGAIN;
+
+	/* Look up each node twice, so the second lookup uses the cache */
+	for (offset = fdt_next_node(fdt, -1, NULL); offset >= 0;
+	     offset = fdt_next_node(fdt, offset, NULL)) {
+		phandle = fdt_get_phandle(fdt, offset);
+		if (phandle) {
+			ut_asserteq(offset,
+				    ofnode_fdt_phandle_offset(fdt, phandle));
+			ut_asserteq(offset,
+				    ofnode_fdt_phandle_offset(fdt, phandle));
+			count++;
+		}
+		ut_assertok(fdt_get_path(fdt, offset, path, sizeof(path)));
+		ut_asserteq(offset, ofnode_to_offset(ofnode_path(path)));
+		ut_asserteq(offset, ofnode_to_offset(ofnode_path(path)));
+	}
+	ut_assert(count > 0);
+
+	ut_assert(!ofnode_valid(ofnode_path("/no-such-node")));
+	ut_assert(!ofnode_valid(ofnode_path("/no-such-node")));
+
+	/* Paths ending in the same node name must not be confused */
+	ut_assert(!ofnode_valid(ofnode_path("/no-such-bus/c-test@1")));
+	ut_asserteq_str("c-test@1",
+			ofnode_get_name(ofnode_path("/some-bus/c-test@1")));
+	ut_assert(!ofnode_valid(ofnode_path("/no-such-bus/c-test@1")));
+	ut_asserteq(-FDT_ERR_NOTFOUND, ofnode_fdt_phandle_offset(fdt, 0xfffff));
+	node = ofnode_find_subnode(ofnode_path("/some-bus"), "c-test@1");
+	ut_asserteq_str("c-test@1", ofnode_get_name(node));
+	node = ofnode_find_subnode(ofnode_path("/some-bus"), "c-test@1");
+	ut_asserteq_str("c-test@1", ofnode_get_name(node));
+	ut_asserteq_str("c-test@1", ofnode_get_name(ofnode_path("testfdt12")));
+
+	/* Adding a node moves the nodes after it, so the cache is rebuilt */
+	offset = ofnode_to_offset(node);
+	node = ofnode_path("/pinctrl-gpio/pinmux-gpios");
+	phandle = fdt_get_phandle(fdt, ofnode_to_offset(node));
+	ut_assert(phandle);
+	ut_assertok(ofnode_add_subnode(ofnode_root(), "lookup-cache", &subnode));
+
+	node = ofnode_path("/some-bus/c-test@1");
+	ut_assert(ofnode_to_offset(node) != offset);
+	ut_asserteq(fdt_path_offset(fdt, "/some-bus/c-test@1"),
+		    ofnode_to_offset(node));
+	node = ofnode_find_subnode(ofnode_path("/some-bus"), "c-test@1");
+	ut_asserteq_str("c-test@1", ofnode_get_name(node));
+	ut_asserteq_str("pinmux-gpios",
+			ofnode_get_name(ofnode_get_by_phandle(phandle)));
+	ut_asserteq(ofnode_to_offset(subnode),
+		    ofnode_to_offset(ofnode_path("/lookup-cache")));
+
+	/* Changing an alias in place does not resize the tree */
+	node = ofnode_path("/aliases");
+	ut_assertok(ofnode_write_string(node, "lookup-cache",
+					"/some-bus/c-test@0"));
+	ut_asserteq_str("c-test@0",
+			ofnode_get_name(ofnode_path("lookup-cache")));
+	ut_asserteq_str("c-test@0",
+			ofnode_get_name(ofnode_path("lookup-cache")));
+	ut_assertok(ofnode_write_string(node, "lookup-cache",
+					"/some-bus/c-test@1"));
+	ut_asserteq_str("c-test@1",
+			ofnode_get_name(ofnode_path("lookup-cache")));
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_lookup_cache, UT_TESTF_SCAN_FDT | UT_TESTF_FLAT_TREE);
+
+/* Test finding nodes by phandle in a live tree, which uses an index */
+static int dm_test_livetree_phandle(struct unit_test_state *uts)
+{
+	struct device_node *root = gd_of_root();
+	struct device_node *np, *first;
+	phandle max = 0;
+	int count = 0;
+
+	/* Each phandle gives the first node in the tree which has it */
+	for (np = root; np; np = of_find_all_nodes(np)) {
+		if (!np->phandle)
+			continue;
+		max = max(max, np->phandle);
+		first = root;
+		while (first->phandle != np->phandle)
+			first = of_find_all_nodes(first);
+		ut_asserteq_ptr(first,
+				of_find_node_by_phandle(NULL, np->phandle));
+		count++;
+	}
+	ut_assert(count > 0);
+	ut_assertnull(of_find_node_by_phandle(NULL, 0xfffff));
+
+	/* A phandle with no node in the index is still searched for */
+	ut_assert(max > 1);
+	np = of_find_node_by_phandle(NULL, 1);
+	ut_assertnonnull(np);
+	np->phandle = 0;
+	ut_assertok(of_phandle_index_add(root));
+	np->phandle = 1;
+	ut_asserteq_ptr(np, of_find_node_by_phandle(NULL, 1));
+	ut_assertok(of_phandle_index_add(root));
+
+	/* Removing a node from the other tree drops its index */
+	root = uts->of_other;
+	np = of_find_node_opts_by_path(root, "/target", NULL);
+	ut_assertnonnull(np);
+	ut_asserteq_ptr(np, of_find_node_by_phandle(root, np->phandle));
+	ut_assertok(of_remove_node(np));
+	ut_assertnull(of_find_node_by_phandle(root, np->phandle));
+
+	return 0;
+}
+DM_TEST(dm_test_livetree_phandle, UT_TESTF_SCAN_FDT | UT_TESTF_LIVE_TREE |
+	UT_TESTF_OTHER_FDT);
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Test passing FIT verification results from SPL to U-Boot proper
+ */
+
+#include <image.h>
+#include <mapmem.h>
+#include <spl.h>
+#include <test/spl.h>
+#include <test/ut.h>
+
+/*
+ * Record a result for U-Boot proper to find; see test_image_fit_cache_spl_norun
+ * and test_handoff_fit_cache
+ */
+static int spl_test_fit_cache(struct unit_test_state *uts)
+{
+	u8 value[32];
+	void *addr;
+
+	memset(value, SPL_TEST_FIT_CACHE_BYTE, sizeof(value));
+	addr = map_sysmem(SPL_TEST_FIT_CACHE_ADDR, 0);
+	fit_cache_add(addr, "sha256", value, sizeof(value));
+	ut_assert(fit_cache_check(addr, "sha256", value, sizeof(value)));
+	unmap_sysmem(addr);
+
+	return 0;
+}
+SPL_TEST(spl_test_fit_cache, 0);
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Throughput benchmark for the hash algorithms
+ *
+ * This reports MB/s for each algorithm, for one-shot and progressive hashing
+ * and for aligned and misaligned buffers, so that regressions in lib/sha*.c,
+ * lib/crc32.c and friends show up in the test log.
+ */
+
+#include <common.h>
+#include <hash.h>
+#include <malloc.h>
+#include <linux/sizes.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+#define HASH_BENCH_SIZE		SZ_256K
+#define HASH_BENCH_MIN_US	10000
+
+static int lib_test_hash_bench(struct unit_test_state *uts)
+{
+	static const uint chunks[] = { 0, 64, SZ_4K };
+	static const uint aligns[] = { 0, 1, 4 };
+	struct hash_algo *algo;
+	ulong kbps;
+	int c, a, ret;
+	u8 *buf;
+
+	buf = malloc(HASH_BENCH_SIZE + 4);
+	ut_assertnonnull(buf);
+	memset(buf, 0xa5, HASH_BENCH_SIZE + 4);
+
+	for (algo = hash_next_algo(NULL); algo; algo = hash_next_algo(algo)) {
+		for (c = 0; c < ARRAY_SIZE(chunks); c++) {
+			for (a = 0; a < ARRAY_SIZE(aligns); a++) {
+				ret = hash_bench(algo, buf + aligns[a],
+						 HASH_BENCH_SIZE, chunks[c],
+						 HASH_BENCH_MIN_US, &kbps);
+				if (ret == -ENOSYS)
+					break;
+				ut_assertok(ret);
+				printf("%-12s chunk %5u align %u: %6lu.%03lu MB/s\n",
+				       algo->name, chunks[c], aligns[a],
+				       kbps / 1000, kbps % 1000);
+			}
+		}
+	}
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_hash_bench, 0);
@@ -8,6 +8,7 @@
 #include <lmb.h>
 #include <log.h>
 #include <malloc.h>
+#include <time.h>
 #include <dm/test.h>
 #include <test/lib.h>
 #include <test/test.h>
@@ -668,7 +669,8 @@ static int lib_test_lmb_get_free_size(struct unit_test_state *uts)
 }
 LIB_TEST(lib_test_lmb_get_free_size, 0);
 
-#ifdef CONFIG_LMB_USE_MAX_REGIONS
+/* The limit is only reached when the arrays cannot grow */
+#if defined(CONFIG_LMB_USE_MAX_REGIONS) && !defined(CONFIG_LMB_DYNAMIC_REGIONS)
 static int lib_test_lmb_max_regions(struct unit_test_state *uts)
 {
 	const phys_addr_t ram = 0x00000000;
@@ -824,3 +826,171 @@ static int lib_test_lmb_flags(struct unit_test_state *uts)
 	return 0;
 }
 LIB_TEST(lib_test_lmb_flags, 0);
+
+#ifdef CONFIG_LMB_DYNAMIC_REGIONS
+/* Number of regions for the growth test, and the most for the scale test */
+#define LMB_GROW_REGIONS	1000
+#define LMB_SCALE_REGIONS	16000
+
+/* Visit each of @count blocks once, in a scattered order */
+static int lmb_scatter(int i, int count)
+{
+	return (i * 7) % count;
+}
+
+/* Check that the region arrays grow and still merge and split regions */
+static int test_grow(struct unit_test_state *uts, struct lmb *lmb)
+{
+	const phys_addr_t ram = 0x40000000;
+	const phys_size_t ram_size = 0x20000000;
+	const phys_size_t blk_size = 0x1000;
+	const int count = LMB_GROW_REGIONS;
+	phys_addr_t offset, end;
+	int i, j;
+
+	ut_asserteq(0, lmb_add(lmb, ram, ram_size));
+
+	/* reserve every other block */
+	for (i = 0; i < count; i++) {
+		j = lmb_scatter(i, count);
+		ut_asserteq(0, lmb_reserve(lmb, ram + 2 * j * blk_size,
+					   blk_size));
+	}
+	ut_asserteq(count, lmb->reserved.cnt);
+	ut_assert(lmb->reserved.max >= count);
+	for (i = 0; i < count; i++) {
+		ut_asserteq(ram + 2 * i * blk_size, lmb->reserved.region[i].base);
+		ut_asserteq(blk_size, lmb->reserved.region[i].size);
+	}
+
+	/* lookups find each region and each gap */
+	for (i = 0; i < count; i++) {
+		offset = ram + 2 * i * blk_size;
+		end = i < count - 1 ? offset + 2 * blk_size : ram + ram_size;
+		ut_asserteq(1, lmb_is_reserved(lmb, offset + blk_size - 1));
+		ut_asserteq(0, lmb_is_reserved(lmb, offset + blk_size));
+		ut_asserteq(0, lmb_get_free_size(lmb, offset));
+		ut_asserteq(end - offset - blk_size,
+			    lmb_get_free_size(lmb, offset + blk_size));
+		ut_asserteq(-1, lmb_reserve(lmb, offset + blk_size / 2,
+					    blk_size));
+	}
+
+	/* filling the gaps merges everything into one region */
+	for (i = 0; i < count; i++) {
+		j = lmb_scatter(i, count);
+		offset = ram + (2 * j + 1) * blk_size;
+		ut_assert(lmb_reserve(lmb, offset, blk_size) > 0);
+	}
+	ut_asserteq(1, lmb->reserved.cnt);
+	ut_asserteq(ram, lmb->reserved.region[0].base);
+	ut_asserteq(2 * count * blk_size, lmb->reserved.region[0].size);
+
+	/* and freeing them splits it up again */
+	for (i = 0; i < count; i++) {
+		j = lmb_scatter(i, count);
+		offset = ram + (2 * j + 1) * blk_size;
+		ut_asserteq(0, lmb_free(lmb, offset, blk_size));
+	}
+	ut_asserteq(count, lmb->reserved.cnt);
+	for (i = 0; i < count; i++)
+		ut_asserteq(ram + 2 * i * blk_size, lmb->reserved.region[i].base);
+	lmb_uninit(lmb);
+	ut_asserteq(0, lmb->reserved.cnt);
+
+	/* the memory array grows too; allocate the top of each bank */
+	for (i = 0; i < count; i++) {
+		j = lmb_scatter(i, count);
+		ut_asserteq(0, lmb_add(lmb, ram + 2 * j * blk_size, blk_size));
+	}
+	ut_asserteq(count, lmb->memory.cnt);
+	for (i = count - 1; i >= 0; i--)
+		ut_asserteq(ram + 2 * i * blk_size,
+			    lmb_alloc(lmb, blk_size, blk_size));
+	ut_asserteq(0, __lmb_alloc_base(lmb, blk_size, blk_size,
+					ram + ram_size));
+	ut_asserteq(count, lmb->reserved.cnt);
+
+	return 0;
+}
+
+static int lib_test_lmb_grow(struct unit_test_state *uts)
+{
+	struct lmb lmb;
+	ulong start;
+	int ret;
+
+	/* free the arrays even if a check fails */
+	start = ut_check_free();
+	lmb_init(&lmb);
+	ret = test_grow(uts, &lmb);
+	lmb_uninit(&lmb);
+	ut_assertok(ut_check_delta(start));
+
+	return ret;
+}
+LIB_TEST(lib_test_lmb_grow, 0);
+
+/* Time reserving, looking up and freeing regions as their number grows */
+static int test_scale(struct unit_test_state *uts, struct lmb *lmb)
+{
+	const phys_addr_t ram = 0x40000000;
+	const phys_size_t ram_size = 0x40000000;
+	const phys_size_t blk_size = 0x1000;
+	ulong reserve_us, lookup_us, free_us;
+	phys_addr_t offset;
+	ulong start;
+	int count, i, j;
+
+	ut_asserteq(0, lmb_add(lmb, ram, ram_size));
+
+	printf("%8s %12s %12s %12s\n", "Regions", "Reserve ns", "Lookup ns",
+	       "Free ns");
+	for (count = LMB_GROW_REGIONS; count <= LMB_SCALE_REGIONS; count *= 4) {
+		start = timer_get_us();
+		for (i = 0; i < count; i++) {
+			j = lmb_scatter(i, count);
+			ut_asserteq(0, lmb_reserve(lmb, ram + 2 * j * blk_size,
+						   blk_size));
+		}
+		reserve_us = timer_get_us() - start;
+		ut_asserteq(count, lmb->reserved.cnt);
+
+		start = timer_get_us();
+		for (i = 0; i < count; i++) {
+			offset = ram + 2 * i * blk_size;
+			ut_asserteq(1, lmb_is_reserved(lmb, offset));
+			ut_asserteq(0, lmb_is_reserved(lmb, offset + blk_size));
+		}
+		lookup_us = timer_get_us() - start;
+
+		start = timer_get_us();
+		for (i = 0; i < count; i++) {
+			j = lmb_scatter(i, count);
+			ut_asserteq(0, lmb_free(lmb, ram + 2 * j * blk_size,
+						blk_size));
+		}
+		free_us = timer_get_us() - start;
+		ut_asserteq(0, lmb->reserved.cnt);
+
+		printf("%8d %12lu %12lu %12lu\n", count,
+		       reserve_us * 1000 / count, lookup_us * 1000 / count / 2,
+		       free_us * 1000 / count);
+	}
+
+	return 0;
+}
+
+static int lib_test_lmb_scale(struct unit_test_state *uts)
+{
+	struct lmb lmb;
+	int ret;
+
+	lmb_init(&lmb);
+	ret = test_scale(uts, &lmb);
+	lmb_uninit(&lmb);
+
+	return ret;
+}
+LIB_TEST(lib_test_lmb_scale, 0);
+#endif
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests and benchmark for the slab front-end of malloc()
+ *
+ * The benchmark reports the time taken by malloc()/free() pairs for each
+ * slab class and for a size served by the main pool, one at a time and in
+ * batches, so that changes in the allocator show up in the test log.
+ */
+
+#include <errno.h>
+#include <malloc.h>
+#include <time.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+#define SLAB_BENCH_LOOPS	20000
+#define SLAB_BENCH_BATCH	500
+
+/* Check that each size gets the right class, aligned to its size */
+static int lib_test_malloc_slab_class(struct unit_test_state *uts)
+{
+	static const struct {
+		uint bytes;
+		uint size;
+	} tests[] = {
+		{ 0, 16 }, { 1, 16 }, { 16, 16 }, { 17, 32 }, { 32, 32 },
+		{ 33, 64 }, { 64, 64 }, { 100, 128 }, { 255, 256 },
+		{ 257, 512 }, { 512, 512 },
+	};
+	void *ptr;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		ptr = malloc(tests[i].bytes);
+		ut_assertnonnull(ptr);
+		ut_asserteq(tests[i].size, malloc_usable_size(ptr));
+		ut_asserteq(tests[i].size, malloc_slab_usable_size(ptr));
+		ut_asserteq(0, (ulong)ptr & (tests[i].size - 1));
+		free(ptr);
+	}
+
+	/* larger sizes come from the main pool */
+	ptr = malloc(MALLOC_SLAB_MAX + 1);
+	ut_assertnonnull(ptr);
+	ut_asserteq(0, malloc_slab_usable_size(ptr));
+	ut_assert(malloc_usable_size(ptr) > MALLOC_SLAB_MAX);
+	free(ptr);
+
+	return 0;
+}
+LIB_TEST(lib_test_malloc_slab_class, 0);
+
+/* Check calloc(), realloc(), the statistics and leak accounting */
+static int lib_test_malloc_slab_ops(struct unit_test_state *uts)
+{
+	struct malloc_slab_stats before, after;
+	void *ptrs[40];
+	ulong start;
+	char *ptr, *new;
+	int i;
+
+	ptr = malloc(100);
+	ut_assertnonnull(ptr);
+	memset(ptr, 0xff, 100);
+	free(ptr);
+	ptr = calloc(1, 100);
+	ut_assertnonnull(ptr);
+	for (i = 0; i < 100; i++)
+		ut_asserteq(0, ptr[i]);
+	free(ptr);
+
+	/* growing within the class stays put; beyond it moves the data */
+	ptr = malloc(20);
+	ut_assertnonnull(ptr);
+	strcpy(ptr, "slab");
+	ut_asserteq_ptr(ptr, realloc(ptr, 30));
+	new = realloc(ptr, 100);
+	ut_assertnonnull(new);
+	ut_asserteq_str("slab", new);
+	ut_asserteq(128, malloc_slab_usable_size(new));
+	ptr = realloc(new, 1000);
+	ut_assertnonnull(ptr);
+	ut_asserteq_str("slab", ptr);
+	ut_asserteq(0, malloc_slab_usable_size(ptr));
+	free(ptr);
+
+	start = ut_check_free();
+	ut_assertok(malloc_slab_get_stats(2, &before));
+	ut_asserteq(64, before.size);
+	for (i = 0; i < ARRAY_SIZE(ptrs); i++) {
+		ptrs[i] = malloc(48);
+		ut_assertnonnull(ptrs[i]);
+	}
+	ut_assertok(malloc_slab_get_stats(2, &after));
+	ut_asserteq(before.allocs + ARRAY_SIZE(ptrs), after.allocs);
+	ut_asserteq(before.inuse + ARRAY_SIZE(ptrs), after.inuse);
+	ut_assert(after.objs >= after.inuse);
+	ut_assert(after.max_pages >= after.pages);
+	for (i = 0; i < ARRAY_SIZE(ptrs); i++)
+		free(ptrs[i]);
+	ut_assertok(malloc_slab_get_stats(2, &after));
+	ut_asserteq(before.frees + ARRAY_SIZE(ptrs), after.frees);
+	ut_asserteq(before.inuse, after.inuse);
+
+	/* pages kept for later use do not count as allocated memory */
+	ut_assertok(ut_check_delta(start));
+	ut_asserteq(-ENOENT, malloc_slab_get_stats(MALLOC_SLAB_CLASSES,
+						   &after));
+
+	/* the slab must not get in the way of test mode */
+	malloc_enable_testing(0);
+	ptr = malloc(16);
+	malloc_disable_testing();
+	ut_assertnull(ptr);
+
+	return 0;
+}
+LIB_TEST(lib_test_malloc_slab_ops, 0);
+
+/* Check that freeing a pointer which is not a slab object is rejected */
+static int lib_test_malloc_slab_bad_free(struct unit_test_state *uts)
+{
+	struct malloc_slab_stats before, after;
+	char *ptr, *bad;
+
+	ptr = malloc(48);
+	ut_assertnonnull(ptr);
+	ut_assertok(malloc_slab_get_stats(2, &before));
+
+	bad = ptr + 8;
+	ut_assert(malloc_slab_free(bad));
+	ut_assert_nextline("free(): invalid slab pointer %p", bad);
+	bad = (char *)ALIGN_DOWN((ulong)ptr, SZ_16K);
+	ut_assert(malloc_slab_free(bad));
+	ut_assert_nextline("free(): invalid slab pointer %p", bad);
+	ut_assert_console_end();
+
+	ut_assertok(malloc_slab_get_stats(2, &after));
+	ut_asserteq(before.frees, after.frees);
+	ut_asserteq(before.inuse, after.inuse);
+
+	/* the object itself is still intact and can be freed */
+	free(ptr);
+	ut_assertok(malloc_slab_get_stats(2, &after));
+	ut_asserteq(before.frees + 1, after.frees);
+
+	return 0;
+}
+LIB_TEST(lib_test_malloc_slab_bad_free, UT_TESTF_CONSOLE_REC);
+
+/* Time @loops rounds of allocating @batch objects and freeing them again */
+static ulong slab_bench(void **ptrs, uint bytes, int batch, int loops)
+{
+	ulong start;
+	int i, j;
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		for (j = 0; j < batch; j++)
+			ptrs[j] = malloc(bytes);
+		for (j = 0; j < batch; j++)
+			free(ptrs[j]);
+	}
+
+	return timer_get_us() - start;
+}
+
+static int lib_test_malloc_slab_bench(struct unit_test_state *uts)
+{
+	static const uint sizes[] = { 16, 32, 64, 128, 256, 512, SZ_1K };
+	ulong one_us, batch_us;
+	void **ptrs;
+	int i;
+
+	ptrs = malloc(SLAB_BENCH_BATCH * sizeof(void *));
+	ut_assertnonnull(ptrs);
+
+	printf("%6s %12s %12s\n", "Size", "Single ns", "Batch ns");
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		one_us = slab_bench(ptrs, sizes[i], 1, SLAB_BENCH_LOOPS);
+		batch_us = slab_bench(ptrs, sizes[i], SLAB_BENCH_BATCH,
+				      SLAB_BENCH_LOOPS / SLAB_BENCH_BATCH);
+		printf("%6u %12lu %12lu\n", sizes[i],
+		       one_us * 1000 / SLAB_BENCH_LOOPS,
+		       batch_us * 1000 / SLAB_BENCH_LOOPS);
+	}
+	free(ptrs);
+
+	return 0;
+}
+LIB_TEST(lib_test_malloc_slab_bench, 0);
@@ -9,10 +9,14 @@
 #include <common.h>
 #include <command.h>
 #include <image.h>
+#include <time.h>
 #include <test/lib.h>
 #include <test/test.h>
 #include <test/ut.h>
 #include <u-boot/rsa.h>
+#include <u-boot/rsa-mod-exp.h>
+
+#define RSA_BENCH_MIN_US	100000
 
 #ifdef CONFIG_RSA_VERIFY_WITH_PKEY
 /*
@@ -203,4 +207,103 @@ static int lib_rsa_verify_invalid(struct unit_test_state *uts)
 }
 
 LIB_TEST(lib_rsa_verify_invalid, 0);
+/**
+ * rsa_mod_exp_with() - run rsa_mod_exp_sw() with the given public exponent
+ *
+ * @prop:	Key properties
+ * @exponent:	Public exponent to use instead of the key's one
+ * @in:		Input value, data_enc_len bytes
+ * @out:	Output value, data_enc_len bytes
+ * Return:	0 if OK, -ve on error
+ */
+static int rsa_mod_exp_with(struct key_prop *prop, uint64_t exponent,
+			    const uint8_t *in, uint8_t *out)
+{
+	const void *saved = prop->public_exponent;
+	fdt64_t exp = cpu_to_fdt64(exponent);
+	int ret;
+
+	prop->public_exponent = &exp;
+	ret = rsa_mod_exp_sw(in, data_enc_len, prop, out);
+	prop->public_exponent = saved;
+
+	return ret;
+}
+
+/**
+ * lib_rsa_mod_exp_window() - unit test for rsa_mod_exp_sw()
+ *
+ * Check that square-and-multiply and sliding-window exponentiation agree,
+ * using (x^a)^b == x^(a * b)
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_rsa_mod_exp_window(struct unit_test_state *uts)
+{
+	const uint64_t exp_a = 65537, exp_b = 0xfedcba987ULL;
+	uint8_t buf_a[256], buf_ab[256], buf[256];
+	struct key_prop *prop;
+
+	ut_assertok(rsa_gen_key_prop(public_key, public_key_len, &prop));
+
+	ut_assertok(rsa_mod_exp_with(prop, exp_a, data_enc, buf_a));
+	ut_assertok(rsa_mod_exp_with(prop, exp_b, buf_a, buf_ab));
+	ut_assertok(rsa_mod_exp_with(prop, exp_a * exp_b, data_enc, buf));
+	ut_asserteq_mem(buf_ab, buf, sizeof(buf));
+
+	/* Even and too-short exponents are rejected */
+	ut_asserteq(-EINVAL, rsa_mod_exp_with(prop, exp_b + 1, data_enc, buf));
+	ut_asserteq(-EINVAL, rsa_mod_exp_with(prop, 1, data_enc, buf));
+
+	rsa_free_key_prop(prop);
+
+	return 0;
+}
+
+LIB_TEST(lib_rsa_mod_exp_window, 0);
+
+/**
+ * lib_rsa_verify_bench() - benchmark for rsa_verify()
+ *
+ * This reports verifications per second for the 2048-bit key above, so that
+ * regressions in lib/rsa show up in the test log
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_rsa_verify_bench(struct unit_test_state *uts)
+{
+	struct image_sign_info info;
+	struct image_region reg;
+	ulong start, elapsed;
+	uint count;
+
+	memset(&info, '\0', sizeof(info));
+	info.name = "sha256,rsa2048";
+	info.padding = image_get_padding_algo("pkcs-1.5");
+	info.checksum = image_get_checksum_algo("sha256,rsa2048");
+	info.crypto = image_get_crypto_algo(info.name);
+
+	info.key = public_key;
+	info.keylen = public_key_len;
+
+	reg.data = data_raw;
+	reg.size = data_raw_len;
+	start = timer_get_us();
+	count = 0;
+	do {
+		ut_assertok(rsa_verify(&info, &reg, 1, data_enc,
+				       data_enc_len));
+		count++;
+		elapsed = timer_get_us() - start;
+	} while (elapsed < RSA_BENCH_MIN_US);
+
+	printf("rsa2048 verify: %u in %lu us, %lu.%03lu ms each\n", count,
+	       elapsed, elapsed / count / 1000, elapsed / count % 1000);
+
+	return 0;
+}
+
+LIB_TEST(lib_rsa_verify_bench, 0);
 #endif /* RSA_VERIFY_WITH_PKEY */
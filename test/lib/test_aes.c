@@ -31,6 +31,7 @@ static struct test_aes_s test_aes[] = {
 	{ AES192_KEY_LENGTH, AES192_EXPAND_KEY_LENGTH, TEST_AES_CBC_CHAIN, 16 },
 	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_ONE_BLOCK,  1 },
 	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_CBC_CHAIN, 16 },
+	{ AES256_KEY_LENGTH, AES256_EXPAND_KEY_LENGTH, TEST_AES_CBC_CHAIN,  7 },
 };
 
 static void rand_buf(u8 *buf, int size)
@@ -166,3 +167,185 @@ static int lib_test_aes(struct unit_test_state *uts)
 }
 
 LIB_TEST(lib_test_aes, 0);
+
+/* NIST SP 800-38A, F.2.2 and F.5.1: key, IV/counter and plaintext */
+static const u8 sp800_key[AES128_KEY_LENGTH] = {
+	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+	0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+static const u8 sp800_plain[4 * AES_BLOCK_LENGTH] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+
+static const u8 sp800_cbc_iv[AES_BLOCK_LENGTH] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+static const u8 sp800_cbc_cipher[4 * AES_BLOCK_LENGTH] = {
+	0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46,
+	0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+	0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee,
+	0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+	0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b,
+	0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+	0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09,
+	0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7,
+};
+
+static const u8 sp800_ctr_iv[AES_BLOCK_LENGTH] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+	0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+static const u8 sp800_ctr_cipher[4 * AES_BLOCK_LENGTH] = {
+	0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+	0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+	0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+	0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+	0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e,
+	0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+	0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1,
+	0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+};
+
+/* Check CBC against known answers, including in-place decryption */
+static int lib_test_aes_cbc_vectors(struct unit_test_state *uts)
+{
+	u8 key_exp[AES128_EXPAND_KEY_LENGTH];
+	u8 buf[sizeof(sp800_plain)];
+	u8 iv[AES_BLOCK_LENGTH];
+
+	aes_expand_key((u8 *)sp800_key, AES128_KEY_LENGTH, key_exp);
+	memcpy(iv, sp800_cbc_iv, sizeof(iv));
+
+	aes_cbc_encrypt_blocks(AES128_KEY_LENGTH, key_exp, iv,
+			       (u8 *)sp800_plain, buf, 4);
+	ut_asserteq_mem(sp800_cbc_cipher, buf, sizeof(buf));
+
+	aes_cbc_decrypt_blocks(AES128_KEY_LENGTH, key_exp, iv, buf, buf, 4);
+	ut_asserteq_mem(sp800_plain, buf, sizeof(buf));
+
+	/* the IV is left alone */
+	ut_asserteq_mem(sp800_cbc_iv, iv, sizeof(iv));
+
+	return 0;
+}
+LIB_TEST(lib_test_aes_cbc_vectors, 0);
+
+/* Check CTR against known answers, with partial blocks and counter carry */
+static int lib_test_aes_ctr(struct unit_test_state *uts)
+{
+	u8 key_exp[AES128_EXPAND_KEY_LENGTH];
+	u8 buf[sizeof(sp800_plain)];
+	u8 ctr[AES_BLOCK_LENGTH];
+	u8 expect[AES_BLOCK_LENGTH];
+
+	aes_expand_key((u8 *)sp800_key, AES128_KEY_LENGTH, key_exp);
+
+	memcpy(ctr, sp800_ctr_iv, sizeof(ctr));
+	aes_ctr_crypt(AES128_KEY_LENGTH, key_exp, ctr, (u8 *)sp800_plain, buf,
+		      sizeof(buf));
+	ut_asserteq_mem(sp800_ctr_cipher, buf, sizeof(buf));
+
+	/* the counter is ready for the next block, with the carry */
+	memcpy(expect, sp800_ctr_iv, sizeof(expect));
+	expect[14] = 0xff;
+	expect[15] = 0x03;
+	ut_asserteq_mem(expect, ctr, sizeof(ctr));
+
+	/* decrypt in place, in pieces, ending with a partial block */
+	memcpy(ctr, sp800_ctr_iv, sizeof(ctr));
+	aes_ctr_crypt(AES128_KEY_LENGTH, key_exp, ctr, buf, buf,
+		      AES_BLOCK_LENGTH);
+	aes_ctr_crypt(AES128_KEY_LENGTH, key_exp, ctr, buf + AES_BLOCK_LENGTH,
+		      buf + AES_BLOCK_LENGTH, 2 * AES_BLOCK_LENGTH);
+	aes_ctr_crypt(AES128_KEY_LENGTH, key_exp, ctr,
+		      buf + 3 * AES_BLOCK_LENGTH, buf + 3 * AES_BLOCK_LENGTH,
+		      AES_BLOCK_LENGTH - 5);
+	ut_asserteq_mem(sp800_plain, buf, sizeof(buf) - 5);
+	ut_asserteq_mem(sp800_ctr_cipher + sizeof(buf) - 5,
+			buf + sizeof(buf) - 5, 5);
+
+	return 0;
+}
+LIB_TEST(lib_test_aes_ctr, 0);
+
+/* NIST SP 800-38A, F.5.3 and F.5.5: the other key sizes, same counter */
+static const u8 sp800_ctr192_key[AES192_KEY_LENGTH] = {
+	0x8e, 0x73, 0xb0, 0xf7, 0xda, 0x0e, 0x64, 0x52,
+	0xc8, 0x10, 0xf3, 0x2b, 0x80, 0x90, 0x79, 0xe5,
+	0x62, 0xf8, 0xea, 0xd2, 0x52, 0x2c, 0x6b, 0x7b,
+};
+
+static const u8 sp800_ctr192_cipher[4 * AES_BLOCK_LENGTH] = {
+	0x1a, 0xbc, 0x93, 0x24, 0x17, 0x52, 0x1c, 0xa2,
+	0x4f, 0x2b, 0x04, 0x59, 0xfe, 0x7e, 0x6e, 0x0b,
+	0x09, 0x03, 0x39, 0xec, 0x0a, 0xa6, 0xfa, 0xef,
+	0xd5, 0xcc, 0xc2, 0xc6, 0xf4, 0xce, 0x8e, 0x94,
+	0x1e, 0x36, 0xb2, 0x6b, 0xd1, 0xeb, 0xc6, 0x70,
+	0xd1, 0xbd, 0x1d, 0x66, 0x56, 0x20, 0xab, 0xf7,
+	0x4f, 0x78, 0xa7, 0xf6, 0xd2, 0x98, 0x09, 0x58,
+	0x5a, 0x97, 0xda, 0xec, 0x58, 0xc6, 0xb0, 0x50,
+};
+
+static const u8 sp800_ctr256_key[AES256_KEY_LENGTH] = {
+	0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+	0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+	0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+	0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,
+};
+
+static const u8 sp800_ctr256_cipher[4 * AES_BLOCK_LENGTH] = {
+	0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5,
+	0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+	0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a,
+	0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+	0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c,
+	0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+	0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6,
+	0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6,
+};
+
+static int lib_test_aes_ctr_key(struct unit_test_state *uts, int key_len,
+				const u8 *key, const u8 *cipher)
+{
+	u8 key_exp[AES256_EXPAND_KEY_LENGTH];
+	u8 buf[sizeof(sp800_plain)];
+	u8 ctr[AES_BLOCK_LENGTH];
+
+	aes_expand_key((u8 *)key, key_len, key_exp);
+
+	memcpy(ctr, sp800_ctr_iv, sizeof(ctr));
+	aes_ctr_crypt(key_len, key_exp, ctr, (u8 *)sp800_plain, buf,
+		      sizeof(buf));
+	ut_asserteq_mem(cipher, buf, sizeof(buf));
+
+	memcpy(ctr, sp800_ctr_iv, sizeof(ctr));
+	aes_ctr_crypt(key_len, key_exp, ctr, buf, buf, sizeof(buf));
+	ut_asserteq_mem(sp800_plain, buf, sizeof(buf));
+
+	return 0;
+}
+
+/* Check CTR with 192- and 256-bit keys against known answers */
+static int lib_test_aes_ctr_keys(struct unit_test_state *uts)
+{
+	ut_assertok(lib_test_aes_ctr_key(uts, AES192_KEY_LENGTH,
+					 sp800_ctr192_key,
+					 sp800_ctr192_cipher));
+	ut_assertok(lib_test_aes_ctr_key(uts, AES256_KEY_LENGTH,
+					 sp800_ctr256_key,
+					 sp800_ctr256_cipher));
+
+	return 0;
+}
+LIB_TEST(lib_test_aes_ctr_keys, 0);
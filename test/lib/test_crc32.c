@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests for crc32 and crc32c
+ *
+ * Depending on the configuration, crc32_no_comp() and crc32c_cal() use
+ * slice-by-8 tables or CPU instructions. Check that whichever is built
+ * agrees with a plain bitwise implementation for all lengths and buffer
+ * alignments that hit the head, body and tail loops.
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <rand.h>
+#include <test/lib.h>
+#include <test/ut.h>
+#include <u-boot/crc.h>
+
+#define TEST_CRC_MAX_LEN	300
+#define TEST_CRC_MAX_ALIGN	8
+
+static u32 crc_bitwise(u32 crc, const u8 *buf, uint len, u32 poly)
+{
+	int i;
+
+	while (len--) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (crc & 1 ? poly : 0);
+	}
+
+	return crc;
+}
+
+static void crc_fill(u8 *buf, int size)
+{
+	int i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = rand() & 0xff;
+}
+
+static int lib_test_crc32(struct unit_test_state *uts)
+{
+	u8 buf[TEST_CRC_MAX_LEN + TEST_CRC_MAX_ALIGN];
+	uint align, len;
+
+	/* standard check value */
+	ut_asserteq(0xcbf43926, crc32(0, (const u8 *)"123456789", 9));
+
+	crc_fill(buf, sizeof(buf));
+	for (align = 0; align < TEST_CRC_MAX_ALIGN; align++) {
+		for (len = 0; len <= TEST_CRC_MAX_LEN; len++) {
+			ut_asserteq(crc_bitwise(0x12345678, buf + align, len,
+						0xedb88320),
+				    crc32_no_comp(0x12345678, buf + align,
+						  len));
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32, 0);
+
+static int lib_test_crc32c(struct unit_test_state *uts)
+{
+	u8 buf[TEST_CRC_MAX_LEN + TEST_CRC_MAX_ALIGN];
+	uint32_t *table;
+	uint align, len;
+
+	if (!IS_ENABLED(CONFIG_CRC32C))
+		return -EAGAIN;
+
+	table = malloc(CRC32C_TABLE_SIZE * sizeof(*table));
+	ut_assertnonnull(table);
+
+	/* Castagnoli, which may use CPU instructions */
+	crc32c_init(table, 0x82f63b78);
+	ut_asserteq(0xe3069283,
+		    ~crc32c_cal(~0, "123456789", 9, table));
+	crc_fill(buf, sizeof(buf));
+	for (align = 0; align < TEST_CRC_MAX_ALIGN; align++) {
+		for (len = 0; len <= TEST_CRC_MAX_LEN; len++) {
+			ut_asserteq(crc_bitwise(0x12345678, buf + align, len,
+						0x82f63b78),
+				    crc32c_cal(0x12345678,
+					       (char *)buf + align, len,
+					       table));
+		}
+	}
+
+	/* any other polynomial must still use the tables */
+	crc32c_init(table, 0xedb88320);
+	for (len = 0; len <= TEST_CRC_MAX_LEN; len++) {
+		ut_asserteq(crc_bitwise(0x12345678, buf + 1, len, 0xedb88320),
+			    crc32c_cal(0x12345678, (char *)buf + 1, len,
+				       table));
+	}
+	free(table);
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32c, 0);
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit tests for SHA-384/SHA-512
+ *
+ * Besides the FIPS 180-2 vectors, check that sha512_process(), which may be
+ * an accelerated architecture version, agrees with the generic code.
+ */
+
+#include <common.h>
+#include <rand.h>
+#include <test/lib.h>
+#include <test/ut.h>
+#include <u-boot/sha512.h>
+
+/* one-block and two-block messages from FIPS 180-2 */
+static const char msg1[] = "abc";
+static const char msg2[] = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklm"
+			   "ghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrs"
+			   "mnopqrstnopqrstu";
+
+static const u8 sha512_msg1[] = {
+	0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba,
+	0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+	0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+	0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+	0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
+	0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+	0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
+	0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f,
+};
+
+static const u8 sha512_msg2[] = {
+	0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda,
+	0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f,
+	0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1,
+	0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18,
+	0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4,
+	0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
+	0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54,
+	0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09,
+};
+
+static const u8 sha384_msg1[] = {
+	0xcb, 0x00, 0x75, 0x3f, 0x45, 0xa3, 0x5e, 0x8b,
+	0xb5, 0xa0, 0x3d, 0x69, 0x9a, 0xc6, 0x50, 0x07,
+	0x27, 0x2c, 0x32, 0xab, 0x0e, 0xde, 0xd1, 0x63,
+	0x1a, 0x8b, 0x60, 0x5a, 0x43, 0xff, 0x5b, 0xed,
+	0x80, 0x86, 0x07, 0x2b, 0xa1, 0xe7, 0xcc, 0x23,
+	0x58, 0xba, 0xec, 0xa1, 0x34, 0xc8, 0x25, 0xa7,
+};
+
+static const u8 sha384_msg2[] = {
+	0x09, 0x33, 0x0c, 0x33, 0xf7, 0x11, 0x47, 0xe8,
+	0x3d, 0x19, 0x2f, 0xc7, 0x82, 0xcd, 0x1b, 0x47,
+	0x53, 0x11, 0x1b, 0x17, 0x3b, 0x3b, 0x05, 0xd2,
+	0x2f, 0xa0, 0x80, 0x86, 0xe3, 0xb0, 0xf7, 0x12,
+	0xfc, 0xc7, 0xc7, 0x1a, 0x55, 0x7e, 0x2d, 0xb9,
+	0x66, 0xc3, 0xe9, 0xfa, 0x91, 0x74, 0x60, 0x39,
+};
+
+static int lib_test_sha512_vectors(struct unit_test_state *uts)
+{
+	u8 out[SHA512_SUM_LEN];
+
+	sha512_csum_wd((const u8 *)msg1, strlen(msg1), out, CHUNKSZ_SHA512);
+	ut_asserteq_mem(sha512_msg1, out, SHA512_SUM_LEN);
+	sha512_csum_wd((const u8 *)msg2, strlen(msg2), out, CHUNKSZ_SHA512);
+	ut_asserteq_mem(sha512_msg2, out, SHA512_SUM_LEN);
+
+	if (IS_ENABLED(CONFIG_SHA384)) {
+		sha384_csum_wd((const u8 *)msg1, strlen(msg1), out,
+			       CHUNKSZ_SHA384);
+		ut_asserteq_mem(sha384_msg1, out, SHA384_SUM_LEN);
+		sha384_csum_wd((const u8 *)msg2, strlen(msg2), out,
+			       CHUNKSZ_SHA384);
+		ut_asserteq_mem(sha384_msg2, out, SHA384_SUM_LEN);
+	}
+
+	return 0;
+}
+LIB_TEST(lib_test_sha512_vectors, 0);
+
+#define TEST_SHA512_BLOCKS	64
+
+static int lib_test_sha512_process(struct unit_test_state *uts)
+{
+	sha512_context ctx, ref;
+	unsigned int blocks;
+	u8 *buf;
+	int i;
+
+	buf = malloc(TEST_SHA512_BLOCKS * SHA512_BLOCK_SIZE);
+	ut_assertnonnull(buf);
+	for (i = 0; i < TEST_SHA512_BLOCKS * SHA512_BLOCK_SIZE; i++)
+		buf[i] = rand() & 0xff;
+
+	/* cover single blocks, short runs and one long run */
+	for (blocks = 1; blocks <= TEST_SHA512_BLOCKS; blocks *= 2) {
+		sha512_starts(&ctx);
+		sha512_starts(&ref);
+		sha512_process(&ctx, buf, blocks);
+		sha512_process_generic(&ref, buf, blocks);
+		ut_asserteq_mem(ref.state, ctx.state, sizeof(ctx.state));
+	}
+
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_sha512_process, 0);
@@ -30,6 +30,20 @@ def test_bootstage_report(u_boot_console):
     assert 'Accumulated time:' in output
     assert 'dm_r' in output
 
+@pytest.mark.buildconfigspec('bootstage')
+@pytest.mark.buildconfigspec('cmd_bootstage')
+@pytest.mark.buildconfigspec('bootstage_initcalls')
+def test_bootstage_report_initcalls(u_boot_console):
+    output = u_boot_console.run_command('bootstage report --initcalls')
+    assert 'Initcall timings in microseconds' in output
+    lines = output.split('\n\n')[0].splitlines()
+    times = [int(line[:11].replace(',', '')) for line in lines[2:]
+             if line[:11].replace(',', '').strip().isdigit()]
+    assert times
+    assert times == sorted(times, reverse=True)
+    assert 'board_init_f' in output
+    assert 'board_init_r' in output
+
 @pytest.mark.buildconfigspec('bootstage')
 @pytest.mark.buildconfigspec('cmd_bootstage')
 @pytest.mark.buildconfigspec('bootstage_stash')
@@ -79,3 +79,17 @@ def test_dm_uclass(u_boot_console):
 @pytest.mark.buildconfigspec("cmd_dm")
 def test_dm_devres(u_boot_console):
     response = u_boot_console.run_command("dm devres")
+
+@pytest.mark.buildconfigspec('cmd_dm')
+@pytest.mark.buildconfigspec('dm_probe_times')
+def test_dm_probe_times(u_boot_console):
+    """Test that each probed device in `dm tree` is in `dm probe-times`."""
+    response = u_boot_console.run_command('dm tree')
+    probed = [line.split()[-1] for line in response[:-1].split('\n')[2:]
+              if '[ + ]' in line]
+    response = u_boot_console.run_command('dm probe-times')
+    lines = response.split('\n')
+    names = [line.split()[-1] for line in lines[2:-2]]
+    for name in probed:
+        assert name in names
+    assert lines[-1].split()[-2] == str(len(names))
@@ -0,0 +1,96 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""
+Test encryption of FIT images with AES-CTR
+
+This checks that mkimage gives each encrypted image a new random IV (the
+initial counter block), since reusing one with the same key exposes the data.
+This test doesn't run the sandbox. It only checks the host tool 'mkimage'
+"""
+
+import os
+import pytest
+import u_boot_utils as util
+
+CTR_ITS = '''
+/dts-v1/;
+
+/ {
+	description = "Two images encrypted with one key";
+	#address-cells = <1>;
+
+	images {
+		image-1 {
+			data = /incbin/("%(data)s");
+			type = "firmware";
+			arch = "sandbox";
+			compression = "none";
+			cipher {
+				algo = "aes256-ctr";
+				key-name-hint = "aeskey";%(iv)s
+			};
+		};
+		image-2 {
+			data = /incbin/("%(data)s");
+			type = "firmware";
+			arch = "sandbox";
+			compression = "none";
+			cipher {
+				algo = "aes256-ctr";
+				key-name-hint = "aeskey";
+			};
+		};
+	};
+	configurations {
+		default = "conf-1";
+		conf-1 {
+			firmware = "image-1";
+			loadables = "image-2";
+		};
+	};
+};
+'''
+
+@pytest.mark.buildconfigspec('fit_cipher')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.requiredtool('fdtget')
+def test_fit_cipher_ctr_iv(u_boot_console):
+    """Test that AES-CTR images each get their own IV"""
+    def make_fit(iv=''):
+        its = os.path.join(tempdir, 'test.its')
+        with open(its, 'w', encoding='utf-8') as outf:
+            outf.write(CTR_ITS % {'data': data, 'iv': iv})
+        return [mkimage, '-k', tempdir, '-f', its, fit]
+
+    def get_iv(image):
+        return util.run_and_log(cons, f'fdtget -tbx {fit} /images/{image}/cipher iv')
+
+    cons = u_boot_console
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    tempdir = os.path.join(cons.config.result_dir, 'cipher')
+    os.makedirs(tempdir, exist_ok=True)
+    fit = os.path.join(tempdir, 'test.fit')
+    data = os.path.join(tempdir, 'data.bin')
+
+    with open(os.path.join(tempdir, 'aeskey.bin'), 'wb') as outf:
+        outf.write(os.urandom(32))
+    with open(os.path.join(tempdir, 'aesiv.bin'), 'wb') as outf:
+        outf.write(os.urandom(16))
+    with open(data, 'wb') as outf:
+        outf.write(os.urandom(1000))
+
+    util.run_and_log(cons, make_fit())
+    iv1 = get_iv('image-1')
+    iv2 = get_iv('image-2')
+    assert len(iv1.split()) == 16
+    assert len(iv2.split()) == 16
+    assert iv1 != iv2
+
+    # A new FIT gets new IVs too
+    util.run_and_log(cons, make_fit())
+    assert get_iv('image-1') not in (iv1, iv2)
+
+    # A fixed IV from a file is not allowed
+    util.run_and_log_expect_exception(
+        cons, make_fit('\n\t\t\t\tiv-name-hint = "aesiv";'), 1,
+        'iv-name-hint is not allowed')
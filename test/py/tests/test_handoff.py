@@ -13,3 +13,18 @@ def test_handoff(u_boot_console):
     cons = u_boot_console
     response = cons.run_command('sb handoff')
     assert ('SPL handoff magic %x' % TEST_HANDOFF_MAGIC) in response
+
+@pytest.mark.boardspec('sandbox_spl')
+@pytest.mark.buildconfigspec('spl_fit_verify_cache')
+@pytest.mark.buildconfigspec('spl_unit_test')
+def test_handoff_fit_cache(u_boot_console):
+    """Test that FIT verification results from SPL reach U-Boot proper"""
+    cons = u_boot_console
+    try:
+        # Record a result in SPL, then check for it in U-Boot proper
+        cons.restart_uboot_with_flags(['-u', '-k', 'fit_cache'])
+        response = cons.run_command(
+            'ut bootstd -f test_image_fit_cache_spl_norun')
+        assert 'Failures: 0' in response
+    finally:
+        cons.restart_uboot()
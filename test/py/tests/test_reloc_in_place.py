@@ -0,0 +1,42 @@
+# SPDX-License-Identifier: GPL-2.0+
+
+"""
+Test that U-Boot stays where it was loaded with CONFIG_RELOC_IN_PLACE
+
+This needs the board to load U-Boot into DRAM, just below the areas reserved
+at the top of RAM. For example QEMU's arm64 'virt' machine with 1GB of RAM can
+be started with:
+
+    -device loader,file=u-boot.bin,addr=0x7f000000,cpu-num=0
+
+and the board environment then gives the load address:
+
+env__reloc_in_place = {
+    'addr': 0x7f000000,
+}
+
+Without this the test is skipped.
+"""
+
+import re
+import pytest
+
+@pytest.mark.buildconfigspec('reloc_in_place')
+@pytest.mark.buildconfigspec('cmd_bdinfo')
+def test_reloc_in_place(u_boot_console):
+    """Test that U-Boot was not copied to the top of RAM"""
+    cons = u_boot_console
+    f = cons.config.env.get('env__reloc_in_place', None)
+    if not f:
+        pytest.skip('No load address for U-Boot in DRAM is defined')
+
+    output = cons.run_command('bdinfo')
+    relocaddr = re.search(r'relocaddr\s*= (0x[0-9a-f]+)', output)
+    reloc_off = re.search(r'reloc off\s*= (0x[0-9a-f]+)', output)
+    assert relocaddr and reloc_off, output
+    assert int(relocaddr.group(1), 16) == f['addr']
+    assert int(reloc_off.group(1), 16) == 0
+
+    if cons.config.buildconfig.get('config_cmd_bootstage', 'n') == 'y':
+        output = cons.run_command('bootstage report')
+        assert 'relocate' in output
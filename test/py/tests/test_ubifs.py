@@ -0,0 +1,108 @@
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Test reading files from UBIFS on the sandbox NAND, with and without
+# bulk-read
+
+import os
+import re
+import zlib
+import pytest
+import u_boot_utils
+
+# Geometry of the nand2 chip in test.dts
+PAGE_SIZE = 2048
+PEB_SIZE = 128 * 1024
+LEB_SIZE = PEB_SIZE - 2 * PAGE_SIZE
+MAX_LEB_CNT = 256
+
+IMG_ADDR = 0x2000000
+LOAD_ADDR = 0x4000000
+
+# Files in the image: a random one, which is stored uncompressed, and a
+# compressible one
+FILES = {
+    'random': os.urandom(8 << 20),
+    'text': b''.join(b'line %d of a compressible file\n' % i
+                     for i in range(200000)),
+}
+
+def make_image(cons):
+    """Create a UBIFS image holding FILES
+
+    Returns:
+        str: Path to the image
+    """
+    src = os.path.join(cons.config.persistent_data_dir, 'ubifs_src')
+    img = os.path.join(cons.config.persistent_data_dir, 'ubifs.img')
+    os.makedirs(src, exist_ok=True)
+    for name, data in FILES.items():
+        with open(os.path.join(src, name), 'wb') as outf:
+            outf.write(data)
+    u_boot_utils.run_and_log(
+        cons, f'mkfs.ubifs -m {PAGE_SIZE} -e {LEB_SIZE} -c {MAX_LEB_CNT} '
+        f'-r {src} -o {img}')
+    return img
+
+def load_file(cons, name, size=None, offset=None):
+    """Load (part of) a file from UBIFS and check its contents
+
+    Returns:
+        float: Time taken by the load, in seconds
+    """
+    if offset is None:
+        cmd = f'ubifsload {LOAD_ADDR:x} {name}'
+        if size:
+            cmd += f' {size:x}'
+    else:
+        cmd = f'load ubi 0 {LOAD_ADDR:x} {name} {size:x} {offset:x}'
+    output = cons.run_command(f'time {cmd}')
+    secs = re.search(r'time: ([0-9.]+) seconds', output)
+    assert secs, output
+
+    data = FILES[name][offset or 0:]
+    if size:
+        data = data[:size]
+    output = cons.run_command(f'crc32 {LOAD_ADDR:x} {len(data):x}')
+    assert output.split()[-1] == f'{zlib.crc32(data):08x}'
+    return float(secs.group(1))
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_ubifs')
+@pytest.mark.buildconfigspec('cmd_mtd')
+@pytest.mark.buildconfigspec('nand_sandbox')
+@pytest.mark.requiredtool('mkfs.ubifs')
+def test_ubifs_bulk_read(u_boot_console):
+    """Test that bulk-read gives the same data as reading each node
+
+    This also reports how long each method takes to load the files.
+    """
+    cons = u_boot_console
+    img = make_image(cons)
+
+    cons.run_command('setenv mtdids nand2=nand2')
+    cons.run_command('setenv mtdparts mtdparts=nand2:32m(ubi)')
+    output = cons.run_command('mtd erase ubi')
+    assert 'Erasing' in output
+    output = cons.run_command('ubi part ubi')
+    assert 'Error' not in output
+    cons.run_command('ubi create vol')
+    cons.run_command(f'host load hostfs - {IMG_ADDR:x} {img}')
+    output = cons.run_command(f'ubi write {IMG_ADDR:x} vol ${{filesize}}')
+    assert 'written to volume' in output
+
+    times = {}
+    for opts in ('no_bulk_read', 'bulk_read'):
+        output = cons.run_command(f'ubifsmount ubi0:vol {opts}')
+        assert 'Error' not in output
+        times[opts] = sum(load_file(cons, name) for name in FILES)
+
+        # parts of files, ending within a block
+        load_file(cons, 'random', 0x12345)
+        load_file(cons, 'random', 0x54321, 0x7000)
+        load_file(cons, 'text', 0x20001, 0x1000)
+        cons.run_command('ubifsumount')
+
+    output = cons.run_command('ubifsmount ubi0:vol bad_option')
+    assert 'unrecognized mount option' in output
+    cons.log.info(f"Load time: {times['no_bulk_read']:.3f}s without "
+                  f"bulk-read, {times['bulk_read']:.3f}s with it")
@@ -641,3 +641,74 @@ def test_fdt_add_pubkey(u_boot_console, name, sha_algo, padding, sign_options, a
     # keys created in test_vboot test
 
     test_add_pubkey(sha_algo, padding, sign_options)
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('fit_signature')
+@pytest.mark.buildconfigspec('fit_verify_cache')
+@pytest.mark.requiredtool('dtc')
+@pytest.mark.requiredtool('openssl')
+def test_vboot_cache(u_boot_console):
+    """Test that a configuration signature is only checked once
+
+    The result is reused only while the key and the signed parts of the FIT
+    are unchanged.
+    """
+    def run_bootm(test_type, expect_string, boots, cmds=()):
+        """Run 'bootm' on the FIT, after any commands given
+
+        Args:
+            test_type: A string identifying the test type.
+            expect_string: A string which is expected in the output.
+            boots: A boolean that is True if Linux should boot
+            cmds: Commands to run before 'bootm'
+        """
+        with cons.log.section('Verified boot cache %s' % test_type):
+            output = ''.join(cons.run_command_list(list(cmds) +
+                                                   ['bootm 100']))
+        assert expect_string in output
+        assert ('sandbox: continuing, as we cannot run' in output) == boots
+
+    cons = u_boot_console
+    tmpdir = os.path.join(cons.config.result_dir, 'vboot-cache') + '/'
+    if not os.path.exists(tmpdir):
+        os.mkdir(tmpdir)
+    datadir = cons.config.source_dir + '/test/py/tests/vboot/'
+    fit = '%stest.fit' % tmpdir
+    mkimage = cons.config.build_dir + '/tools/mkimage'
+    dtc_args = '-I dts -O dtb -i %s' % tmpdir
+    dtb = '%ssandbox-u-boot.dtb' % tmpdir
+
+    util.run_and_log(cons, 'openssl genpkey -algorithm RSA -out %sdev.key '
+                     '-pkeyopt rsa_keygen_bits:2048 '
+                     '-pkeyopt rsa_keygen_pubexp:65537' % tmpdir)
+    util.run_and_log(cons, 'openssl req -batch -new -x509 -key %sdev.key '
+                     '-out %sdev.crt' % (tmpdir, tmpdir))
+    with open('%stest-kernel.bin' % tmpdir, 'wb') as fd:
+        fd.write(500 * b'\0')
+    dtc('sandbox-kernel.dts', cons, dtc_args, datadir, tmpdir, dtb)
+    dtc('sandbox-u-boot.dts', cons, dtc_args, datadir, tmpdir, dtb)
+    make_fit('sign-configs-sha256.its', cons, mkimage, dtc_args, datadir, fit)
+    util.run_and_log(cons, [mkimage, '-F', '-k', tmpdir, '-K', dtb, '-r', fit])
+
+    old_dtb = cons.config.dtb
+    try:
+        cons.config.dtb = dtb
+        cons.restart_uboot()
+        run_bootm('first', 'dev+', True,
+                  ['host load hostfs - 100 %s' % fit, 'fdt addr 100'])
+        run_bootm('repeat', 'dev-cached+', True)
+
+        # A different key must not match, even with the same name
+        key = '/signature/key-dev rsa,exponent'
+        run_bootm('other key', 'dev- ', False,
+                  ['fdt addr ${fdtcontroladdr}', 'fdt set %s <0 3>' % key])
+        run_bootm('same key', 'dev-cached+', True,
+                  ['fdt set %s <0 0x10001>' % key])
+
+        # Nor may a FIT whose signed data has changed
+        run_bootm('changed FIT', 'dev- ', False,
+                  ['fdt addr 100', 'fdt set /images/kernel kernel-version <2>'])
+    finally:
+        # Go back to the original U-Boot with the correct dtb.
+        cons.config.dtb = old_dtb
+        cons.restart_uboot()
@@ -362,7 +362,9 @@ static int test_post_run(struct unit_test_state *uts, struct unit_test *test)
 	ut_assertok(cyclic_unregister_all());
 	ut_assertok(event_uninit());
 
-	free(uts->of_other);
+	/* this also drops the tree's phandle index */
+	if (of_live_active())
+		of_live_free(uts->of_other);
 	uts->of_other = NULL;
 
 	blkcache_free();
@@ -17,6 +17,7 @@
 #if CONFIG_IS_ENABLED(FIT_SIGNATURE)
 #include <openssl/pem.h>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
 #endif
 
 /**
@@ -366,32 +367,22 @@ static int fit_image_read_key_iv_data(const char *keydir, const char *key_iv_nam
 
 static int get_random_data(void *data, int size)
 {
-	unsigned char *tmp = data;
-	struct timespec date;
-	int i, ret;
-
-	if (!tmp) {
+	if (!data) {
 		fprintf(stderr, "%s: pointer data is NULL\n", __func__);
-		ret = -1;
-		goto out;
-	}
-
-	ret = clock_gettime(CLOCK_MONOTONIC, &date);
-	if (ret) {
-		fprintf(stderr, "%s: clock_gettime has failed (%s)\n", __func__,
-			strerror(errno));
-		goto out;
+		return -1;
 	}
 
-	srandom(date.tv_nsec);
-
-	for (i = 0; i < size; i++) {
-		*tmp = random() & 0xff;
-		tmp++;
+#if CONFIG_IS_ENABLED(FIT_SIGNATURE)
+	if (RAND_bytes(data, size) != 1) {
+		fprintf(stderr, "%s: RAND_bytes has failed\n", __func__);
+		return -1;
 	}
 
- out:
-	return ret;
+	return 0;
+#else
+	fprintf(stderr, "%s: no random source without OpenSSL\n", __func__);
+	return -1;
+#endif
 }
 
 static int fit_image_setup_cipher(struct image_cipher_info *info,
@@ -436,6 +427,14 @@ static int fit_image_setup_cipher(struct image_cipher_info *info,
 		goto out;
 	}
 
+	/* A fixed IV would be reused by every image encrypted with the key */
+	if (info->cipher->unique_iv && info->ivname) {
+		fprintf(stderr,
+			"Cipher '%s' in image '%s' needs a new IV for each image, so iv-name-hint is not allowed\n",
+			algo_name, image_name);
+		goto out;
+	}
+
 	info->key = malloc(info->cipher->key_len);
 	if (!info->key) {
 		fprintf(stderr, "Can't allocate memory for key\n");
@@ -529,6 +528,21 @@ fit_image_process_cipher(const char *keydir, void *keydest, void *fit,
 	if (ret)
 		goto out;
 
+	/* A generated IV is stored with the image, whether or not -K is used */
+	if (!info.ivname) {
+		ret = fdt_setprop(fit, node_noffset, "iv", info.iv,
+				  info.cipher->iv_len);
+		if (ret == -FDT_ERR_NOSPACE) {
+			ret = -ENOSPC;
+			goto out;
+		}
+		if (ret) {
+			fprintf(stderr, "Can't add IV to image '%s' (err = %d)\n",
+				image_name, ret);
+			goto out;
+		}
+	}
+
 	/*
 	 * Write the public key into the supplied FDT file; this might fail
 	 * several times, since we try signing with successively increasing